@@ -0,0 +1,37 @@
+#pragma once
+
+#include <breeze/http/request.hpp>
+#include <breeze/http/response.hpp>
+#include <breeze/http/router.hpp>
+
+#include <string>
+
+namespace app::Http::Middleware {
+
+// Guards operational endpoints. With a token configured the client must send
+// `Authorization: Bearer <token>`; without one, only loopback clients are let through.
+inline breeze::http::Router::Middleware AdminOnly(std::string token) {
+    return [token = std::move(token)](const breeze::http::Request& req,
+                                      const breeze::http::Router::Handler& next) -> breeze::http::Response {
+        bool allowed = false;
+        if (!token.empty()) {
+            const std::string expected = "Bearer " + token;
+            auto given = req.header("authorization");
+            // Compare every byte so the response time does not reveal the matching prefix
+            unsigned char diff = given.size() == expected.size() ? 0 : 1;
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                diff |= static_cast<unsigned char>(expected[i] ^ (i < given.size() ? given[i] : 0));
+            }
+            allowed = diff == 0;
+        } else {
+            auto remote = req.header("x-remote-addr");
+            allowed = remote == "127.0.0.1" || remote == "::1";
+        }
+        if (!allowed) {
+            return breeze::http::Response(breeze::http::StatusCode::Forbidden, "Forbidden");
+        }
+        return next(req);
+    };
+}
+
+} // namespace app::Http::Middleware
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <breeze/http/middleware.hpp>
+#include <breeze/support/traffic_capture.hpp>
+
+#include <chrono>
+
+namespace app::Http::Middleware {
+
+// Samples requests into the traffic capture log (config/capture.json) so a production load
+// shape can be replayed locally with `breeze_cli replay`. Unsampled requests pay one atomic load.
+inline breeze::http::MiddlewarePipeline::Middleware CaptureTraffic() {
+    return [](const breeze::http::Request& req, breeze::http::MiddlewarePipeline::Next next) -> breeze::http::Response {
+        auto& capture = breeze::support::TrafficCapture::instance();
+        if (!capture.should_sample()) {
+            return next(req);
+        }
+        auto arrived = std::chrono::steady_clock::now();
+        auto res = next(req);
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - arrived);
+        capture.record(req, static_cast<int>(res.status()), duration, arrived);
+        return res;
+    };
+}
+
+} // namespace app::Http::Middleware
@@ -13,14 +13,15 @@ public:
     void register_services() override {
         // Register controller factories and actions with the router so string-style handlers resolve
         auto& router = app_.kernel().router();
-        router.register_controller<HomeController>("HomeController");
+        // Both controllers are stateless, so one shared instance serves every request
+        router.register_controller<HomeController>("HomeController", breeze::http::ControllerLifetime::Singleton);
         router.register_controller_action<HomeController>("HomeController", "index", &HomeController::index);
         router.register_controller_action<HomeController>("HomeController", "about", &HomeController::about);
         router.register_controller_action<HomeController>("HomeController", "contact", &HomeController::contact);
         router.register_controller_action<HomeController>("HomeController", "inlineBreeze", &HomeController::inlineBreeze);
         router.register_controller_action<HomeController>("HomeController", "inlineCpp", &HomeController::inlineCpp);
 
-        router.register_controller<UserController>("UserController");
+        router.register_controller<UserController>("UserController", breeze::http::ControllerLifetime::Singleton);
         router.register_controller_action<UserController>("UserController", "index", &UserController::index);
         router.register_controller_action<UserController>("UserController", "show", &UserController::show);
     }
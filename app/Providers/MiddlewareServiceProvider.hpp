@@ -3,6 +3,10 @@
 
 #include <breeze/core/application.hpp>
 #include <app/Http/Middleware/RequestLogger.hpp>
+#include <app/Http/Middleware/CaptureTraffic.hpp>
+
+#include <algorithm>
+#include <cctype>
 
 namespace app::Providers {
 
@@ -16,11 +20,31 @@ public:
 
         // Define a common 'web' group that includes the request logger
         app_.kernel().register_middleware_group("web", {"request.logger"});
+
+        register_traffic_capture();
     }
 
     void boot() override {
         // no-op for now
     }
+
+private:
+    // Global sampling middleware feeding `breeze_cli replay` (off unless capture.enabled)
+    void register_traffic_capture() {
+        const auto& config = app_.config();
+        breeze::support::TrafficCaptureOptions options;
+        options.enabled = config.get<bool>("capture.enabled", false);
+        if (!options.enabled) return;
+        options.file = config.get("capture.file", options.file.string());
+        options.sample_every = static_cast<unsigned>(config.get<int>("capture.sample_every", 1));
+        options.max_bytes = static_cast<size_t>(config.get<double>("capture.max_bytes", static_cast<double>(options.max_bytes)));
+        options.redact_headers = config.get<std::vector<std::string>>("capture.redact_headers", options.redact_headers);
+        for (auto& name : options.redact_headers) {
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        }
+        breeze::support::TrafficCapture::instance().configure(std::move(options));
+        app_.kernel().middleware().add(app::Http::Middleware::CaptureTraffic());
+    }
 };
 
 } // namespace app::Providers
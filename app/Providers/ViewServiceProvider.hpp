@@ -6,22 +6,26 @@
 
 namespace app::Providers {
 
-class ViewServiceProvider : public breeze::core::ServiceProvider {
+// Deferred: only registered once a view is first rendered, so CLI commands and
+// API-only workers never pay for it
+class ViewServiceProvider : public breeze::core::DeferrableProvider {
 public:
-    using breeze::core::ServiceProvider::ServiceProvider;
+    using breeze::core::DeferrableProvider::DeferrableProvider;
+
+    std::vector<size_t> provides() const override {
+        return provides_types<breeze::support::IViewEngine, breeze::support::View>();
+    }
 
     void register_services() override {
         // Bind the concrete View as the default IViewEngine implementation
         app_.container().singleton<breeze::support::IViewEngine>([this]() {
-            // Get views path from config or default to resources/views
-            std::string views_path = app_.config().get("view.paths", "resources/views");
-            return std::make_shared<breeze::support::View>(views_path);
+            // Same root (view.path) that @extends / @include and view:cache resolve against
+            return std::make_shared<breeze::support::View>(app_.view_options().views_path);
         });
 
         // Also keep the concrete View registered for code that requests it specifically
         app_.container().singleton<breeze::support::View>([this]() {
-            std::string views_path = app_.config().get("view.paths", "resources/views");
-            return std::make_shared<breeze::support::View>(views_path);
+            return std::make_shared<breeze::support::View>(app_.view_options().views_path);
         });
     }
 
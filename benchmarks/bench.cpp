@@ -0,0 +1,486 @@
+// Microbenchmarks for framework hot paths.
+//
+//   breeze_bench                         # table on stdout
+//   breeze_bench --json out.json         # also write machine-readable results
+//   breeze_bench --filter dispatch       # only benchmarks whose name contains "dispatch"
+//   breeze_bench --min-time 500          # milliseconds per repetition (default 200)
+//
+// Compare two result files with scripts/bench_compare.py. Build with
+// -DCMAKE_BUILD_TYPE=Release; numbers from unoptimised builds are meaningless.
+
+#include <breeze/breeze.hpp>
+#include <breeze/http/server.hpp>
+#include <breeze/support/str.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef BREEZE_BENCH_BUILD_TYPE
+#define BREEZE_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Keep the compiler from discarding a result
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0;   // per repetition
+    double min_ns = 0;
+    double median_ns = 0;
+    double max_ns = 0;
+};
+
+struct Options {
+    std::string filter;
+    std::string json_path;
+    std::chrono::milliseconds min_time{200};
+    int repetitions = 5;
+};
+
+class Suite {
+public:
+    explicit Suite(Options options) : options_(std::move(options)) {}
+
+    void add(std::string name, std::function<void()> body) {
+        cases_.push_back({std::move(name), std::move(body)});
+    }
+
+    std::vector<Result> run() {
+        std::vector<Result> results;
+        for (auto& [name, body] : cases_) {
+            if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) continue;
+
+            // Calibrate: grow the batch until one batch takes at least min_time
+            std::uint64_t iterations = 1;
+            for (;;) {
+                auto elapsed = time_batch(body, iterations);
+                if (elapsed >= options_.min_time || iterations >= (1ULL << 30)) break;
+                auto scale = elapsed.count() > 0
+                    ? std::clamp<double>(1.4 * static_cast<double>(options_.min_time.count() * 1000000) /
+                                             static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                                         2.0, 100.0)
+                    : 100.0;
+                iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * scale);
+            }
+
+            std::vector<double> per_op;
+            for (int rep = 0; rep < options_.repetitions; ++rep) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_batch(body, iterations)).count();
+                per_op.push_back(static_cast<double>(ns) / static_cast<double>(iterations));
+            }
+            std::sort(per_op.begin(), per_op.end());
+            Result r{name, iterations, per_op.front(), per_op[per_op.size() / 2], per_op.back()};
+            std::printf("%-40s %12.1f ns/op  (min %.1f, max %.1f, %llu iters)\n", r.name.c_str(), r.median_ns,
+                        r.min_ns, r.max_ns, static_cast<unsigned long long>(r.iterations));
+            std::fflush(stdout);
+            results.push_back(std::move(r));
+        }
+        return results;
+    }
+
+private:
+    static clock_type::duration time_batch(const std::function<void()>& body, std::uint64_t iterations) {
+        auto start = clock_type::now();
+        for (std::uint64_t i = 0; i < iterations; ++i) body();
+        return clock_type::now() - start;
+    }
+
+    Options options_;
+    std::vector<std::pair<std::string, std::function<void()>>> cases_;
+};
+
+void write_json(const std::string& path, const std::vector<Result>& results) {
+    nlohmann::json out;
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    out["context"] = {
+        {"date", date},
+        {"build_type", BREEZE_BENCH_BUILD_TYPE},
+#if defined(__clang__)
+        {"compiler", std::string("clang ") + __clang_version__},
+#elif defined(__GNUC__)
+        {"compiler", std::string("gcc ") + __VERSION__},
+#else
+        {"compiler", "unknown"},
+#endif
+    };
+    out["benchmarks"] = nlohmann::json::array();
+    for (const auto& r : results) {
+        out["benchmarks"].push_back({
+            {"name", r.name},
+            {"iterations", r.iterations},
+            {"ns_per_op", r.median_ns},
+            {"min_ns", r.min_ns},
+            {"max_ns", r.max_ns},
+        });
+    }
+    std::ofstream(path) << out.dump(2) << "\n";
+}
+
+// ---------------------------------------------------------------------------
+// Fixtures
+
+const std::string kGetRequest =
+    "GET /api/users/42/posts?page=2&sort=desc HTTP/1.1\r\n"
+    "Host: localhost:8000\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/124.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Cookie: session=abc123def456; theme=dark\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+const std::string kJsonBody =
+    R"({"name":"Ada Lovelace","email":"ada@example.com","roles":["admin","editor"],)"
+    R"("profile":{"age":36,"city":"London","bio":"First programmer"},"active":true,"score":98.5})";
+
+const std::string kPostRequest =
+    "POST /api/users HTTP/1.1\r\n"
+    "Host: localhost:8000\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: " + std::to_string(kJsonBody.size()) + "\r\n"
+    "\r\n" + kJsonBody;
+
+// Router with n routes: a mix of static and parameterised paths, like a real app
+std::unique_ptr<breeze::http::Router> make_router(int n) {
+    auto router = std::make_unique<breeze::http::Router>();
+    for (int i = 0; i < n; ++i) {
+        auto handler = [](const breeze::http::Request&) { return breeze::http::Response::ok("ok"); };
+        if (i % 2 == 0) router->get("/section" + std::to_string(i) + "/index", handler);
+        else router->get("/resource" + std::to_string(i) + "/{id}", handler);
+    }
+    return router;
+}
+
+nlohmann::json listing_context(int items) {
+    nlohmann::json ctx;
+    ctx["title"] = "Products";
+    ctx["user"] = {{"name", "Ada"}, {"is_admin", true}};
+    ctx["products"] = nlohmann::json::array();
+    for (int i = 0; i < items; ++i) {
+        ctx["products"].push_back({
+            {"id", i},
+            {"name", "Product <" + std::to_string(i) + ">"},
+            {"price", 9.99 + i},
+            {"in_stock", i % 3 != 0},
+            {"category", {{"name", i % 2 ? "Books" : "Games"}}},
+        });
+    }
+    return ctx;
+}
+
+// The escape loop Blade used before str::append_html_escaped, kept as the baseline
+void escape_by_switch(std::string& out, std::string_view s) {
+    for (char c : s) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            case '\'': out += "&#39;"; break;
+            default: out.push_back(c); break;
+        }
+    }
+}
+
+// The listing page written by hand against the same JSON, as the floor for compiled views
+void render_listing_by_hand(const nlohmann::json& ctx, std::string& out) {
+    auto append_number = [&out](double d) {
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), d);
+        out.append(buf, end);
+    };
+    const auto& user = ctx["user"];
+    out += "<!DOCTYPE html>\n<html>\n<head><title>";
+    out += ctx["title"].get_ref<const std::string&>();
+    out += "</title></head>\n<body>\n    <header>\n        ";
+    if (user["is_admin"].get<bool>()) {
+        out += "\n            <a href=\"/admin\">Admin for ";
+        out += user["name"].get_ref<const std::string&>();
+        out += "</a>\n        ";
+    }
+    out += "\n    </header>\n    <table>\n        ";
+    for (const auto& product : ctx["products"]) {
+        out += "\n            <tr>\n                <td>";
+        append_number(product["id"].get<int>());
+        out += "</td>\n                <td>";
+        out += product["name"].get_ref<const std::string&>();
+        out += "</td>\n                <td>";
+        out += product["category"]["name"].get_ref<const std::string&>();
+        out += "</td>\n                <td>";
+        append_number(product["price"].get<double>());
+        out += "</td>\n                ";
+        if (product["in_stock"].get<bool>()) out += "\n                    <td class=\"ok\">In stock</td>\n                ";
+        out += "\n                ";
+        if (!product["in_stock"].get<bool>()) out += "\n                    <td class=\"no\">Sold out</td>\n                ";
+        out += "\n            </tr>\n        ";
+    }
+    out += "\n    </table>\n</body>\n</html>\n";
+}
+
+// benchmarks/views/listing.breeze, which breeze_add_views() also compiles into this binary
+const std::string kListingTemplate = [] {
+    std::ifstream in(BREEZE_BENCH_VIEWS "/listing.breeze", std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}();
+
+struct BenchRepository {};
+struct BenchService {
+    std::shared_ptr<BenchRepository> repository = std::make_shared<BenchRepository>();
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) options.json_path = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) options.min_time = std::chrono::milliseconds(std::stoi(argv[++i]));
+        else if (arg == "--repetitions" && i + 1 < argc) options.repetitions = std::max(1, std::stoi(argv[++i]));
+        else {
+            std::cerr << "usage: breeze_bench [--json FILE] [--filter TEXT] [--min-time MS] [--repetitions N]\n";
+            return 2;
+        }
+    }
+
+    // Benchmarks measure the framework, not the access log writer or tracing
+    breeze::support::AccessLogOptions log_options;
+    log_options.enabled = false;
+    breeze::support::AccessLog::instance().configure(log_options);
+    breeze::support::TraceOptions trace_options;
+    trace_options.enabled = false;
+    breeze::support::Tracer::instance().configure(trace_options);
+
+    Suite suite(options);
+
+    // HTTP parsing and serialisation
+    suite.add("parse_request/get", [] {
+        auto req = breeze::http::Server::parse_request(kGetRequest);
+        do_not_optimize(req);
+    });
+    suite.add("parse_request/post_json", [] {
+        auto req = breeze::http::Server::parse_request(kPostRequest);
+        do_not_optimize(req);
+    });
+
+    breeze::http::Response page(breeze::http::StatusCode::OK, std::string(1024, 'x'));
+    page.content_type("text/html; charset=utf-8");
+    page.set_header("Cache-Control", "no-cache");
+    page.set_header("X-Frame-Options", "DENY");
+    page.set_header("Set-Cookie", "session=abc123; HttpOnly");
+    suite.add("response/to_string_1k", [&page] {
+        auto raw = page.to_string();
+        do_not_optimize(raw);
+    });
+
+    auto payload = nlohmann::json::parse(kJsonBody);
+    suite.add("response/json", [&payload] {
+        auto res = breeze::http::Response::json(payload);
+        do_not_optimize(res);
+    });
+
+    breeze::http::Request json_request;
+    json_request.set_header("Content-Type", "application/json");
+    suite.add("request/json", [&json_request] {
+        json_request.set_body(kJsonBody); // resets the cached parse
+        auto data = json_request.json();
+        do_not_optimize(data);
+    });
+
+    // Routing: hit the last route (full scan) and the middle one
+    std::vector<std::unique_ptr<breeze::http::Router>> routers;
+    for (int n : {10, 100, 1000}) {
+        auto& router = *routers.emplace_back(make_router(n));
+        for (int target : {n / 2 | 1, n - 1}) {
+            breeze::http::Request req;
+            req.set_path("/resource" + std::to_string(target) + "/42");
+            auto label = target == n - 1 ? "last" : "middle";
+            suite.add("dispatch/" + std::to_string(n) + "_routes/" + label, [&router, req] {
+                auto res = router.dispatch(req);
+                do_not_optimize(res);
+            });
+        }
+    }
+
+    // Middleware pipeline: five pass-through layers
+    breeze::http::MiddlewarePipeline pipeline;
+    for (int i = 0; i < 5; ++i) {
+        pipeline.add([](const breeze::http::Request& req, const breeze::http::MiddlewarePipeline::Next& next) {
+            auto res = next(req);
+            res.set_header("X-Layer", "1");
+            return res;
+        });
+    }
+    breeze::http::Request pipeline_request;
+    suite.add("middleware/run_5_layers", [&pipeline, &pipeline_request] {
+        auto res = pipeline.run(pipeline_request, [](const breeze::http::Request&) {
+            return breeze::http::Response::ok("done");
+        });
+        do_not_optimize(res);
+    });
+
+    // What tracing adds to one request: the trace and the spans Kernel and Server record
+    suite.add("tracing/request_trace", [] {
+        auto& tracer = breeze::support::Tracer::instance();
+        tracer.set_enabled(true);
+        {
+            breeze::support::TraceScope scope;
+            { breeze::support::Span span("parse"); }
+            {
+                breeze::support::Span middleware("middleware");
+                breeze::support::Span dispatch("dispatch");
+            }
+            { breeze::support::Span span("serialize"); }
+            breeze::support::Trace::current()->describe("GET", "/users/42/posts", 200);
+        }
+        tracer.set_enabled(false);
+    });
+
+    // Container resolution before and after freeze()
+    breeze::core::Container container;
+    container.singleton<BenchRepository>([] { return std::make_shared<BenchRepository>(); });
+    container.bind<BenchService>([] { return std::make_shared<BenchService>(); });
+    suite.add("container/make_singleton", [&container] {
+        auto repo = container.make<BenchRepository>();
+        do_not_optimize(repo);
+    });
+    suite.add("container/make_binding", [&container] {
+        auto service = container.make<BenchService>();
+        do_not_optimize(service);
+    });
+    breeze::core::Container frozen;
+    frozen.singleton<BenchRepository>([] { return std::make_shared<BenchRepository>(); });
+    frozen.bind<BenchService>([] { return std::make_shared<BenchService>(); });
+    frozen.freeze();
+    suite.add("container/make_singleton_frozen", [&frozen] {
+        auto repo = frozen.make<BenchRepository>();
+        do_not_optimize(repo);
+    });
+    suite.add("container/make_binding_frozen", [&frozen] {
+        auto service = frozen.make<BenchService>();
+        do_not_optimize(service);
+    });
+
+    // Blade: a product listing page, from a string and from a cached file
+    breeze::support::Blade blade;
+    auto small = listing_context(10);
+    auto large = listing_context(200);
+    suite.add("blade/render_listing_10", [&blade, &small] {
+        auto html = blade.render(kListingTemplate, small);
+        do_not_optimize(html);
+    });
+    suite.add("blade/render_listing_200", [&blade, &large] {
+        auto html = blade.render(kListingTemplate, large);
+        do_not_optimize(html);
+    });
+
+    suite.add("blade/compile_listing", [] {
+        auto program = breeze::support::blade::compile(kListingTemplate);
+        do_not_optimize(program);
+    });
+    // 64 listings in one template (~48 KB): compile time should grow linearly with size
+    std::string large_template;
+    for (int i = 0; i < 64; ++i) large_template += kListingTemplate;
+    suite.add("blade/compile_listing_x64", [&large_template] {
+        auto program = breeze::support::blade::compile(large_template);
+        do_not_optimize(program);
+    });
+    suite.add("blade/handwritten_listing_10", [&small] {
+        std::string html;
+        render_listing_by_hand(small, html);
+        do_not_optimize(html);
+    });
+
+    // The same listing as generated C++ (breeze_add_views)
+    const auto* compiled_listing = breeze::support::blade::find_compiled("listing");
+    if (compiled_listing) {
+        suite.add("blade/render_compiled_listing_10", [compiled_listing, &small] {
+            std::string html;
+            breeze::support::blade::execute(*compiled_listing, small, html);
+            do_not_optimize(html);
+        });
+        suite.add("blade/render_compiled_listing_200", [compiled_listing, &large] {
+            std::string html;
+            breeze::support::blade::execute(*compiled_listing, large, html);
+            do_not_optimize(html);
+        });
+    }
+
+    // What a worker does with a precompiled view instead of compiling it: validate the image in place
+    auto listing_image = breeze::support::blade::serialize(breeze::support::blade::compile(kListingTemplate));
+    suite.add("blade/load_precompiled_listing", [&listing_image] {
+        auto view = breeze::support::blade::load(listing_image);
+        do_not_optimize(view);
+    });
+
+    auto view_dir = std::filesystem::temp_directory_path() / "breeze_bench_views";
+    std::filesystem::create_directories(view_dir);
+    auto view_file = view_dir / "listing.blade.html";
+    std::ofstream(view_file) << kListingTemplate;
+    suite.add("blade/render_from_file_listing_10", [&blade, &small, &view_file] {
+        auto html = blade.render_from_file(view_file, small);
+        do_not_optimize(html);
+    });
+    suite.add("blade/stream_from_file_listing_200", [&blade, &large, &view_file] {
+        std::size_t bytes = 0;
+        blade.stream_from_file(view_file, large, [&bytes](std::string_view chunk) { bytes += chunk.size(); });
+        do_not_optimize(bytes);
+    });
+
+    // The 200-item listing wrapped in @cache: after the first render, the body is one lookup
+    const std::string cached_listing = "@cache('bench-listing', 3600)" + kListingTemplate + "@endcache";
+    suite.add("blade/render_cached_listing_200", [&blade, &large, &cached_listing] {
+        auto html = blade.render(cached_listing, large);
+        do_not_optimize(html);
+    });
+
+    // HTML escaping: 4 KiB of prose (nothing to escape) and of markup (a special every ~10 bytes)
+    std::string prose, markup;
+    while (prose.size() < 4096) prose += "The quick brown fox jumps over the lazy dog. ";
+    while (markup.size() < 4096) markup += "<a href=\"/x?a=1&b=2\">it's</a> ";
+    for (const auto* text : {&prose, &markup}) {
+        std::string kind = text == &prose ? "prose" : "markup";
+        suite.add("str/escape_switch_" + kind + "_4k", [text] {
+            std::string out;
+            out.reserve(text->size() * 2);
+            escape_by_switch(out, *text);
+            do_not_optimize(out);
+        });
+        suite.add("str/escape_simd_" + kind + "_4k", [text] {
+            std::string out;
+            out.reserve(text->size() * 2);
+            breeze::support::str::append_html_escaped(out, *text);
+            do_not_optimize(out);
+        });
+    }
+
+    auto results = suite.run();
+    std::filesystem::remove_all(view_dir);
+
+    if (!options.json_path.empty()) {
+        write_json(options.json_path, results);
+        std::cout << "Wrote " << results.size() << " results to " << options.json_path << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+# breeze_add_views(<target> DIR <views dir> [EXTENSION .breeze])
+#
+# Compiles every template under DIR to C++ at build time (breeze_viewc) and adds the generated
+# sources to <target>. Each one registers itself under its path relative to DIR without the
+# extension ("index", "admin/users"), so View / Response::view dispatch to it; any other view
+# is still rendered by the interpreter. @extends / @include / @component names resolve against
+# DIR; editing a template rebuilds its generated source and those of the views that link it.
+function(breeze_add_views target)
+  cmake_parse_arguments(ARG "" "DIR;EXTENSION" "" ${ARGN})
+  if(NOT ARG_DIR)
+    message(FATAL_ERROR "breeze_add_views: DIR is required")
+  endif()
+  if(NOT ARG_EXTENSION)
+    set(ARG_EXTENSION ".breeze")
+  endif()
+  get_filename_component(views_dir "${ARG_DIR}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+
+  file(GLOB_RECURSE templates CONFIGURE_DEPENDS "${views_dir}/*${ARG_EXTENSION}")
+  set(generated)
+  foreach(template IN LISTS templates)
+    file(RELATIVE_PATH relative "${views_dir}" "${template}")
+    string(LENGTH "${relative}" relative_length)
+    string(LENGTH "${ARG_EXTENSION}" extension_length)
+    math(EXPR name_length "${relative_length} - ${extension_length}")
+    string(SUBSTRING "${relative}" 0 ${name_length} view_name)
+    set(output "${CMAKE_CURRENT_BINARY_DIR}/breeze_views/${target}/${view_name}.cpp")
+    get_filename_component(output_dir "${output}" DIRECTORY)
+    add_custom_command(
+      OUTPUT "${output}"
+      COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+      COMMAND breeze_viewc "${template}" "${output}" "${view_name}" "${views_dir}"
+      DEPENDS breeze_viewc "${template}"
+      DEPFILE "${output}.d"
+      COMMENT "Compiling view ${view_name}"
+      VERBATIM
+    )
+    list(APPEND generated "${output}")
+  endforeach()
+  target_sources(${target} PRIVATE ${generated})
+endfunction()
@@ -14,7 +14,13 @@
 #include <breeze/database/model.hpp>
 #include <breeze/database/query.hpp>
 
+#include <breeze/support/access_log.hpp>
 #include <breeze/support/blade.hpp>
+#include <breeze/support/blade_program.hpp>
+#include <breeze/support/metrics.hpp>
+#include <breeze/support/tracing.hpp>
+#include <breeze/support/profiler.hpp>
+#include <breeze/support/traffic_capture.hpp>
 #include <breeze/support/collections.hpp>
 #include <breeze/support/helpers.hpp>
 #include <breeze/support/str.hpp>
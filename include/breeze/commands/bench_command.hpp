@@ -0,0 +1,511 @@
+#pragma once
+#include <breeze/core/command.hpp>
+#include <breeze/core/application.hpp>
+#include <breeze/http/server.hpp>
+
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace breeze::commands {
+
+// HTTP load generator.
+//
+//   breeze_cli bench --url http://127.0.0.1:8000/ --concurrency 32 --duration 10
+//   breeze_cli bench --mix requests.txt --rate 2000 --keep-alive
+//   breeze_cli bench --in-process --requests 100000
+//
+// Closed loop (default): each worker sends its next request as soon as the previous one
+// completes. Open loop (--rate): requests are scheduled at a fixed rate and latency is
+// measured from the scheduled send time, so a stalled server cannot hide its queueing delay
+// (coordinated omission).
+//
+// A mix file has one request per line: `METHOD PATH [WEIGHT] [BODY]`, e.g.
+//   GET /            5
+//   GET /api/users   3
+//   POST /api/users  1 {"name":"Ada"}
+class BenchCommand : public breeze::core::Command {
+public:
+    using Setup = std::function<void(breeze::core::Application&)>;
+
+    BenchCommand() = default;
+    // `setup` registers providers and routes for --in-process runs
+    explicit BenchCommand(Setup setup) : setup_(std::move(setup)) {}
+
+    std::string name() const override { return "bench"; }
+    std::string description() const override { return "Load test a running server or the in-process application"; }
+
+    std::vector<Option> options() const override {
+        return {
+            {"url", "Target base URL (host, port and default path)", "http://127.0.0.1:8000/"},
+            {"in-process", "Drive an in-process Application instead of a socket", "false"},
+            {"concurrency", "Number of concurrent workers / connections", "8"},
+            {"duration", "Test length in seconds (ignored when --requests is set)", "10"},
+            {"requests", "Total number of requests to send", ""},
+            {"rate", "Fixed total request rate per second (open loop)", ""},
+            {"keep-alive", "Reuse connections between requests", "false"},
+            {"mix", "File with weighted requests: METHOD PATH [WEIGHT] [BODY]", ""},
+            {"timeout", "Socket timeout in milliseconds", "5000"},
+        };
+    }
+
+    struct Target {
+        std::string method = "GET";
+        std::string path = "/";
+        std::string body;
+        unsigned weight = 1;
+    };
+
+    // A pre-rendered request sent once at a fixed offset from the start of the run
+    struct Scheduled {
+        std::string raw;
+        std::chrono::microseconds at{0};
+    };
+
+    struct Settings {
+        std::string host = "127.0.0.1";
+        std::string port = "8000";
+        bool in_process = false;
+        unsigned concurrency = 8;
+        std::chrono::duration<double> duration{10.0};
+        std::uint64_t total_requests = 0;        // 0 = run for `duration`
+        double rate = 0;                         // 0 = closed loop
+        bool keep_alive = false;
+        std::chrono::milliseconds timeout{5000};
+        std::vector<Target> mix;
+        std::vector<Scheduled> schedule;         // replay mode: overrides mix, rate and duration
+    };
+
+    struct Report {
+        std::uint64_t completed = 0;
+        std::uint64_t errors = 0;                // socket failures and 5xx responses
+        std::uint64_t non_2xx = 0;
+        std::uint64_t bytes_received = 0;
+        std::uint64_t connections = 0;
+        std::uint64_t reused = 0;                // requests answered on an already open connection
+        double elapsed_seconds = 0;
+        std::vector<std::uint64_t> latencies_us; // sorted
+
+        double percentile_ms(double p) const {
+            if (latencies_us.empty()) return 0;
+            auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(latencies_us.size())));
+            rank = std::clamp<std::size_t>(rank, 1, latencies_us.size());
+            return static_cast<double>(latencies_us[rank - 1]) / 1000.0;
+        }
+
+        nlohmann::json summary() const {
+            return {
+                {"completed", completed},
+                {"errors", errors},
+                {"non_2xx", non_2xx},
+                {"elapsed_seconds", elapsed_seconds},
+                {"throughput", elapsed_seconds > 0 ? static_cast<double>(completed) / elapsed_seconds : 0.0},
+                {"p50_ms", percentile_ms(50)},
+                {"p90_ms", percentile_ms(90)},
+                {"p99_ms", percentile_ms(99)},
+                {"p999_ms", percentile_ms(99.9)},
+                {"max_ms", latencies_us.empty() ? 0.0 : static_cast<double>(latencies_us.back()) / 1000.0},
+            };
+        }
+    };
+
+    int handle(const std::unordered_map<std::string, std::string>& options) override {
+        Settings settings;
+        try {
+            settings = parse_settings(options);
+        } catch (const std::exception& e) {
+            std::cerr << "bench: " << e.what() << "\n";
+            return 1;
+        }
+
+        std::shared_ptr<breeze::core::Application> app;
+        if (settings.in_process) app = make_application();
+
+        char length[32];
+        std::snprintf(length, sizeof(length), "%gs", settings.duration.count());
+        std::cout << "Running " << (settings.total_requests ? std::to_string(settings.total_requests) + " requests"
+                                                            : std::string(length))
+                  << " with " << settings.concurrency << " workers against "
+                  << (settings.in_process ? std::string("in-process application") : settings.host + ":" + settings.port)
+                  << (settings.rate > 0 ? " at " + std::to_string(static_cast<long long>(settings.rate)) + " req/s (open loop)" : "")
+                  << "\n";
+
+        auto report = run(settings, app.get());
+        print_report(report, settings);
+        return report.completed > 0 ? 0 : 1;
+    }
+
+    static Report run(const Settings& settings, breeze::core::Application* app) {
+        std::vector<WorkerResult> results(settings.concurrency);
+        // In-process requests take the socket server's path (request scope, tracing, metrics,
+        // serialization) minus the sockets, so the numbers compare with socket mode
+        std::optional<breeze::http::Server> server;
+        if (app) server.emplace([app](const breeze::http::Request& req) { return app->handle(req); });
+        std::atomic<std::uint64_t> issued{0};
+        bool replay = !settings.schedule.empty();
+        auto started = std::chrono::steady_clock::now();
+        auto deadline = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(settings.duration);
+
+        // Pre-render each target once; workers only pick and send
+        std::vector<std::string> raw_requests;
+        std::vector<unsigned> cumulative_weights;
+        unsigned total_weight = 0;
+        for (const auto& target : settings.mix) {
+            raw_requests.push_back(render_request(target, settings.host, settings.keep_alive));
+            total_weight += target.weight;
+            cumulative_weights.push_back(total_weight);
+        }
+
+        std::vector<std::thread> workers;
+        for (unsigned w = 0; w < settings.concurrency; ++w) {
+            workers.emplace_back([&, w] {
+                auto& out = results[w];
+                std::mt19937 rng(w * 7919u + 17u);
+                std::uniform_int_distribution<unsigned> pick(1, std::max(1u, total_weight));
+                Connection conn;
+
+                // Open loop: this worker owns every concurrency-th slot of the global schedule
+                auto interval = settings.rate > 0
+                    ? std::chrono::duration<double>(static_cast<double>(settings.concurrency) / settings.rate)
+                    : std::chrono::duration<double>(0);
+                auto offset = settings.rate > 0 ? std::chrono::duration<double>(w / settings.rate) : std::chrono::duration<double>(0);
+
+                for (std::uint64_t i = 0;; ++i) {
+                    const std::string* raw = nullptr;
+                    auto intended = std::chrono::steady_clock::now();
+
+                    if (replay) {
+                        // Workers claim the next captured request and wait for its original offset
+                        auto next = issued.fetch_add(1, std::memory_order_relaxed);
+                        if (next >= settings.schedule.size()) break;
+                        const auto& item = settings.schedule[next];
+                        intended = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(item.at);
+                        std::this_thread::sleep_until(intended);
+                        raw = &item.raw;
+                    } else if (settings.total_requests) {
+                        if (issued.fetch_add(1, std::memory_order_relaxed) >= settings.total_requests) break;
+                    } else if (std::chrono::steady_clock::now() >= deadline) {
+                        break;
+                    }
+
+                    if (!replay && settings.rate > 0) {
+                        intended = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset + interval * static_cast<double>(i));
+                        if (!settings.total_requests && intended >= deadline) break;
+                        std::this_thread::sleep_until(intended);
+                    }
+
+                    if (!raw) {
+                        auto choice = pick(rng);
+                        auto index = static_cast<std::size_t>(
+                            std::lower_bound(cumulative_weights.begin(), cumulative_weights.end(), choice) - cumulative_weights.begin());
+                        raw = &raw_requests[index];
+                    }
+
+                    // Time lost on a keep-alive connection the server had already closed is not the
+                    // request's latency: the clock restarts when send_over_socket reconnects
+                    std::chrono::steady_clock::duration stale{0};
+                    int status = server ? send_in_process(*server, *raw, out.bytes)
+                                        : send_over_socket(conn, settings, *raw, out, stale);
+
+                    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - intended - stale);
+                    if (status <= 0 || status >= 500) ++out.errors;
+                    if (status < 200 || status >= 300) ++out.non_2xx;
+                    if (status > 0) out.latencies_us.push_back(static_cast<std::uint64_t>(latency.count()));
+                }
+                conn.close();
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        Report report;
+        report.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        for (auto& r : results) {
+            report.completed += r.latencies_us.size();
+            report.errors += r.errors;
+            report.non_2xx += r.non_2xx;
+            report.bytes_received += r.bytes;
+            report.connections += r.connections;
+            report.reused += r.reused;
+            report.latencies_us.insert(report.latencies_us.end(), r.latencies_us.begin(), r.latencies_us.end());
+        }
+        std::sort(report.latencies_us.begin(), report.latencies_us.end());
+        return report;
+    }
+
+    static std::vector<Target> load_mix(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) throw std::runtime_error("cannot open mix file " + path);
+        std::vector<Target> mix;
+        std::string line;
+        while (std::getline(file, line)) {
+            auto first = line.find_first_not_of(" \t");
+            if (first == std::string::npos || line[first] == '#') continue;
+            std::istringstream in(line);
+            Target target;
+            in >> target.method >> target.path;
+            if (target.path.empty()) throw std::runtime_error("bad mix line: " + line);
+            std::string weight;
+            if (in >> weight) target.weight = static_cast<unsigned>(std::max(1, std::stoi(weight)));
+            std::getline(in >> std::ws, target.body);
+            mix.push_back(std::move(target));
+        }
+        if (mix.empty()) throw std::runtime_error("mix file " + path + " has no requests");
+        return mix;
+    }
+
+    static Settings parse_settings(const std::unordered_map<std::string, std::string>& options) {
+        Settings s;
+        auto get = [&options](const std::string& key, const std::string& fallback) {
+            auto it = options.find(key);
+            return it != options.end() ? it->second : fallback;
+        };
+
+        std::string url = get("url", "http://127.0.0.1:8000/");
+        std::string default_path = "/";
+        if (url.rfind("http://", 0) == 0) url = url.substr(7);
+        else if (url.find("://") != std::string::npos) throw std::runtime_error("only http:// URLs are supported");
+        auto slash = url.find('/');
+        if (slash != std::string::npos) {
+            default_path = url.substr(slash);
+            url = url.substr(0, slash);
+        }
+        auto colon = url.rfind(':');
+        s.host = colon == std::string::npos ? url : url.substr(0, colon);
+        s.port = colon == std::string::npos ? "80" : url.substr(colon + 1);
+
+        s.in_process = get("in-process", "false") == "true";
+        s.concurrency = static_cast<unsigned>(std::max(1, std::stoi(get("concurrency", "8"))));
+        s.duration = std::chrono::duration<double>(std::stod(get("duration", "10")));
+        if (auto n = get("requests", ""); !n.empty()) s.total_requests = std::stoull(n);
+        if (auto r = get("rate", ""); !r.empty()) s.rate = std::stod(r);
+        s.keep_alive = get("keep-alive", "false") == "true";
+        s.timeout = std::chrono::milliseconds(std::stoi(get("timeout", "5000")));
+
+        if (auto mix = get("mix", ""); !mix.empty()) s.mix = load_mix(mix);
+        else s.mix.push_back({"GET", default_path, "", 1});
+        return s;
+    }
+
+    // Application with the configured providers and routes, ready to handle requests
+    std::shared_ptr<breeze::core::Application> make_application() const {
+        auto app = breeze::core::Application::create();
+        if (setup_) setup_(*app);
+        app->boot();
+        app->finalize_routing();
+        app->container().freeze();
+        // Keep the report readable: the access log would mirror every request to stdout
+        breeze::support::AccessLogOptions quiet;
+        quiet.enabled = false;
+        breeze::support::AccessLog::instance().configure(quiet);
+        return app;
+    }
+
+    static void print_report(const Report& r, const Settings& settings) {
+        auto throughput = r.elapsed_seconds > 0 ? static_cast<double>(r.completed) / r.elapsed_seconds : 0.0;
+        auto megabytes = r.elapsed_seconds > 0
+            ? static_cast<double>(r.bytes_received) / r.elapsed_seconds / (1024.0 * 1024.0) : 0.0;
+        std::printf("\n  Requests:     %llu completed, %llu errors, %llu non-2xx\n",
+                    static_cast<unsigned long long>(r.completed), static_cast<unsigned long long>(r.errors),
+                    static_cast<unsigned long long>(r.non_2xx));
+        std::printf("  Duration:     %.2fs\n", r.elapsed_seconds);
+        std::printf("  Throughput:   %.1f req/s, %.2f MB/s received\n", throughput, megabytes);
+        if (!settings.in_process) {
+            if (r.reused > 0) {
+                std::printf("  Connections:  %llu opened, %llu requests on reused ones (keep-alive)\n",
+                            static_cast<unsigned long long>(r.connections), static_cast<unsigned long long>(r.reused));
+            } else {
+                std::printf("  Connections:  %llu opened%s\n", static_cast<unsigned long long>(r.connections),
+                            settings.keep_alive ? " (none reused: the server closed each one)" : "");
+            }
+        }
+        std::printf("  Latency (ms): p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f\n",
+                    r.percentile_ms(50), r.percentile_ms(90), r.percentile_ms(99), r.percentile_ms(99.9),
+                    r.latencies_us.empty() ? 0.0 : static_cast<double>(r.latencies_us.back()) / 1000.0);
+        if (settings.rate > 0 && throughput < settings.rate * 0.95) {
+            std::printf("  Note: achieved %.1f req/s, below the requested %.1f; latencies include queueing delay.\n",
+                        throughput, settings.rate);
+        }
+    }
+
+private:
+    // One worker's share of the report
+    struct WorkerResult {
+        std::vector<std::uint64_t> latencies_us;
+        std::uint64_t errors = 0;
+        std::uint64_t non_2xx = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t connections = 0;
+        std::uint64_t reused = 0;
+    };
+
+    struct Connection {
+        int fd = -1;
+        void close() {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    };
+
+    static std::string render_request(const Target& target, const std::string& host, bool keep_alive) {
+        std::string raw = target.method + " " + target.path + " HTTP/1.1\r\nHost: " + host +
+                          "\r\nUser-Agent: breeze-bench\r\nConnection: " + (keep_alive ? "keep-alive" : "close") + "\r\n";
+        if (!target.body.empty()) {
+            raw += "Content-Type: application/json\r\nContent-Length: " + std::to_string(target.body.size()) + "\r\n";
+        }
+        raw += "\r\n" + target.body;
+        return raw;
+    }
+
+    static int send_in_process(const breeze::http::Server& server, const std::string& raw, std::uint64_t& bytes) {
+        try {
+            auto response = server.process(raw, "127.0.0.1");
+            bytes += response.size();
+            // "HTTP/1.1 200 OK"
+            auto space = response.find(' ');
+            return space == std::string::npos ? 0 : std::atoi(response.c_str() + space + 1);
+        } catch (...) {
+            return 0;
+        }
+    }
+
+    static bool connect_to(Connection& conn, const Settings& settings) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(settings.host.c_str(), settings.port.c_str(), &hints, &found) != 0) return false;
+        for (auto* ai = found; ai; ai = ai->ai_next) {
+            int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            timeval tv{};
+            tv.tv_sec = static_cast<time_t>(settings.timeout.count() / 1000);
+            tv.tv_usec = static_cast<suseconds_t>((settings.timeout.count() % 1000) * 1000);
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                conn.fd = fd;
+                break;
+            }
+            ::close(fd);
+        }
+        freeaddrinfo(found);
+        return conn.fd >= 0;
+    }
+
+    // Send one request and read one response; returns the status code or 0 on failure.
+    // `stale` receives the time spent on a reused connection the server had closed.
+    static int send_over_socket(Connection& conn, const Settings& settings, const std::string& raw,
+                                WorkerResult& counters, std::chrono::steady_clock::duration& stale) {
+        auto attempt_started = std::chrono::steady_clock::now();
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            bool reused = conn.fd >= 0;
+            if (!reused) {
+                if (!connect_to(conn, settings)) return 0;
+                ++counters.connections;
+            }
+
+            bool keep_open = false;
+            int status = 0;
+            if (::send(conn.fd, raw.data(), raw.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(raw.size())) {
+                status = read_response(conn.fd, counters.bytes, keep_open);
+            }
+            if (status == 0 && reused) {
+                // The server closed an idle keep-alive connection: reconnect and start over
+                conn.close();
+                stale = std::chrono::steady_clock::now() - attempt_started;
+                continue;
+            }
+            if (status > 0 && reused) ++counters.reused;
+            if (!settings.keep_alive || !keep_open || status == 0) conn.close();
+            return status;
+        }
+        return 0;
+    }
+
+    static int read_response(int fd, std::uint64_t& bytes, bool& keep_open) {
+        std::string buffer;
+        char chunk[16384];
+        std::size_t header_end = std::string::npos;
+        std::size_t content_length = 0;
+        bool has_length = false;
+        bool chunked = false;
+        std::size_t chunk_pos = 0;  // start of the next unparsed chunk-size line
+        int status = 0;
+
+        for (;;) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                // Connection closed: the response ends here unless we were promised more
+                if (header_end != std::string::npos && !has_length && !chunked) {
+                    bytes += buffer.size();
+                    keep_open = false;
+                    return status;
+                }
+                return 0;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(n));
+
+            if (header_end == std::string::npos) {
+                header_end = buffer.find("\r\n\r\n");
+                if (header_end == std::string::npos) continue;
+                if (buffer.size() < 12 || buffer.compare(0, 5, "HTTP/") != 0) return 0;
+                status = std::atoi(buffer.c_str() + 9);
+
+                std::string headers = buffer.substr(0, header_end);
+                std::transform(headers.begin(), headers.end(), headers.begin(), [](unsigned char c) { return std::tolower(c); });
+                if (auto pos = headers.find("\r\ncontent-length:"); pos != std::string::npos) {
+                    content_length = std::strtoull(headers.c_str() + pos + 17, nullptr, 10);
+                    has_length = true;
+                }
+                keep_open = headers.find("\r\nconnection: close") == std::string::npos;
+                if (!has_length && headers.find("\r\ntransfer-encoding: chunked") != std::string::npos) {
+                    chunked = true;
+                    chunk_pos = header_end + 4;
+                }
+            }
+            if ((has_length && buffer.size() >= header_end + 4 + content_length) ||
+                (chunked && chunked_body_complete(buffer, chunk_pos))) {
+                bytes += buffer.size();
+                return status;
+            }
+        }
+    }
+
+    // Walk the chunks received so far, advancing `pos` past each complete one. True once the
+    // terminating zero-size chunk and its (possibly empty) trailer section have arrived.
+    static bool chunked_body_complete(const std::string& buffer, std::size_t& pos) {
+        for (;;) {
+            auto line_end = buffer.find("\r\n", pos);
+            if (line_end == std::string::npos) return false;
+            // Chunk extensions after ';' are ignored by strtoull
+            std::size_t size = std::strtoull(buffer.c_str() + pos, nullptr, 16);
+            if (size == 0) return buffer.find("\r\n\r\n", line_end) != std::string::npos;
+            if (buffer.size() < line_end + 2 + size + 2) return false;
+            pos = line_end + 2 + size + 2;
+        }
+    }
+
+    Setup setup_;
+};
+
+} // namespace breeze::commands
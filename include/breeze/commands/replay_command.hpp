@@ -0,0 +1,181 @@
+#pragma once
+#include <breeze/commands/bench_command.hpp>
+#include <breeze/support/traffic_capture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace breeze::commands {
+
+// Replays a traffic capture (see CaptureTraffic middleware) with the original arrival times.
+//
+//   breeze_cli replay --file storage/capture/traffic.bin --in-process --save before.json
+//   breeze_cli replay --url http://127.0.0.1:8000 --speed 2 --compare before.json
+//
+// --speed scales the original rate (2 = twice as fast, 0 = as fast as possible). --save
+// stores the latency summary; --compare prints it next to this run and exits non-zero when
+// p50/p90/p99 regress by more than --threshold percent, for comparing two builds.
+class ReplayCommand : public breeze::core::Command {
+public:
+    ReplayCommand() = default;
+    explicit ReplayCommand(BenchCommand::Setup setup) : bench_(std::move(setup)) {}
+
+    std::string name() const override { return "replay"; }
+    std::string description() const override { return "Replay captured traffic and compare latency between builds"; }
+
+    std::vector<Option> options() const override {
+        return {
+            {"file", "Capture file to replay", "storage/capture/traffic.bin"},
+            {"url", "Target server", "http://127.0.0.1:8000"},
+            {"in-process", "Replay through an in-process Application (Server::process)", "false"},
+            {"speed", "Rate multiplier; 0 replays as fast as possible", "1"},
+            {"concurrency", "Maximum requests in flight", "16"},
+            {"limit", "Replay at most this many requests", ""},
+            {"save", "Write the latency summary to this JSON file", ""},
+            {"compare", "Baseline summary JSON to compare against", ""},
+            {"threshold", "Allowed percentile regression in percent", "10"},
+        };
+    }
+
+    int handle(const std::unordered_map<std::string, std::string>& options) override {
+        auto get = [&options](const std::string& key, const std::string& fallback) {
+            auto it = options.find(key);
+            return it != options.end() ? it->second : fallback;
+        };
+
+        BenchCommand::Settings settings;
+        std::vector<breeze::support::CapturedRequest> records;
+        std::optional<std::size_t> limit;
+        double speed = 1;
+        double threshold = 10;
+        try {
+            auto bench_options = options;
+            bench_options.try_emplace("concurrency", "16");
+            settings = BenchCommand::parse_settings(bench_options);
+            if (auto value = get("limit", ""); !value.empty()) limit = parse_number<std::size_t>("limit", value);
+            speed = parse_number<double>("speed", get("speed", "1"));
+            threshold = parse_number<double>("threshold", get("threshold", "10"));
+        } catch (const std::exception& e) {
+            std::cerr << "replay: " << e.what() << "\n";
+            std::cerr << "usage: breeze_cli replay --file=<capture> [--speed=<x>] [--limit=<n>] [--threshold=<percent>]\n";
+            return 1;
+        }
+        try {
+            records = breeze::support::TrafficReader::read_all(get("file", "storage/capture/traffic.bin"));
+        } catch (const std::exception& e) {
+            std::cerr << "replay: " << e.what() << "\n";
+            return 1;
+        }
+        if (records.empty()) {
+            std::cerr << "replay: capture file is empty\n";
+            return 1;
+        }
+        if (limit && *limit < records.size()) records.resize(*limit);
+
+        settings.schedule = schedule(records, settings.host, speed);
+        std::shared_ptr<breeze::core::Application> app;
+        if (settings.in_process) app = bench_.make_application();
+
+        std::cout << "Replaying " << records.size() << " captured requests against "
+                  << (settings.in_process ? std::string("in-process application") : settings.host + ":" + settings.port)
+                  << "\n";
+        auto report = BenchCommand::run(settings, app.get());
+        BenchCommand::print_report(report, settings);
+
+        auto summary = report.summary();
+        summary["source"] = get("file", "storage/capture/traffic.bin");
+        summary["captured_p99_ms"] = captured_percentile_ms(records, 99);
+        if (auto save = get("save", ""); !save.empty()) {
+            std::ofstream(save) << summary.dump(2) << "\n";
+            std::cout << "  Saved summary to " << save << "\n";
+        }
+        if (auto baseline = get("compare", ""); !baseline.empty()) {
+            return compare(baseline, summary, threshold);
+        }
+        return report.completed > 0 ? 0 : 1;
+    }
+
+    // Send times relative to the first captured request, divided by `speed`
+    static std::vector<BenchCommand::Scheduled> schedule(const std::vector<breeze::support::CapturedRequest>& records,
+                                                         const std::string& host, double speed) {
+        std::vector<BenchCommand::Scheduled> out;
+        out.reserve(records.size());
+        auto first = records.empty() ? 0 : records.front().offset_us;
+        for (const auto& r : records) first = std::min(first, r.offset_us);
+        for (const auto& r : records) {
+            auto at = speed > 0 ? static_cast<std::int64_t>(static_cast<double>(r.offset_us - first) / speed) : 0;
+            out.push_back({r.to_http(host), std::chrono::microseconds(at)});
+        }
+        std::stable_sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.at < b.at; });
+        return out;
+    }
+
+    // Compare against a saved summary; returns 1 if any percentile regressed past the threshold
+    static int compare(const std::string& baseline_path, const nlohmann::json& current, double threshold) {
+        nlohmann::json baseline;
+        try {
+            std::ifstream in(baseline_path);
+            in >> baseline;
+        } catch (const std::exception& e) {
+            std::cerr << "replay: cannot read baseline " << baseline_path << ": " << e.what() << "\n";
+            return 1;
+        }
+
+        bool regressed = false;
+        std::printf("\n  %-10s %12s %12s %9s\n", "metric", "baseline", "current", "change");
+        for (const char* key : {"p50_ms", "p90_ms", "p99_ms", "p999_ms", "max_ms", "throughput"}) {
+            double before = baseline.value(key, 0.0);
+            double after = current.value(key, 0.0);
+            double change = before > 0 ? (after - before) / before * 100.0 : 0.0;
+            bool gated = std::string(key) == "p50_ms" || std::string(key) == "p90_ms" || std::string(key) == "p99_ms";
+            bool bad = gated && change > threshold;
+            regressed = regressed || bad;
+            std::printf("  %-10s %12.3f %12.3f %+8.1f%%%s\n", key, before, after, change, bad ? "  REGRESSION" : "");
+        }
+        if (current.value("errors", 0) > baseline.value("errors", 0)) {
+            std::printf("  errors increased: %d -> %d\n", baseline.value("errors", 0), current.value("errors", 0));
+            regressed = true;
+        }
+        return regressed ? 1 : 0;
+    }
+
+private:
+    // Whole-string numeric option; throws std::invalid_argument naming the option otherwise
+    template<typename T>
+    static T parse_number(const std::string& name, const std::string& value) {
+        std::size_t used = 0;
+        T parsed{};
+        try {
+            if constexpr (std::is_floating_point_v<T>) parsed = static_cast<T>(std::stod(value, &used));
+            else parsed = static_cast<T>(std::stoull(value, &used));
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != value.size() || (std::is_unsigned_v<T> && value.front() == '-') ||
+            (std::is_floating_point_v<T> && !(parsed >= 0))) {
+            throw std::invalid_argument("--" + name + " expects a non-negative number, got '" + value + "'");
+        }
+        return parsed;
+    }
+
+    static double captured_percentile_ms(const std::vector<breeze::support::CapturedRequest>& records, double p) {
+        std::vector<std::uint32_t> durations;
+        durations.reserve(records.size());
+        for (const auto& r : records) durations.push_back(r.duration_us);
+        std::sort(durations.begin(), durations.end());
+        auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(durations.size())));
+        rank = std::clamp<std::size_t>(rank, 1, durations.size());
+        return static_cast<double>(durations[rank - 1]) / 1000.0;
+    }
+
+    BenchCommand bench_;
+};
+
+} // namespace breeze::commands
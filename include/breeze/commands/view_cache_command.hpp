@@ -0,0 +1,72 @@
+#pragma once
+#include <breeze/core/application.hpp>
+#include <breeze/core/command.hpp>
+#include <breeze/support/blade.hpp>
+#include <breeze/support/view.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace breeze::commands {
+
+// Precompiles every view into storage/framework/views at deploy time, so workers map the
+// compiled programs on first render instead of compiling them on the request path.
+//
+//   breeze_cli view:cache --path resources/views
+//
+// Templates compile with the application's view settings (config/view.json); --path overrides
+// view.path. Stale compiled files are removed first. Run it from the project root, like breeze_app.
+class ViewCacheCommand : public breeze::core::Command {
+public:
+    std::string name() const override { return "view:cache"; }
+    std::string description() const override { return "Compile all view templates into the view cache"; }
+
+    std::vector<Option> options() const override {
+        return {
+            {"path", "Directory of view templates (default: view.path)", ""},
+        };
+    }
+
+    int handle(const std::unordered_map<std::string, std::string>& options) override {
+        auto app = breeze::core::Application::create();
+        auto blade_options = app->view_options();
+        if (auto it = options.find("path"); it != options.end()) blade_options.views_path = it->second;
+        const auto root = blade_options.views_path;
+
+        std::error_code ec;
+        if (!std::filesystem::is_directory(root, ec)) {
+            std::cerr << "view:cache: " << root.string() << " is not a directory\n";
+            return 1;
+        }
+
+        // @extends / @include names resolve against the same directory
+        breeze::support::Blade::configure(blade_options);
+        breeze::support::Blade::clear_cache();
+        const auto& extensions = breeze::support::View::extensions();
+        std::size_t compiled = 0, failed = 0;
+        for (auto entry = std::filesystem::recursive_directory_iterator(root, ec);
+             !ec && entry != std::filesystem::recursive_directory_iterator(); entry.increment(ec)) {
+            if (!entry->is_regular_file(ec)) continue;
+            auto ext = entry->path().extension().string();
+            if (std::find(extensions.begin(), extensions.end(), ext) == extensions.end()) continue;
+            if (breeze::support::Blade::precompile(entry->path())) {
+                ++compiled;
+            } else {
+                std::cerr << "view:cache: failed to compile " << entry->path().string() << "\n";
+                ++failed;
+            }
+        }
+        if (ec) {
+            std::cerr << "view:cache: " << ec.message() << "\n";
+            return 1;
+        }
+
+        std::cout << "Compiled " << compiled << " view" << (compiled == 1 ? "" : "s") << " into storage/framework/views\n";
+        return failed ? 1 : 0;
+    }
+};
+
+} // namespace breeze::commands
@@ -6,9 +6,15 @@
 #include <breeze/http/request.hpp>
 #include <breeze/http/response.hpp>
 #include <breeze/http/server.hpp>
+#include <breeze/support/access_log.hpp>
+#include <breeze/support/blade.hpp>
+#include <breeze/support/metrics.hpp>
+#include <breeze/support/tracing.hpp>
 #include <breeze/support/env.hpp>
 #include <memory>
 #include <functional>
+#include <future>
+#include <type_traits>
 #include <vector>
 #include <iostream>
 
@@ -24,11 +30,31 @@ public:
     
     virtual void register_services() = 0;
     virtual void boot() {}
+
+    // Return true if boot() only touches this provider's own services (not the kernel,
+    // router or other providers), so it can run concurrently with other boots.
+    virtual bool boots_independently() const { return false; }
     
 protected:
     Application& app_;
 };
 
+// Provider that is registered and booted only when one of the types it provides is
+// first resolved from the container. Must not register routes or middleware.
+class DeferrableProvider : public ServiceProvider {
+public:
+    using ServiceProvider::ServiceProvider;
+
+    // Container type ids this provider registers, e.g. provides_types<View>()
+    virtual std::vector<size_t> provides() const = 0;
+
+protected:
+    template<typename... Types>
+    static std::vector<size_t> provides_types() {
+        return {Container::type_id<Types>()...};
+    }
+};
+
 class Application {
 public:
     Application() {
@@ -39,6 +65,7 @@ public:
         // Create and register the global singleton so Application::instance() and
         // the created shared_ptr refer to the same Application.
         singleton_ = std::make_shared<Application>();
+        singleton_router_ = &singleton_->kernel().router();
         instance_initialized_ = true;
         return singleton_;
     }
@@ -67,6 +94,10 @@ public:
         // Finalize routing
         finalize_routing();
 
+        // Requests are served concurrently from here on: switch the container to its
+        // immutable lookup table so resolution needs no locking
+        container_.freeze();
+
         std::string host = "0.0.0.0";
         // Print environment-aware startup message
         if (is_production()) {
@@ -87,13 +118,31 @@ public:
     template<typename Provider>
     void register_provider() {
         auto provider = std::make_shared<Provider>(*this);
+        if constexpr (std::is_base_of_v<DeferrableProvider, Provider>) {
+            // Registered and booted on first resolution of one of its types
+            container_.defer(provider->provides(), [provider] {
+                provider->register_services();
+                provider->boot();
+            });
+            return;
+        }
         provider->register_services();
         service_providers_.push_back(provider);
     }
     
     void boot() {
+        // Independent providers boot on worker threads while the rest boot in order here
+        std::vector<std::future<void>> parallel_boots;
         for (auto& provider : service_providers_) {
-            provider->boot();
+            if (provider->boots_independently()) {
+                parallel_boots.push_back(std::async(std::launch::async, [provider] { provider->boot(); }));
+            }
+        }
+        for (auto& provider : service_providers_) {
+            if (!provider->boots_independently()) provider->boot();
+        }
+        for (auto& boot : parallel_boots) {
+            boot.get();
         }
 
         // Ensure kernel can propagate middleware aliases/groups into the router
@@ -105,11 +154,17 @@ public:
         if (!singleton_) {
             // Lazily create the singleton if not set
             singleton_ = std::make_shared<Application>();
+            singleton_router_ = &singleton_->kernel().router();
             instance_initialized_ = true;
         }
         return *singleton_;
     }
 
+    // Router of the global instance, cached so URL helpers skip the instance/kernel hops
+    static breeze::http::Router& router() {
+        return singleton_router_ ? *singleton_router_ : instance().kernel().router();
+    }
+
     static bool has_instance() {
         return instance_initialized_;
     }
@@ -118,11 +173,29 @@ public:
     bool is_production() const { return config_.get("app.env") == "production"; }
     bool is_local() const { return config_.get("app.env") == "local"; }
 
+    // Blade options from config/view.json (view:cache compiles with the same settings)
+    breeze::support::BladeOptions view_options() const {
+        breeze::support::BladeOptions options;
+        options.max_items = static_cast<std::size_t>(config_.get<int>("view.cache.max_items", static_cast<int>(options.max_items)));
+        options.ttl = std::chrono::seconds(config_.get<int>("view.cache.ttl_seconds", static_cast<int>(options.ttl.count())));
+        options.inline_cpp = config_.get<bool>("view.inline_cpp.enabled", options.inline_cpp);
+        options.check_interval = std::chrono::milliseconds(config_.get<int>("view.check_interval_ms", static_cast<int>(options.check_interval.count())));
+        // Production views only change with a deploy (and a restart)
+        options.immutable = config_.get<bool>("view.immutable", is_production());
+        options.compiled = config_.get<bool>("view.compiled", options.compiled);
+        options.views_path = config_.get<std::string>("view.path", options.views_path.string());
+        options.autoescape = config_.get<bool>("view.autoescape", options.autoescape);
+        options.fragment_cache_items = static_cast<std::size_t>(
+            config_.get<int>("view.fragment_cache.max_items", static_cast<int>(options.fragment_cache_items)));
+        return options;
+    }
+
     void finalize_routing();
 
 private:
     static inline bool instance_initialized_ = false;
     static inline std::shared_ptr<Application> singleton_ = nullptr;
+    static inline breeze::http::Router* singleton_router_ = nullptr;
     void bootstrap() {
         // Load .env file
         breeze::support::Env::load(".env");
@@ -151,6 +224,46 @@ private:
             
         if (!config_.has("app.url") || !breeze::support::Env::get("APP_URL").empty())
             config_.set("app.url", breeze::support::Env::get("APP_URL", config_.get("app.url", "http://localhost:8080")));
+
+        configure_logging();
+        configure_tracing();
+        configure_metrics();
+        configure_views();
+    }
+
+    void configure_logging() {
+        breeze::support::AccessLogOptions options;
+        options.enabled = config_.get<bool>("logging.access.enabled", options.enabled);
+        options.directory = config_.get("logging.access.directory", options.directory.string());
+        options.file_name = config_.get("logging.access.file", options.file_name);
+        options.json = config_.get("logging.access.format", std::string("text")) == "json";
+        options.console = config_.get<bool>("logging.access.console", options.console);
+        options.sample_every = static_cast<unsigned>(config_.get<int>("logging.access.sample_every", 1));
+        options.max_file_bytes = static_cast<size_t>(config_.get<double>("logging.access.max_file_bytes", static_cast<double>(options.max_file_bytes)));
+        options.max_files = static_cast<unsigned>(config_.get<int>("logging.access.max_files", static_cast<int>(options.max_files)));
+
+        std::string level = config_.get("logging.access.level", std::string("info"));
+        if (level == "warning") options.min_level = breeze::support::LogLevel::Warning;
+        else if (level == "error") options.min_level = breeze::support::LogLevel::Error;
+
+        breeze::support::AccessLog::instance().configure(std::move(options));
+    }
+
+    void configure_tracing() {
+        breeze::support::TraceOptions options;
+        options.enabled = config_.get<bool>("tracing.enabled", options.enabled);
+        options.server_timing = config_.get<bool>("tracing.server_timing", options.server_timing);
+        options.slow_threshold = std::chrono::milliseconds(config_.get<int>("tracing.slow_ms", 250));
+        options.export_path = config_.get("tracing.export", options.export_path.string());
+        breeze::support::Tracer::instance().configure(std::move(options));
+    }
+
+    void configure_metrics() {
+        breeze::support::Metrics::instance().set_allocation_header(config_.get<bool>("metrics.allocation_header", false));
+    }
+
+    void configure_views() {
+        breeze::support::Blade::configure(view_options());
     }
     
     Container container_;
@@ -3,6 +3,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace breeze::core {
@@ -21,6 +22,33 @@ public:
     virtual std::string description() const = 0;
     virtual std::vector<Option> options() const { return {}; }
     virtual int handle(const std::unordered_map<std::string, std::string>& options) = 0;
+
+    // Parse `--name=value`, `--name value` and bare `--flag` arguments. A bare flag means
+    // "true" and is only accepted for boolean options (default "true" or "false"), so a
+    // numeric option given without a value is an error rather than the string "true".
+    std::unordered_map<std::string, std::string> parse_arguments(const std::vector<std::string>& args) const {
+        auto declared = options();
+        std::unordered_map<std::string, std::string> parsed;
+        for (size_t i = 0; i < args.size(); ++i) {
+            const auto& arg = args[i];
+            if (arg.substr(0, 2) != "--") continue;
+            auto eq_pos = arg.find('=');
+            if (eq_pos != std::string::npos) {
+                parsed[arg.substr(2, eq_pos - 2)] = arg.substr(eq_pos + 1);
+            } else if (i + 1 < args.size() && args[i + 1][0] != '-') {
+                parsed[arg.substr(2)] = args[++i];
+            } else {
+                auto key = arg.substr(2);
+                for (const auto& option : declared) {
+                    if (option.name == key && option.default_value != "true" && option.default_value != "false") {
+                        throw std::invalid_argument("Option --" + key + " requires a value");
+                    }
+                }
+                parsed[key] = "true";
+            }
+        }
+        return parsed;
+    }
 };
 
 class CommandRegistry {
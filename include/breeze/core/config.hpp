@@ -61,6 +61,11 @@ public:
     
     // Array access for nested config (e.g., "database.connections.mysql.host")
     std::string get(const std::string& key, std::string fallback = {}) const {
+        // Values are stored flattened ("logging.access.format"), so try the full key first
+        if (auto it = values_.find(key); it != values_.end()) {
+            return it->second;
+        }
+
         auto parts = split_key(key);
         const auto* current_map = &values_;
         
@@ -147,6 +152,8 @@ private:
                 }
             }
             values_[current_key] = array_str;
+        } else if (json.is_string()) {
+            values_[current_key] = json.get<std::string>();
         } else {
             values_[current_key] = json.dump();
         }
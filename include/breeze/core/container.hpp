@@ -1,8 +1,14 @@
 // include/breeze/core/container.hpp
 #pragma once
+#include <breeze/core/request_scope.hpp>
+#include <breeze/support/tracing.hpp>
+#include <algorithm>
 #include <any>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <typeindex>
@@ -15,89 +21,187 @@ namespace breeze::core {
 
 class Container {
 public:
+    // Dense integer id for a type, assigned the first time the type is seen by any
+    // container. Used as the index into the frozen lookup table.
+    template <class T>
+    static size_t type_id() {
+        static const size_t id = next_type_id_.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
     // Basic binding
     template <class T>
     void bind(std::function<std::shared_ptr<T>()> factory) {
-        auto key = std::type_index(typeid(T));
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = type_id<T>();
+        ensure_mutable(key);
         bindings_[key] = [factory]() -> std::shared_ptr<void> {
             return std::static_pointer_cast<void>(factory());
         };
     }
-    
-    // Singleton binding
+
+    // Singleton binding (the factory runs on first resolution)
     template <class T>
     void singleton(std::function<std::shared_ptr<T>()> factory) {
-        auto key = std::type_index(typeid(T));
-        auto instance = factory();
-        singletons_[key] = std::static_pointer_cast<void>(instance);
-        singleton_factories_[key] = [instance]() {
-            return std::static_pointer_cast<void>(instance);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = type_id<T>();
+        ensure_mutable(key);
+        singletons_.erase(key);
+        auto lazy = std::make_shared<LazySingleton>();
+        lazy->factory = [factory]() -> std::shared_ptr<void> {
+            return std::static_pointer_cast<void>(factory());
         };
+        singleton_factories_[key] = std::move(lazy);
     }
-    
+
     // Instance singleton
     template <class T>
     void singleton(std::shared_ptr<T> instance) {
-        auto key = std::type_index(typeid(T));
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = type_id<T>();
+        ensure_mutable(key);
         singletons_[key] = std::static_pointer_cast<void>(instance);
     }
-    
+
+    // Scoped binding: one instance per request, created in the request arena
+    template <class T>
+    void scoped(std::function<std::shared_ptr<T>(RequestScope&)> factory) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = type_id<T>();
+        ensure_mutable(key);
+        scoped_factories_[key] = [factory](RequestScope& scope) -> std::shared_ptr<void> {
+            return std::static_pointer_cast<void>(factory(scope));
+        };
+    }
+
+    template <class T>
+    void scoped() {
+        scoped<T>([](RequestScope& scope) { return scope.create<T>(); });
+    }
+
+    // Register a loader (typically a deferred service provider) that registers the
+    // given types. It runs once, the first time any of them is resolved, and may
+    // register those types (and only those) even after freeze().
+    void defer(const std::vector<size_t>& type_ids, std::function<void()> loader) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto key : type_ids) ensure_mutable(key);
+        auto deferred = std::make_shared<Deferred>();
+        deferred->load = std::move(loader);
+        deferred->type_ids = type_ids;
+        for (auto key : type_ids) deferred_[key] = deferred;
+    }
+
     // Make with auto-wiring (simplified)
     template <class T>
     std::shared_ptr<T> make() {
-        auto key = std::type_index(typeid(T));
-        
-        // Check singleton cache
-        auto singleton_it = singletons_.find(key);
-        if (singleton_it != singletons_.end()) {
-            return std::static_pointer_cast<T>(singleton_it->second);
-        }
-        
-        // Check singleton factory
-        auto singleton_factory_it = singleton_factories_.find(key);
-        if (singleton_factory_it != singleton_factories_.end()) {
-            auto instance = std::static_pointer_cast<T>(singleton_factory_it->second());
-            singletons_[key] = instance; // Cache it
-            return instance;
-        }
-        
-        // Check regular factory
-        auto factory_it = bindings_.find(key);
-        if (factory_it != bindings_.end()) {
-            return std::static_pointer_cast<T>(factory_it->second());
+        // Only traced requests pay for the span (and the type name lookup)
+        std::optional<breeze::support::Span> span;
+        if (breeze::support::Trace::current()) span.emplace("container", typeid(T).name());
+        auto key = type_id<T>();
+
+        if (frozen_.load(std::memory_order_acquire)) {
+            // Frozen: one indexed load; only lazy singletons and deferred loads synchronise
+            if (key < frozen_table_.size()) {
+                return resolve_frozen<T>(key, frozen_table_[key]);
+            }
+            return auto_resolve<T>();
         }
-        
-        // Auto-resolve with default constructor
-        if constexpr (std::is_constructible_v<T>) {
-            auto instance = std::make_shared<T>();
-            return instance;
-        } else {
-            throw std::runtime_error("Cannot resolve type: " + std::string(typeid(T).name()));
+
+        for (bool loaded = false;; loaded = true) {
+            std::function<std::shared_ptr<void>()> factory;
+            std::shared_ptr<LazySingleton> lazy;
+            RequestScope::Factory scoped_factory;
+            std::shared_ptr<Deferred> deferred;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                // Check singleton cache
+                auto singleton_it = singletons_.find(key);
+                if (singleton_it != singletons_.end()) {
+                    return std::static_pointer_cast<T>(singleton_it->second);
+                }
+
+                // Check singleton factory, then regular factory
+                if (auto it = singleton_factories_.find(key); it != singleton_factories_.end()) {
+                    lazy = it->second;
+                } else if (auto it = bindings_.find(key); it != bindings_.end()) {
+                    factory = it->second;
+                } else if (auto it = scoped_factories_.find(key); it != scoped_factories_.end()) {
+                    scoped_factory = it->second;
+                } else if (auto it = deferred_.find(key); !loaded && it != deferred_.end()) {
+                    deferred = it->second;
+                }
+            }
+
+            if (scoped_factory) {
+                return std::static_pointer_cast<T>(current_scope().resolve(key, scoped_factory));
+            }
+
+            // Factories run unlocked so they may resolve their own dependencies
+            if (lazy) {
+                return std::static_pointer_cast<T>(lazy->get());
+            }
+            if (factory) {
+                return std::static_pointer_cast<T>(factory());
+            }
+
+            if (!deferred) {
+                return auto_resolve<T>();
+            }
+            // Register the deferred provider, then look the type up again
+            load_deferred(*deferred);
         }
     }
-    
+
     // Make with parameters
     template <class T, typename... Args>
     std::shared_ptr<T> make_with(Args&&... args) {
         return std::make_shared<T>(std::forward<Args>(args)...);
     }
-    
+
     // Check if can make
     template <class T>
     bool can_make() const {
-        auto key = std::type_index(typeid(T));
-        return bindings_.contains(key) || 
-               singletons_.contains(key) ||
-               singleton_factories_.contains(key) ||
-               std::is_constructible_v<T>;
+        auto key = type_id<T>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return singletons_.contains(key) || singleton_factories_.contains(key) ||
+               bindings_.contains(key) || scoped_factories_.contains(key) ||
+               deferred_.contains(key) || std::is_constructible_v<T>;
+    }
+
+    // Build an immutable lookup table indexed by type_id(). After this, make<T>() is
+    // safe to call concurrently and registering new bindings throws (except from
+    // deferred loaders, for the types they declared).
+    void freeze() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (frozen_.load(std::memory_order_relaxed)) return;
+
+        size_t size = 0;
+        auto grow = [&size](const auto& map) {
+            for (const auto& [key, _] : map) size = std::max(size, key + 1);
+        };
+        grow(bindings_);
+        grow(singleton_factories_);
+        grow(singletons_);
+        grow(scoped_factories_);
+        grow(deferred_);
+
+        frozen_table_.clear();
+        frozen_table_.resize(size);
+        for (size_t key = 0; key < size; ++key) {
+            frozen_table_[key] = snapshot_entry(key, true);
+        }
+        frozen_.store(true, std::memory_order_release);
     }
-    
+
+    bool frozen() const { return frozen_.load(std::memory_order_acquire); }
+
     // Tagging system (for collecting services)
     template <class T, class Tag>
     void tag(std::shared_ptr<T> instance) {
         tagged_services_[typeid(Tag).hash_code()].push_back(instance);
     }
-    
+
     template <class Tag>
     std::vector<std::shared_ptr<void>> tagged() {
         auto it = tagged_services_.find(typeid(Tag).hash_code());
@@ -106,34 +210,190 @@ public:
         }
         return {};
     }
-    
+
     // Instance access (alternative to make for already created instances)
     template <class T>
     std::shared_ptr<T> instance() {
-        auto key = std::type_index(typeid(T));
-        auto it = singletons_.find(key);
-        if (it != singletons_.end()) {
-            return std::static_pointer_cast<T>(it->second);
+        if (has<T>()) {
+            return make<T>();
         }
         throw std::runtime_error("No singleton instance registered for type");
     }
-    
+
     // Check if has instance
     template <class T>
     bool has() const {
-        auto key = std::type_index(typeid(T));
+        auto key = type_id<T>();
+        std::lock_guard<std::mutex> lock(mutex_);
         return singletons_.contains(key) || singleton_factories_.contains(key);
     }
 
 private:
-    std::unordered_map<std::type_index, 
+    // Lazy singleton: the factory runs exactly once, on first resolution, before or after freeze()
+    struct LazySingleton {
+        std::once_flag once;
+        std::function<std::shared_ptr<void>()> factory;
+        std::shared_ptr<void> instance;
+
+        std::shared_ptr<void> get() {
+            std::call_once(once, [this] { instance = factory(); });
+            return instance;
+        }
+    };
+
+    struct Deferred {
+        std::once_flag once;
+        std::function<void()> load;
+        std::vector<size_t> type_ids;   // The only types the loader may register after freeze()
+    };
+
+    struct FrozenEntry {
+        struct Loaded {
+            std::atomic<const FrozenEntry*> entry{nullptr};
+            std::unique_ptr<FrozenEntry> owned;    // Written once under mutex_
+        };
+        enum class Kind : unsigned char { None, Instance, Singleton, Binding, Scoped, Deferred };
+        Kind kind = Kind::None;
+        std::shared_ptr<void> instance;
+        std::function<std::shared_ptr<void>()> factory;
+        std::shared_ptr<LazySingleton> lazy;
+        RequestScope::Factory scoped_factory;
+        std::shared_ptr<Deferred> deferred;
+        std::unique_ptr<Loaded> loaded;            // Deferred: entry after the provider loaded
+    };
+
+    template <class T>
+    std::shared_ptr<T> resolve_frozen(size_t key, const FrozenEntry& entry) {
+        switch (entry.kind) {
+            case FrozenEntry::Kind::Instance:
+                return std::static_pointer_cast<T>(entry.instance);
+            case FrozenEntry::Kind::Singleton:
+                return std::static_pointer_cast<T>(entry.lazy->get());
+            case FrozenEntry::Kind::Binding:
+                return std::static_pointer_cast<T>(entry.factory());
+            case FrozenEntry::Kind::Scoped:
+                return std::static_pointer_cast<T>(current_scope().resolve(key, entry.scoped_factory));
+            case FrozenEntry::Kind::Deferred: {
+                if (auto* loaded = entry.loaded->entry.load(std::memory_order_acquire)) {
+                    return resolve_frozen<T>(key, *loaded);
+                }
+                // Only the provider's once guards the load; a per-type lock taken first would
+                // deadlock against a thread loading the same provider through another type
+                bool reentrant = load_deferred(*entry.deferred);
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (reentrant) {
+                    // The provider is still loading on this thread: resolve, but do not cache yet
+                    auto current = snapshot_entry(key, false);
+                    lock.unlock();
+                    return resolve_frozen<T>(key, current);
+                }
+                if (!entry.loaded->owned) {
+                    entry.loaded->owned = std::make_unique<FrozenEntry>(snapshot_entry(key, false));
+                    entry.loaded->entry.store(entry.loaded->owned.get(), std::memory_order_release);
+                }
+                const FrozenEntry* loaded = entry.loaded->owned.get();
+                lock.unlock();
+                return resolve_frozen<T>(key, *loaded);
+            }
+            case FrozenEntry::Kind::None:
+                break;
+        }
+        return auto_resolve<T>();
+    }
+
+    // Frozen-table entry for a type from the registration maps (mutex_ must be held)
+    FrozenEntry snapshot_entry(size_t key, bool include_deferred) const {
+        FrozenEntry entry;
+        if (auto it = singletons_.find(key); it != singletons_.end()) {
+            entry.kind = FrozenEntry::Kind::Instance;
+            entry.instance = it->second;
+        } else if (auto it = singleton_factories_.find(key); it != singleton_factories_.end()) {
+            entry.kind = FrozenEntry::Kind::Singleton;
+            entry.lazy = it->second;
+        } else if (auto it = bindings_.find(key); it != bindings_.end()) {
+            entry.kind = FrozenEntry::Kind::Binding;
+            entry.factory = it->second;
+        } else if (auto it = scoped_factories_.find(key); it != scoped_factories_.end()) {
+            entry.kind = FrozenEntry::Kind::Scoped;
+            entry.scoped_factory = it->second;
+        } else if (auto it = deferred_.find(key); include_deferred && it != deferred_.end()) {
+            entry.kind = FrozenEntry::Kind::Deferred;
+            entry.deferred = it->second;
+            entry.loaded = std::make_unique<FrozenEntry::Loaded>();
+        }
+        return entry;
+    }
+
+    // Runs the loader once; returns true if it is already running on this thread
+    static bool load_deferred(Deferred& deferred) {
+        // A loader resolving its own types (e.g. from boot()) would re-enter its call_once and
+        // deadlock; its registrations are already in place, so resolve them directly
+        if (std::find(loading_.begin(), loading_.end(), &deferred) != loading_.end()) return true;
+        std::call_once(deferred.once, [&deferred] {
+            loading_.push_back(&deferred);
+            try {
+                deferred.load();
+            } catch (...) {
+                loading_.pop_back();
+                throw;
+            }
+            loading_.pop_back();
+        });
+        return false;
+    }
+
+    template <class T>
+    static std::shared_ptr<T> auto_resolve() {
+        // Auto-resolve with default constructor
+        if constexpr (std::is_constructible_v<T>) {
+            return std::make_shared<T>();
+        } else {
+            throw std::runtime_error("Cannot resolve type: " + std::string(typeid(T).name()));
+        }
+    }
+
+    static RequestScope& current_scope() {
+        auto* scope = RequestScope::current();
+        if (!scope) {
+            throw std::runtime_error("Scoped service resolved outside of a request scope");
+        }
+        return *scope;
+    }
+
+    // After freeze() only a running deferred loader may register, and only the types it declared:
+    // anything else never reaches frozen_table_, so make<T>() would silently auto-resolve it
+    void ensure_mutable(size_t key) const {
+        if (!frozen_.load(std::memory_order_relaxed)) return;
+        if (loading_.empty()) {
+            throw std::logic_error("Container is frozen; register bindings before the application boots");
+        }
+        const auto& declared = loading_.back()->type_ids;
+        if (std::find(declared.begin(), declared.end(), key) == declared.end()) {
+            throw std::logic_error("Deferred provider registered a type missing from its provides()");
+        }
+    }
+
+    static inline std::atomic<size_t> next_type_id_{0};
+    // Deferred loaders running on this thread, outermost first (registration allowed after freeze)
+    static inline thread_local std::vector<const Deferred*> loading_;
+
+    std::unordered_map<size_t,
         std::function<std::shared_ptr<void>()>> bindings_;
-    std::unordered_map<std::type_index, 
-        std::function<std::shared_ptr<void>()>> singleton_factories_;
-    std::unordered_map<std::type_index, 
+    std::unordered_map<size_t,
+        std::shared_ptr<LazySingleton>> singleton_factories_;
+    std::unordered_map<size_t,
         std::shared_ptr<void>> singletons_;
-    std::unordered_map<size_t, 
+    std::unordered_map<size_t,
+        RequestScope::Factory> scoped_factories_;
+    std::unordered_map<size_t,
+        std::shared_ptr<Deferred>> deferred_;
+    std::unordered_map<size_t,
         std::vector<std::shared_ptr<void>>> tagged_services_;
+
+    // Guards the maps above; after freeze() make<T>() only reads frozen_table_
+    mutable std::mutex mutex_;
+    std::atomic<bool> frozen_{false};
+    std::vector<FrozenEntry> frozen_table_;
 };
 
-} // namespace breeze::core
\ No newline at end of file
+} // namespace breeze::core
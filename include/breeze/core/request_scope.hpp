@@ -0,0 +1,78 @@
+// include/breeze/core/request_scope.hpp
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace breeze::core {
+
+// Lifetime of one request's scoped services. The server opens a scope around each request,
+// kept open until a streamed body has been written, and Kernel::handle joins it (or opens
+// one when it is driven directly); Container::make<T>() resolves scoped bindings against the
+// innermost scope active on the calling thread. Instances are allocated from a per-request
+// arena and destroyed together (in reverse creation order) when the scope closes, so scoped
+// instances must not be kept beyond the request that created them; debug builds assert it.
+class RequestScope {
+public:
+    using Factory = std::function<std::shared_ptr<void>(RequestScope&)>;
+
+    RequestScope() : arena_(buffer_.data(), buffer_.size()), instances_(&arena_), previous_(current_) {
+        current_ = this;
+    }
+
+    ~RequestScope() {
+        for (auto& fn : deferred_) fn();
+        // The arena is released next: an instance still referenced elsewhere would dangle
+        std::pmr::vector<std::weak_ptr<void>> released(&arena_);
+        for (const auto& entry : instances_) released.emplace_back(entry.second);
+        while (!instances_.empty()) instances_.pop_back();
+        for ([[maybe_unused]] const auto& instance : released) {
+            assert(instance.expired() && "scoped service kept beyond its request");
+        }
+        current_ = previous_;
+    }
+
+    RequestScope(const RequestScope&) = delete;
+    RequestScope& operator=(const RequestScope&) = delete;
+
+    // Innermost scope open on this thread, or nullptr outside of a request
+    static RequestScope* current() { return current_; }
+
+    // Allocate an object (and its shared_ptr control block) from the request arena
+    template <class T, class... Args>
+    std::shared_ptr<T> create(Args&&... args) {
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(&arena_), std::forward<Args>(args)...);
+    }
+
+    // Instance for the service registered under `key`, created on first use in this scope
+    std::shared_ptr<void> resolve(size_t key, const Factory& factory) {
+        for (const auto& [k, instance] : instances_) {
+            if (k == key) return instance;
+        }
+        auto instance = factory(*this);
+        instances_.emplace_back(key, instance);
+        return instance;
+    }
+
+    // Run `fn` when the scope closes, before its instances are destroyed
+    void defer(std::function<void()> fn) { deferred_.push_back(std::move(fn)); }
+
+    std::pmr::memory_resource* arena() { return &arena_; }
+
+private:
+    // Most requests fit their scoped services in this inline buffer
+    std::array<std::byte, 2048> buffer_;
+    std::pmr::monotonic_buffer_resource arena_;
+    std::pmr::vector<std::pair<size_t, std::shared_ptr<void>>> instances_;
+    std::vector<std::function<void()>> deferred_;
+    RequestScope* previous_;
+
+    static inline thread_local RequestScope* current_ = nullptr;
+};
+
+} // namespace breeze::core
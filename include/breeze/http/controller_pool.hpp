@@ -0,0 +1,104 @@
+// include/breeze/http/controller_pool.hpp
+#pragma once
+#include <breeze/core/container.hpp>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace breeze::http {
+
+// How the router obtains a controller instance for each request
+enum class ControllerLifetime {
+    Transient,      // container_->make<T>() on every request (default)
+    Singleton,      // resolved once, shared by all requests and threads
+    Pooled,         // borrowed from a pool for the duration of a request, then reset and recycled
+    PooledKeepState // like Pooled, but never reset: later requests see what earlier ones left
+};
+
+// Per-controller-type resolution state. Routes capture a pointer to their slot at
+// registration time so the request path never looks the controller type up again.
+template<typename T>
+struct ControllerSlot {
+    ControllerLifetime lifetime = ControllerLifetime::Transient;
+    size_t max_pooled = 64;
+
+    std::once_flag singleton_once;
+    std::shared_ptr<T> singleton;
+
+    std::mutex pool_mutex;
+    std::vector<std::shared_ptr<T>> pool;
+
+    void release(std::shared_ptr<T> instance) {
+        // Stateful controllers can opt into being cleaned before reuse (PooledKeepState keeps its state)
+        if constexpr (requires(T& t) { t.reset(); }) {
+            if (lifetime == ControllerLifetime::Pooled) instance->reset();
+        }
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (pool.size() < max_pooled) pool.push_back(std::move(instance));
+    }
+};
+
+// Controller borrowed for one request; pooled instances go back to their slot on destruction
+template<typename T>
+class ControllerLease {
+public:
+    ControllerLease() = default;
+    ControllerLease(std::shared_ptr<T> instance, ControllerSlot<T>* pool_slot)
+        : instance_(std::move(instance)), pool_slot_(pool_slot) {}
+
+    ControllerLease(ControllerLease&& other) noexcept
+        : instance_(std::move(other.instance_)), pool_slot_(std::exchange(other.pool_slot_, nullptr)) {}
+    ControllerLease& operator=(ControllerLease&&) = delete;
+    ControllerLease(const ControllerLease&) = delete;
+    ControllerLease& operator=(const ControllerLease&) = delete;
+
+    ~ControllerLease() {
+        if (pool_slot_ && instance_) pool_slot_->release(std::move(instance_));
+    }
+
+    T* get() const { return instance_.get(); }
+    T* operator->() const { return instance_.get(); }
+    explicit operator bool() const { return static_cast<bool>(instance_); }
+
+    // Detach the instance (used by type-erased string routes that recycle explicitly)
+    std::shared_ptr<T> release() {
+        pool_slot_ = nullptr;
+        return std::move(instance_);
+    }
+
+private:
+    std::shared_ptr<T> instance_;
+    ControllerSlot<T>* pool_slot_ = nullptr;
+};
+
+// Resolve a controller for the current request according to the slot's lifetime
+template<typename T>
+ControllerLease<T> acquire_controller(ControllerSlot<T>& slot, breeze::core::Container& container) {
+    switch (slot.lifetime) {
+        case ControllerLifetime::Singleton: {
+            std::call_once(slot.singleton_once, [&] { slot.singleton = container.template make<T>(); });
+            return {slot.singleton, nullptr};
+        }
+        // No per-thread lifetime: the server runs each connection on a fresh thread, so
+        // thread_local instances would never be reused
+        case ControllerLifetime::Pooled:
+        case ControllerLifetime::PooledKeepState: {
+            {
+                std::lock_guard<std::mutex> lock(slot.pool_mutex);
+                if (!slot.pool.empty()) {
+                    auto instance = std::move(slot.pool.back());
+                    slot.pool.pop_back();
+                    return {std::move(instance), &slot};
+                }
+            }
+            return {container.template make<T>(), &slot};
+        }
+        case ControllerLifetime::Transient:
+            break;
+    }
+    return {container.template make<T>(), nullptr};
+}
+
+} // namespace breeze::http
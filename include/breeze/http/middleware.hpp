@@ -2,12 +2,59 @@
 
 #include <breeze/http/request.hpp>
 #include <breeze/http/response.hpp>
+#include <breeze/support/tracing.hpp>
 
+#include <cstddef>
 #include <functional>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace breeze::http {
 
+// Middleware chain composed at compile time. Each middleware is a callable invoked as
+// `mw(request, next)`, where `next` is a concrete callable type (take it as `auto&&`),
+// so the whole chain inlines without std::function or per-request allocation:
+//
+//   auto stack = make_static_pipeline(
+//       [](const Request& req, auto&& next) { return next(req); },
+//       [](const Request& req, auto&& next) {
+//           auto res = next(req);
+//           res.set_header("X-Content-Type-Options", "nosniff");
+//           return res;
+//       });
+//   stack.run(req, [](const Request& r) { return Response::ok(); });
+template<typename... Middlewares>
+class StaticPipeline {
+public:
+    StaticPipeline() = default;
+    explicit StaticPipeline(Middlewares... middlewares) : middlewares_(std::move(middlewares)...) {}
+
+    template<typename Last>
+    Response run(const Request& request, Last&& last) const {
+        return invoke<0>(request, last);
+    }
+
+private:
+    template<std::size_t I, typename Last>
+    Response invoke(const Request& request, Last& last) const {
+        if constexpr (I == sizeof...(Middlewares)) {
+            return last(request);
+        } else {
+            return std::get<I>(middlewares_)(request, [this, &last](const Request& req) {
+                return invoke<I + 1>(req, last);
+            });
+        }
+    }
+
+    std::tuple<Middlewares...> middlewares_;
+};
+
+template<typename... Middlewares>
+StaticPipeline<Middlewares...> make_static_pipeline(Middlewares... middlewares) {
+    return StaticPipeline<Middlewares...>(std::move(middlewares)...);
+}
+
 class MiddlewarePipeline {
 public:
     using Next = std::function<Response(const Request&)>;
@@ -15,20 +62,54 @@ public:
 
     void add(Middleware mw) { middlewares_.push_back(std::move(mw)); }
 
+    // Install a compile-time composed stage that runs before the middleware added with
+    // add(). The static chain costs a single indirect call, however long it is; calling
+    // compose() again appends a further stage (one more indirect call) after the first.
+    template<typename... Middlewares>
+    void compose(Middlewares... middlewares) {
+        auto pipeline = make_static_pipeline(std::move(middlewares)...);
+        if (!static_stage_) {
+            static_stage_ = [pipeline = std::move(pipeline)](const Request& req, const Next& next) {
+                return pipeline.run(req, next);
+            };
+            return;
+        }
+        static_stage_ = [previous = std::move(static_stage_), pipeline = std::move(pipeline)](
+                            const Request& req, const Next& next) {
+            return previous(req, [&pipeline, &next](const Request& r) { return pipeline.run(r, next); });
+        };
+    }
+
     Response run(const Request& request, Next last) const
     {
-        Next next = std::move(last);
-        for (auto it = middlewares_.rbegin(); it != middlewares_.rend(); ++it) {
-            Middleware mw = *it;
-            Next prev = std::move(next);
-            next = [mw = std::move(mw), prev = std::move(prev)](const Request& req) {
-                return mw(req, prev);
-            };
+        breeze::support::Span span("middleware");
+        if (static_stage_) {
+            return static_stage_(request, [this, &last](const Request& req) {
+                return run_from(0, req, last);
+            });
         }
-        return next(request);
+        return run_from(0, request, last);
     }
 
 private:
+    // Walk the dynamic middleware by index. Each `next` only captures a pointer to a
+    // stack cursor, which fits std::function's small buffer, so nothing is heap allocated.
+    Response run_from(std::size_t index, const Request& request, const Next& last) const
+    {
+        if (index == middlewares_.size()) {
+            return last(request);
+        }
+        struct Cursor {
+            const MiddlewarePipeline* pipeline;
+            std::size_t next;
+            const Next* last;
+        } cursor{this, index + 1, &last};
+        return middlewares_[index](request, [c = &cursor](const Request& req) {
+            return c->pipeline->run_from(c->next, req, *c->last);
+        });
+    }
+
+    std::function<Response(const Request&, const Next&)> static_stage_;
     std::vector<Middleware> middlewares_;
 };
 
@@ -20,7 +20,9 @@ public:
     const std::string& body() const { return body_; }
     const std::string& query_string() const { return query_string_; }
     
-    // Headers
+    // Headers (names are stored lowercased)
+    const std::unordered_map<std::string, std::string>& headers() const { return headers_; }
+
     void set_header(std::string name, std::string value) { 
         std::transform(name.begin(), name.end(), name.begin(), ::tolower);
         headers_[std::move(name)] = std::move(value); 
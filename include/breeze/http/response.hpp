@@ -1,7 +1,11 @@
 // include/breeze/http/response.hpp
 #pragma once
 #include <breeze/http/status_code.hpp>
+#include <breeze/support/tracing.hpp>
+#include <cstdio>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
@@ -123,20 +127,106 @@ public:
     // Streaming response (for large files or Server-Sent Events)
     class Stream {
     public:
-        virtual void write(const std::string& data) = 0;
+        virtual void write(std::string_view data) = 0;
         virtual void end() = 0;
         virtual ~Stream() = default;
     };
-    
+
+    // Produces the body while the response is being sent
+    using BodyWriter = std::function<void(Stream&)>;
+
+    // A response whose body is generated as it is written. Sockets receive it with
+    // Transfer-Encoding: chunked, one chunk per Stream::write; to_string() buffers it.
+    // Middleware sees an empty body() for streamed responses.
+    static Response stream(BodyWriter writer, const std::string& content_type = "text/html") {
+        Response res{StatusCode::OK};
+        res.content_type(content_type);
+        res.writer_ = std::move(writer);
+        return res;
+    }
+
+    // A view rendered in chunks of about `chunk_size` bytes while it is sent, so the first
+    // bytes leave before the page is finished and the whole page is never held in memory
+    static Response view_stream(const std::string& template_name, nlohmann::json data = {},
+                                std::size_t chunk_size = 16 * 1024);
+
+    bool streamed() const { return static_cast<bool>(writer_); }
+
     inline std::string to_string() const;
 
+    // Serialize through `out`: buffered responses in one piece, streamed ones chunk by chunk
+    inline void write_to(const std::function<void(std::string_view)>& out) const;
+
 private:
+    inline std::string head(const std::string* content_length) const;
+
     StatusCode status_ = StatusCode::OK;
     std::string body_;
     std::unordered_map<std::string, std::string> headers_;
+    BodyWriter writer_;
 };
 
 inline std::string Response::to_string() const {
+    if (streamed()) {
+        struct Collect : Stream {
+            std::string body;
+            void write(std::string_view data) override { body.append(data); }
+            void end() override {}
+        } collect;
+        try {
+            writer_(collect);
+        } catch (const std::exception& e) {
+            return Response::error(e.what()).to_string();
+        }
+        breeze::support::Span span("serialize");
+        auto length = std::to_string(collect.body.size());
+        return head(&length) + collect.body;
+    }
+    breeze::support::Span span("serialize");
+    auto length = std::to_string(body_.size());
+    return head(&length) + body_;
+}
+
+inline void Response::write_to(const std::function<void(std::string_view)>& out) const {
+    if (!streamed()) {
+        out(to_string());
+        return;
+    }
+    struct Chunked : Stream {
+        const std::function<void(std::string_view)>& out;
+        std::string frame;   // one write per chunk: size line, data, CRLF
+        bool ended = false;
+        explicit Chunked(const std::function<void(std::string_view)>& o) : out(o) {}
+        void write(std::string_view data) override {
+            if (data.empty() || ended) return;  // an empty chunk would terminate the body
+            char size[20];
+            int n = std::snprintf(size, sizeof(size), "%zx\r\n", data.size());
+            frame.assign(size, static_cast<std::size_t>(n));
+            frame.append(data);
+            frame.append("\r\n");
+            out(frame);
+        }
+        void end() override {
+            if (!ended) out("0\r\n\r\n");
+            ended = true;
+        }
+    } chunked(out);
+    {
+        breeze::support::Span span("serialize");
+        out(head(nullptr));
+    }
+    try {
+        writer_(chunked);
+    } catch (...) {
+        // The status line is already sent; leave the body unterminated so the client sees
+        // a truncated response rather than a complete one
+        return;
+    }
+    chunked.end();
+}
+
+// Status line and headers; a null content length means a chunked body
+inline std::string Response::head(const std::string* content_length) const {
     std::ostringstream oss;
     oss << "HTTP/1.1 " << static_cast<int>(status_);
     
@@ -152,14 +242,17 @@ inline std::string Response::to_string() const {
     if (!final_headers.contains("Content-Type")) {
         final_headers["Content-Type"] = "text/plain";
     }
-    if (!final_headers.contains("Content-Length")) {
-        final_headers["Content-Length"] = std::to_string(body_.size());
+    if (!content_length) {
+        final_headers.erase("Content-Length");
+        final_headers["Transfer-Encoding"] = "chunked";
+    } else if (!final_headers.contains("Content-Length")) {
+        final_headers["Content-Length"] = *content_length;
     }
     
     for (const auto& [k, v] : final_headers) {
         oss << k << ": " << v << "\r\n";
     }
-    oss << "\r\n" << body_;
+    oss << "\r\n";
     
     return oss.str();
 }
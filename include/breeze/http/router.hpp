@@ -4,7 +4,9 @@
 #include <breeze/http/response.hpp>
 #include <breeze/http/middleware.hpp>
 #include <breeze/http/controller.hpp>
+#include <breeze/http/controller_pool.hpp>
 #include <breeze/core/container.hpp>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <ranges>
@@ -14,6 +16,7 @@
 #include <utility>
 #include <vector>
 #include <type_traits>
+#include <typeindex>
 #include <optional>
 #include <sstream> // added for istringstream
 
@@ -23,7 +26,19 @@ class Router {
 public:
     using Handler = std::function<Response(const Request&)>;
     using Middleware = std::function<Response(const Request&, const Handler&)>;
-    
+    using RouteParams = std::unordered_map<std::string, std::string>;
+
+    Router() = default;
+    // Routes point back at their router (for the name index), so a router stays where it was built
+    Router(const Router&) = delete;
+    Router& operator=(const Router&) = delete;
+
+    // Piece of a route pattern: either literal text or the name of a {param}
+    struct UrlSegment {
+        std::string text;
+        bool is_param = false;
+    };
+
     struct Route {
         std::string method;
         std::string pattern_str;
@@ -33,6 +48,12 @@ public:
         std::string route_name;
         std::vector<Middleware> middlewares;
         std::vector<std::string> middleware_aliases;
+        // Pattern pre-split into literal runs and {param} tokens for URL generation
+        std::vector<UrlSegment> url_segments;
+        size_t url_literal_size = 0;
+        // Owning router and this route's position in its routes_, see name()
+        Router* router = nullptr;
+        size_t position = 0;
 
         [[nodiscard]] bool matches(const std::string& req_method, const std::string& path) const {
             if (this->method != req_method) return false;
@@ -81,6 +102,7 @@ public:
         }
 
         Route& name(std::string name) {
+            if (router) router->index_route_name(*this, name);
             this->route_name = std::move(name);
             return *this;
         }
@@ -105,6 +127,7 @@ public:
     // Basic routing
     Route& add_route(const std::string& method, const std::string& pattern, Handler handler) {
         auto [param_names, regex_pattern] = compile_pattern(pattern);
+        auto [url_segments, url_literal_size] = compile_url_segments(pattern);
         
         routes_.push_back({
             method,
@@ -114,7 +137,11 @@ public:
             std::move(handler),
             "", // name
             {},  // middleware
-            {}   // middleware_aliases
+            {},  // middleware_aliases
+            std::move(url_segments),
+            url_literal_size,
+            this,
+            routes_.size()
         });
         
         return routes_.back();
@@ -203,46 +230,48 @@ public:
     // Resource routing (Laravel-style)
     template<typename T>
     void resource(const std::string& prefix) {
-        get(prefix, [this](const Request& req) {
-            if (container_) return container_->template make<T>()->index(req);
-            throw std::runtime_error("Container not set in Router");
+        auto* slot = &controller_slot<T>();
+        get(prefix, [this, slot](const Request& req) {
+            return lease_controller(*slot)->index(req);
         });
         
-        get(prefix + "/{id}", [this](const Request& req) {
-            if (container_) return container_->template make<T>()->show(req);
-            throw std::runtime_error("Container not set in Router");
+        get(prefix + "/{id}", [this, slot](const Request& req) {
+            return lease_controller(*slot)->show(req);
         });
         
-        get(prefix + "/create", [this](const Request& req) {
-            if (container_) return container_->template make<T>()->create(req);
-            throw std::runtime_error("Container not set in Router");
+        get(prefix + "/create", [this, slot](const Request& req) {
+            return lease_controller(*slot)->create(req);
         });
         
-        post(prefix, [this](const Request& req) {
-            if (container_) return container_->template make<T>()->store(req);
-            throw std::runtime_error("Container not set in Router");
+        post(prefix, [this, slot](const Request& req) {
+            return lease_controller(*slot)->store(req);
         });
         
-        get(prefix + "/{id}/edit", [this](const Request& req) {
-            if (container_) return container_->template make<T>()->edit(req);
-            throw std::runtime_error("Container not set in Router");
+        get(prefix + "/{id}/edit", [this, slot](const Request& req) {
+            return lease_controller(*slot)->edit(req);
         });
         
-        put(prefix + "/{id}", [this](const Request& req) {
-            if (container_) return container_->template make<T>()->update(req);
-            throw std::runtime_error("Container not set in Router");
+        put(prefix + "/{id}", [this, slot](const Request& req) {
+            return lease_controller(*slot)->update(req);
         });
         
-        patch(prefix + "/{id}", [this](const Request& req) {
-            if (container_) return container_->template make<T>()->update(req);
-            throw std::runtime_error("Container not set in Router");
+        patch(prefix + "/{id}", [this, slot](const Request& req) {
+            return lease_controller(*slot)->update(req);
         });
         
-        delete_(prefix + "/{id}", [this](const Request& req) {
-            if (container_) return container_->template make<T>()->destroy(req);
-            throw std::runtime_error("Container not set in Router");
+        delete_(prefix + "/{id}", [this, slot](const Request& req) {
+            return lease_controller(*slot)->destroy(req);
         });
     }
+
+    // Declare how instances of a controller are obtained per request. Applies to every
+    // route using the controller, including routes registered before this call.
+    template<typename ControllerType>
+    void controller_lifetime(ControllerLifetime lifetime, size_t max_pooled = 64) {
+        auto& slot = controller_slot<ControllerType>();
+        slot.lifetime = lifetime;
+        slot.max_pooled = max_pooled;
+    }
     
     struct Attributes {
         std::string prefix;
@@ -381,12 +410,9 @@ public:
         template<typename ControllerType, typename Action>
         Route& add_controller_route(const std::string& method, const std::string& pattern, Action action) {
             // Capture a pointer to the router (long-lived) instead of 'this' (Group may be temporary)
-            return this->add_route(method, pattern, [router_ptr = &router_, action](const Request& req) {
-                if (!router_ptr->container_) {
-                    throw std::runtime_error("Container not set in Router");
-                }
-                
-                auto controller = router_ptr->container_->template make<ControllerType>();
+            auto* slot = &router_.template controller_slot<ControllerType>();
+            return this->add_route(method, pattern, [router_ptr = &router_, slot, action](const Request& req) {
+                auto controller = router_ptr->lease_controller(*slot);
                 if (!controller) {
                     return Response::error("Failed to resolve controller");
                 }
@@ -401,12 +427,9 @@ public:
 
         template<typename ControllerType, typename Action>
         Route& add_controller_route_const(const std::string& method, const std::string& pattern, Action action) {
-            return this->add_route(method, pattern, [router_ptr = &router_, action](const Request& req) {
-                if (!router_ptr->container_) {
-                    throw std::runtime_error("Container not set in Router");
-                }
-                
-                auto controller = router_ptr->container_->template make<ControllerType>();
+            auto* slot = &router_.template controller_slot<ControllerType>();
+            return this->add_route(method, pattern, [router_ptr = &router_, slot, action](const Request& req) {
+                auto controller = router_ptr->lease_controller(*slot);
                 if (!controller) {
                     return Response::error("Failed to resolve controller");
                 }
@@ -505,15 +528,13 @@ public:
         // Use a different name for the base controller route adder to avoid confusion
         template<typename ControllerType, typename Action>
         Route& add_controller_instance_route(const std::string& method, const std::string& pattern, Action action) {
-            return this->add_route(method, pattern, [router_ptr = &router_, action](const Request& req) {
-                if (router_ptr->container_) {
-                    auto controller = router_ptr->container_->template make<ControllerType>();
-                    if (!controller) {
-                         return Response::error("Failed to resolve controller");
-                    }
-                    return (controller.get()->*action)(req);
+            auto* slot = &this->router_.template controller_slot<ControllerType>();
+            return this->add_route(method, pattern, [router_ptr = &this->router_, slot, action](const Request& req) {
+                auto controller = router_ptr->lease_controller(*slot);
+                if (!controller) {
+                     return Response::error("Failed to resolve controller");
                 }
-                throw std::runtime_error("Container not set in Router");
+                return (controller.get()->*action)(req);
             });
         }
     };
@@ -534,12 +555,15 @@ public:
     
     // Dispatch request
     [[nodiscard]] Response dispatch(const Request& request) const {
+        breeze::support::Span span("dispatch");
         for (const auto& route : routes_) {
             // Skip routes that don't match method/path
             if (!route.matches(request.method(), request.path())) {
                 continue;
             }
 
+            matched_pattern_ = &route.pattern_str;
+
             // Extract path parameters
             auto params = route.extract_params(request.path());
             Request modified_request = request;
@@ -596,21 +620,65 @@ public:
         return Response::not_found();
     }
     
+    // Pattern of the route this thread last dispatched to, or nullptr if none matched
+    // since clear_matched_pattern(). Lets the kernel label metrics by route template.
+    [[nodiscard]] static const std::string* matched_pattern() { return matched_pattern_; }
+    static void clear_matched_pattern() { matched_pattern_ = nullptr; }
+
+    [[nodiscard]] bool has_route(const std::string& name) const {
+        return find_named_route(name) != nullptr;
+    }
+
     // URL generation (for named routes)
     [[nodiscard]] std::string route(const std::string& name,
-                     const std::unordered_map<std::string, std::string>& params = {}) const {
-        for (const auto& route : routes_) {
-            if (route.route_name == name) {
-                std::string path = route_to_path(route, params);
-                return path;
+                     const RouteParams& params = {}) const {
+        const Route* route = find_named_route(name);
+        if (!route) return "";
+        return route_to_path(*route, params);
+    }
+
+    // Generate several URLs at once, e.g. for a template rendering many links.
+    // Unknown route names produce an empty string at the same position.
+    [[nodiscard]] std::vector<std::string> route_batch(
+        const std::vector<std::pair<std::string, RouteParams>>& requests) const {
+        std::vector<std::string> urls;
+        urls.reserve(requests.size());
+        for (const auto& [name, params] : requests) {
+            urls.push_back(route(name, params));
+        }
+        return urls;
+    }
+
+    // Names of route parameters that `params` does not provide (empty when complete)
+    [[nodiscard]] std::vector<std::string> missing_route_params(const std::string& name,
+                                                                const RouteParams& params) const {
+        std::vector<std::string> missing;
+        if (const Route* route = find_named_route(name)) {
+            for (const auto& seg : route->url_segments) {
+                if (seg.is_param && !params.contains(seg.text)) missing.push_back(seg.text);
+            }
+        }
+        return missing;
+    }
+
+    // Like route(), but throws instead of silently dropping unknown names or missing params
+    [[nodiscard]] std::string route_or_fail(const std::string& name,
+                                            const RouteParams& params = {}) const {
+        const Route* route = find_named_route(name);
+        if (!route) {
+            throw std::runtime_error("Route not defined: " + name);
+        }
+        for (const auto& seg : route->url_segments) {
+            if (seg.is_param && !params.contains(seg.text)) {
+                throw std::runtime_error("Missing parameter '" + seg.text + "' for route: " + name);
             }
         }
-        return "";
+        return route_to_path(*route, params);
     }
 
     // alias for Laravel-like naming
     [[nodiscard]] std::string urlFor(const std::string& name,
-                     const std::unordered_map<std::string, std::string>& params = {}) const {
+                     const RouteParams& params = {}) const {
         return route(name, params);
     }
 
@@ -621,15 +689,30 @@ public:
     // Controller registry to support string-style "Controller@action" routing
     struct ControllerDescriptor {
         std::function<std::shared_ptr<breeze::http::Controller>()> factory;
+        // Hands a pooled instance back once the action has run (no-op otherwise)
+        std::function<void(std::shared_ptr<breeze::http::Controller>)> recycle;
         std::unordered_map<std::string, std::function<Response(std::shared_ptr<breeze::http::Controller>, const Request&)>> actions;
     };
 
     template<typename ControllerType>
     void register_controller(const std::string& name) {
-        controller_descriptors_[name].factory = [this]() -> std::shared_ptr<breeze::http::Controller> {
+        auto* slot = &controller_slot<ControllerType>();
+        auto& desc = controller_descriptors_[name];
+        desc.factory = [this, slot]() -> std::shared_ptr<breeze::http::Controller> {
             if (!container_) return nullptr;
-            return container_->template make<ControllerType>();
+            return acquire_controller(*slot, *container_).release();
         };
+        desc.recycle = [slot](std::shared_ptr<breeze::http::Controller> c) {
+            if (slot->lifetime == ControllerLifetime::Pooled || slot->lifetime == ControllerLifetime::PooledKeepState) {
+                slot->release(std::static_pointer_cast<ControllerType>(std::move(c)));
+            }
+        };
+    }
+
+    template<typename ControllerType>
+    void register_controller(const std::string& name, ControllerLifetime lifetime, size_t max_pooled = 64) {
+        controller_lifetime<ControllerType>(lifetime, max_pooled);
+        register_controller<ControllerType>(name);
     }
 
     template<typename ControllerType>
@@ -696,13 +779,38 @@ public:
             }
             auto ait = desc.actions.find(action);
             if (ait == desc.actions.end()) {
+                desc.recycle(std::move(inst));
                 return Response::error(std::string("Controller action not found: ") + action);
             }
-            return ait->second(inst, req);
+            try {
+                auto res = ait->second(inst, req);
+                desc.recycle(std::move(inst));
+                return res;
+            } catch (...) {
+                desc.recycle(std::move(inst));
+                throw;
+            }
         };
     }
 
 private:
+    static inline thread_local const std::string* matched_pattern_ = nullptr;
+
+    template<typename ControllerType>
+    ControllerSlot<ControllerType>& controller_slot() {
+        auto& slot = controller_slots_[std::type_index(typeid(ControllerType))];
+        if (!slot) slot = std::make_shared<ControllerSlot<ControllerType>>();
+        return *std::static_pointer_cast<ControllerSlot<ControllerType>>(slot);
+    }
+
+    template<typename ControllerType>
+    ControllerLease<ControllerType> lease_controller(ControllerSlot<ControllerType>& slot) const {
+        if (!container_) {
+            throw std::runtime_error("Container not set in Router");
+        }
+        return acquire_controller(slot, *container_);
+    }
+
     [[nodiscard]] static std::pair<std::vector<std::string>, std::string> compile_pattern(const std::string& pattern) {
         std::vector<std::string> param_names;
         std::string regex_pattern;
@@ -737,29 +845,71 @@ private:
         return {param_names, regex_pattern};
     }
     
-    [[nodiscard]] static std::string route_to_path(const Route& route,
-                                                   const std::unordered_map<std::string, std::string>& params) {
-        // Use the original pattern string and substitute {name} with provided params
-        std::string out = route.pattern_str;
+    // Split a pattern such as "/users/{id}/posts" into literal and parameter pieces once,
+    // so URL generation does not have to search and splice the pattern string.
+    [[nodiscard]] static std::pair<std::vector<UrlSegment>, size_t> compile_url_segments(const std::string& pattern) {
+        std::string normalized = pattern;
         // Ensure leading slash
-        if (out.empty() || out.front() != '/') out = "/" + out;
-
-        // Replace occurrences of {param}
-        for (const auto& [k, v] : params) {
-            std::string token = "{" + k + "}";
-            size_t pos = 0;
-            while ((pos = out.find(token, pos)) != std::string::npos) {
-                out.replace(pos, token.length(), v);
-                pos += v.length();
+        if (normalized.empty() || normalized.front() != '/') normalized = "/" + normalized;
+
+        std::vector<UrlSegment> segments;
+        size_t literal_size = 0;
+        size_t pos = 0;
+        while (pos < normalized.size()) {
+            size_t open = normalized.find('{', pos);
+            size_t close = open == std::string::npos ? std::string::npos : normalized.find('}', open);
+            if (close == std::string::npos) {
+                segments.push_back({normalized.substr(pos), false});
+                literal_size += normalized.size() - pos;
+                break;
+            }
+            if (open > pos) {
+                segments.push_back({normalized.substr(pos, open - pos), false});
+                literal_size += open - pos;
+            }
+            segments.push_back({normalized.substr(open + 1, close - open - 1), true});
+            pos = close + 1;
+        }
+        return {std::move(segments), literal_size};
+    }
+
+    // Point named_routes_ at the first registered route carrying each name, as the linear scan
+    // route() used to do: called by Route::name() before `route` takes `name`
+    void index_route_name(const Route& route, const std::string& name) {
+        if (auto it = named_routes_.find(route.route_name); it != named_routes_.end() && it->second == route.position) {
+            named_routes_.erase(it);
+            // Another route may share the old name; the first of them takes over the entry
+            for (const auto& other : routes_) {
+                if (other.position != route.position && other.route_name == route.route_name) {
+                    named_routes_.emplace(route.route_name, other.position);
+                    break;
+                }
             }
         }
+        auto [it, inserted] = named_routes_.try_emplace(name, route.position);
+        if (!inserted && route.position < it->second) it->second = route.position;
+    }
+
+    [[nodiscard]] const Route* find_named_route(const std::string& name) const {
+        auto it = named_routes_.find(name);
+        return it != named_routes_.end() ? &routes_[it->second] : nullptr;
+    }
+
+    [[nodiscard]] static std::string route_to_path(const Route& route, const RouteParams& params) {
+        // Literal text plus every supplied value is an upper bound on the URL length
+        size_t size = route.url_literal_size;
+        for (const auto& [k, v] : params) size += v.size();
 
-        // Remove any unresolved tokens (best-effort)
-        size_t open;
-        while ((open = out.find('{')) != std::string::npos) {
-            size_t close = out.find('}', open);
-            if (close == std::string::npos) break;
-            out.erase(open, close - open + 1);
+        std::string out;
+        out.reserve(size);
+        for (const auto& seg : route.url_segments) {
+            if (!seg.is_param) {
+                out += seg.text;
+                continue;
+            }
+            // Unresolved tokens are dropped (best-effort, see route_or_fail)
+            auto it = params.find(seg.text);
+            if (it != params.end()) out += it->second;
         }
 
         // Normalize trailing slash: do not force a trailing slash unless root
@@ -768,9 +918,13 @@ private:
         return out;
     }
 
-    std::vector<Route> routes_;
+    // A deque, so the Route& handed out by add_route() stays valid as more routes are added
+    std::deque<Route> routes_;
     breeze::core::Container* container_ = nullptr;
 
+    // Named route index (route name -> position in routes_), kept up to date by Route::name()
+    std::unordered_map<std::string, size_t> named_routes_;
+
     // Global middlewares applied to every route (in-order)
     std::vector<Middleware> global_middlewares_;
     std::vector<std::string> global_middleware_aliases_;
@@ -782,9 +936,12 @@ private:
     // Controller registry for string-style routing
     std::unordered_map<std::string, ControllerDescriptor> controller_descriptors_;
 
+    // Per-controller-type lifetime state (ControllerSlot<T>), see controller_lifetime()
+    std::unordered_map<std::type_index, std::shared_ptr<void>> controller_slots_;
+
     // Make Route accessible for testing
     #ifdef TESTING
-    const std::vector<Route>& get_routes() const { return routes_; }
+    const std::deque<Route>& get_routes() const { return routes_; }
     #endif
     };
 } // namespace breeze::http
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <breeze/core/request_scope.hpp>
 #include <breeze/http/request.hpp>
 #include <breeze/http/response.hpp>
+#include <breeze/http/router.hpp>
 #include <breeze/http/status_code.hpp>
+#include <breeze/support/metrics.hpp>
+#include <breeze/support/tracing.hpp>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -12,6 +16,7 @@
 #include <functional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <stdexcept>
 
@@ -61,9 +66,12 @@ public:
                 continue;
             }
 
-            // Capture client_address by value and pass it to the handler thread
+            // Capture client_address by value and pass it to the handler thread; the connection
+            // counts as active from accept until its response has been written
+            breeze::support::Metrics::instance().connection_opened();
             std::thread([this, client_fd, client_address]() mutable {
                 handle_client(client_fd, client_address);
+                breeze::support::Metrics::instance().connection_closed();
             }).detach();
         }
     }
@@ -78,26 +86,76 @@ private:
             return;
         }
 
-        std::string raw_request(buffer, bytes_read);
-        Request req = parse_request(raw_request);
+        auto& metrics = breeze::support::Metrics::instance();
+        breeze::support::Metrics::BusyScope busy(metrics);
+        metrics.add_bytes_in(static_cast<size_t>(bytes_read));
 
         // Inject remote IP into headers so middlewares/controllers can read client IP
         char ipbuf[INET_ADDRSTRLEN] = {0};
         const char* ip = inet_ntop(AF_INET, &client_address.sin_addr, ipbuf, sizeof(ipbuf));
-        if (ip) {
-            req.set_header("x-remote-addr", std::string(ip));
-        } else {
-            req.set_header("x-remote-addr", std::string("unknown"));
-        }
+        std::size_t sent_total = 0;
+        bool failed = false;
+        process(std::string(buffer, bytes_read), ip ? std::string(ip) : std::string("unknown"),
+                [client_fd, &sent_total, &failed](std::string_view bytes) {
+                    while (!failed && !bytes.empty()) {
+                        ssize_t sent = send(client_fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+                        if (sent <= 0) {
+                            failed = true;  // peer went away; drop the rest of a streamed body
+                            break;
+                        }
+                        sent_total += static_cast<size_t>(sent);
+                        bytes.remove_prefix(static_cast<size_t>(sent));
+                    }
+                });
+        if (sent_total > 0) metrics.add_bytes_out(sent_total);
+        close(client_fd);
+    }
 
+    // Parse, then run the handler for one request
+    Response dispatch(const std::string& raw_request, const std::string& remote_addr) const {
+        Request req = parse_request(raw_request);
+        req.set_header("x-remote-addr", remote_addr);
         Response res = handler_(req);
-        
-        std::string raw_response = res.to_string();
-        send(client_fd, raw_response.c_str(), raw_response.size(), 0);
-        close(client_fd);
+        // One request per connection: keep-alive clients must not reuse the socket
+        res.set_header("Connection", "close");
+        return res;
     }
 
+    static bool is_http10(const std::string& raw_request) {
+        auto line_end = raw_request.find('\n');
+        auto version = raw_request.find("HTTP/1.0");
+        return version != std::string::npos && version < line_end;
+    }
+
+public:
+    // Raw request bytes in, raw response bytes out: parse, dispatch and serialize exactly as a
+    // socket connection does. Used by the in-process TestClient; streamed bodies are buffered.
+    std::string process(const std::string& raw_request, const std::string& remote_addr) const {
+        // Own the request's scoped services and trace until the body is serialized; Kernel::handle joins them
+        breeze::core::RequestScope scope;
+        breeze::support::TraceScope trace;
+        Response res = dispatch(raw_request, remote_addr);
+        auto raw_response = res.to_string();
+        // The route stays current through serialization (profiler attribution), then resets
+        Router::clear_matched_pattern();
+        return raw_response;
+    }
+
+    // As above, but the response is handed to `write` piece by piece: streamed bodies go out
+    // chunked while they are produced (HTTP/1.0 clients get them buffered)
+    void process(const std::string& raw_request, const std::string& remote_addr,
+                 const std::function<void(std::string_view)>& write) const {
+        breeze::core::RequestScope scope;
+        breeze::support::TraceScope trace;
+        Response res = dispatch(raw_request, remote_addr);
+        if (res.streamed() && !is_http10(raw_request)) res.write_to(write);
+        else write(res.to_string());
+        Router::clear_matched_pattern();
+    }
+
+    // Parse a raw HTTP/1.1 request (exposed for benchmarks and in-process clients)
     static Request parse_request(const std::string& raw) {
+        breeze::support::Span span("parse");
         Request req;
         std::istringstream stream(raw);
         std::string line;
@@ -147,6 +205,7 @@ private:
         return req;
     }
 
+private:
     RequestHandler handler_;
 };
 
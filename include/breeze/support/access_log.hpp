@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace breeze::support {
+
+enum class LogLevel : std::uint8_t { Info, Warning, Error };
+
+struct AccessLogOptions {
+    bool enabled = true;
+    std::filesystem::path directory = "storage/logs";
+    std::string file_name = "access.log";
+    bool json = false;                       // JSON lines instead of the "[Request] ..." text format
+    bool console = false;                    // also mirror lines to stdout (from the writer thread)
+    LogLevel min_level = LogLevel::Info;
+    unsigned sample_every = 1;               // keep 1 in N records below Error level
+    std::size_t max_file_bytes = 10 * 1024 * 1024;
+    unsigned max_files = 5;                  // rotated files kept: access.log.1 .. access.log.N
+    std::chrono::milliseconds flush_interval{200};
+};
+
+// Fixed-size binary record pushed by request threads; long fields are truncated
+struct AccessRecord {
+    std::int64_t timestamp_us = 0;           // system_clock, microseconds since epoch
+    std::uint32_t duration_us = 0;
+    std::uint16_t status = 0;
+    LogLevel level = LogLevel::Info;
+    char method[8] = {};
+    char ip[48] = {};
+    char path[128] = {};
+    char note[64] = {};
+};
+
+// Asynchronous access logger. Request threads write records into their own lock-free
+// single-producer ring; one background thread drains the rings, formats lines and
+// appends them to a size-rotated file under storage/logs. When a ring is full the
+// record is dropped and counted rather than blocking the request.
+class AccessLog {
+public:
+    static AccessLog& instance();
+
+    ~AccessLog();
+
+    // (Re)configure; the writer thread starts with the first logged request, so processes
+    // that never serve one (CLI commands, tests) do not pay for it
+    void configure(AccessLogOptions options);
+
+    void log_request(std::string_view method, std::string_view path, std::string_view ip,
+                     int status, std::chrono::microseconds duration, std::string_view note = {}) noexcept;
+
+    // Drain and write everything recorded so far (used on shutdown and in tests)
+    void flush();
+    void stop();
+
+    // Whether a request has started the writer since the last configure()
+    bool running() const { return writer_started_.load(std::memory_order_acquire); }
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    std::uint64_t sampled_out() const { return sampled_out_.load(std::memory_order_relaxed); }
+
+    std::filesystem::path file_path() const;
+
+    struct Ring {
+        static constexpr std::size_t capacity = 256; // power of two
+        std::array<AccessRecord, capacity> records;
+        alignas(64) std::atomic<std::size_t> head{0}; // advanced by the owning request thread
+        alignas(64) std::atomic<std::size_t> tail{0}; // advanced by the writer thread
+        std::atomic<bool> retired{false};             // owning thread has exited
+    };
+
+private:
+    AccessLog() = default;
+
+    std::shared_ptr<Ring> acquire_ring();
+    void start_writer() noexcept;
+    void writer_loop();
+    void drain();
+    void format(const AccessRecord& record, std::string& out) const;
+    void write_out(const std::string& lines);
+    void rotate();
+
+    // Hot-path settings, readable without locking
+    std::atomic<bool> enabled_{false};
+    std::atomic<LogLevel> min_level_{LogLevel::Info};
+    std::atomic<unsigned> sample_every_{1};
+    std::atomic<bool> writer_started_{false};
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> sampled_out_{0};
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::vector<std::shared_ptr<Ring>> free_rings_;
+
+    // Everything below is owned by whoever holds drain_mutex_ (normally the writer thread)
+    std::mutex drain_mutex_;
+    AccessLogOptions options_;
+    std::FILE* file_ = nullptr;
+    std::size_t file_bytes_ = 0;
+    std::string buffer_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread writer_;
+};
+
+} // namespace breeze::support
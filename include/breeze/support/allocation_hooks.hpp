@@ -0,0 +1,98 @@
+#pragma once
+
+// Replaces the global allocation functions with versions that bump the per-thread counters
+// in <breeze/support/allocations.hpp>. This defines operator new/delete, so include it from
+// exactly one translation unit of an executable (e.g. the test runner's main file) and
+// never from the library itself.
+
+#include <breeze/support/allocations.hpp>
+
+#include <cstdlib>
+#include <new>
+
+namespace breeze::support::allocations::detail {
+
+inline void* counted_malloc(std::size_t size, std::size_t alignment) noexcept {
+    if (size == 0) size = 1;
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size);
+    } else {
+        // aligned_alloc wants a size that is a multiple of the alignment
+        p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    if (p) {
+        auto& counts = thread_counts;
+        ++counts.allocations;
+        counts.bytes += size;
+    }
+    return p;
+}
+
+inline void* counted_new(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        if (void* p = counted_malloc(size, alignment)) return p;
+        auto handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+inline void counted_free(void* p) noexcept {
+    if (!p) return;
+    ++thread_counts.deallocations;
+    std::free(p);
+}
+
+struct Installed {
+    Installed() noexcept { hooks_installed.store(true, std::memory_order_relaxed); }
+};
+inline Installed installed;
+
+} // namespace breeze::support::allocations::detail
+
+void* operator new(std::size_t size) {
+    return breeze::support::allocations::detail::counted_new(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size) {
+    return breeze::support::allocations::detail::counted_new(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t align) {
+    return breeze::support::allocations::detail::counted_new(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return breeze::support::allocations::detail::counted_new(size, static_cast<std::size_t>(align));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return breeze::support::allocations::detail::counted_malloc(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return breeze::support::allocations::detail::counted_malloc(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return breeze::support::allocations::detail::counted_malloc(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return breeze::support::allocations::detail::counted_malloc(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete[](void* p) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    breeze::support::allocations::detail::counted_free(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    breeze::support::allocations::detail::counted_free(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { breeze::support::allocations::detail::counted_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    breeze::support::allocations::detail::counted_free(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    breeze::support::allocations::detail::counted_free(p);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace breeze::support {
+
+// Heap activity of one thread. Only updated when the counting operator new/delete from
+// <breeze/support/allocation_hooks.hpp> are linked into the binary.
+struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes = 0;  // requested bytes; frees are counted but not sized
+};
+
+namespace allocations {
+
+inline thread_local AllocationCounts thread_counts;
+inline std::atomic<bool> hooks_installed{false};
+
+// True when the counting hooks replaced the global allocation functions
+inline bool available() noexcept { return hooks_installed.load(std::memory_order_relaxed); }
+
+} // namespace allocations
+
+// Counts what the current thread allocates between construction and counts()
+class AllocationScope {
+public:
+    AllocationScope() noexcept : start_(allocations::thread_counts) {}
+
+    AllocationCounts counts() const noexcept {
+        const auto& now = allocations::thread_counts;
+        return {now.allocations - start_.allocations, now.deallocations - start_.deallocations,
+                now.bytes - start_.bytes};
+    }
+
+private:
+    AllocationCounts start_;
+};
+
+} // namespace breeze::support
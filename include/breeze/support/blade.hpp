@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <string_view>
 #include <nlohmann/json.hpp>
@@ -7,17 +10,56 @@
 
 namespace breeze::support {
 
+// File template cache settings (config/view.json, applied by Application)
+struct BladeOptions {
+    std::size_t max_items = 128;
+    std::chrono::seconds ttl{300};
+    bool inline_cpp = false;
+    // A cached template is re-validated with one stat() (mtime, size, inode) at most this
+    // often; zero checks on every render
+    std::chrono::milliseconds check_interval{1000};
+    // Never re-validate: views are immutable until the process restarts (production)
+    bool immutable = false;
+    // Dispatch views built with breeze_add_views() to their generated C++; turn off to pick up
+    // template edits through the interpreter without rebuilding
+    bool compiled = true;
+    // Where @extends, @include and @component look up view names ("layouts.app")
+    std::filesystem::path views_path = "resources/views";
+    // Entries kept for @cache(key, ttl) fragments, across all views
+    std::size_t fragment_cache_items = 1024;
+    // HTML-escape every {{ }} (SIMD, so clean text costs one scan); {!! !!} prints raw
+    bool autoescape = false;
+};
+
 class Blade {
 public:
-    // Render a template string at runtime using a JSON context. Supports
-    // directives: @foreach(... as ...), @if(...), @unless(...), and {{ var }}.
+    // Render a template string at runtime using a JSON context: {{ }} / {!! !!} echoes,
+    // @if / @unless / @foreach, @extends / @section / @yield, @include, @component / @slot and
+    // @cache. See "Views and Templates" in the README for the full syntax.
     [[nodiscard]] std::string render(std::string_view tpl, const nlohmann::json& context) const;
 
-    // Render directly from a template file path. Uses a file-based cache keyed by
-    // file path + content hash with LRU eviction and optional TTL.
+    // Render directly from a template file path. Compiled programs are cached by path with
+    // LRU eviction and a TTL; edits are detected by stat() as configured in BladeOptions.
     [[nodiscard]] std::string render_from_file(const std::filesystem::path& file_path, const nlohmann::json& context) const;
 
+    // Append the output to a caller-owned buffer, which can be reused across renders
+    void render_to(std::string& out, std::string_view tpl, const nlohmann::json& context) const;
+    void render_from_file_to(std::string& out, const std::filesystem::path& file_path, const nlohmann::json& context) const;
+
+    // Render in pieces: `sink` is called each time about `chunk_size` bytes are ready and once
+    // with the remainder, so peak memory is one chunk rather than the whole page
+    using ChunkSink = std::function<void(std::string_view)>;
+    void stream_from_file(const std::filesystem::path& file_path, const nlohmann::json& context,
+                          const ChunkSink& sink, std::size_t chunk_size = 16 * 1024) const;
+
+    // Compile a template into the on-disk cache (storage/framework/views) without rendering
+    // it, so the first render maps the program instead of compiling. `breeze_cli view:cache`
+    // runs this over every view at deploy time. Returns false if the file cannot be read.
+    static bool precompile(const std::filesystem::path& file_path);
+
     // Cache control & inspection APIs
+    static void configure(const BladeOptions& options);
+    static bool immutable();   // BladeOptions::immutable
     static void clear_cache();
     static nlohmann::json cache_stats();
 };
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <breeze/support/str.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace breeze::support::blade {
+
+// A compiled Blade template: a flat instruction array plus the tables it indexes into.
+// Everything is plain data (no pointers), so a program can be copied, cached and
+// serialized as a unit. Strings live in `pool` and are referenced by offset/length.
+
+enum class Op : std::uint8_t {
+    Text,          // append pool[a, a+b)
+    Echo,          // append exprs[a] through filters[b, b+c), HTML-escaped under autoescape
+    JumpIfFalse,   // if !exprs[a], jump to b                              (@if)
+    JumpIfTrue,    // if exprs[a], jump to b                               (@unless)
+    Jump,          // jump to b
+    LoopBegin,     // iterate exprs[a] binding segments[c]; empty/non-array jumps to b
+    LoopEnd,       // next item: jump back to b, else fall through
+    CacheBegin,    // @cache: append the fragment stored under exprs[a] and jump to b, or record
+                   // the block for c seconds (exprs[c], kNoExpr: until evicted)
+    CacheEnd,      // store the output recorded since the matching CacheBegin
+    EchoRaw,       // Echo that autoescape leaves alone ({!! !!})
+};
+
+struct Instr {
+    Op op = Op::Text;
+    std::uint32_t a = 0;
+    std::uint32_t b = 0;
+    std::uint32_t c = 0;
+};
+
+enum class ExprKind : std::uint8_t { Null, Bool, Number, String, Path, LoopVar, Not, Negate, And, Or, Compare, Arith };
+
+enum class BinOp : std::uint8_t { Eq, Ne, Lt, Gt, Le, Ge, Add, Sub, Mul, Div, Mod };
+
+struct Expr {
+    ExprKind kind = ExprKind::Null;
+    BinOp op = BinOp::Eq;
+    bool boolean = false;
+    std::uint32_t lhs = 0;        // operand expressions (Not/Negate use lhs only)
+    std::uint32_t rhs = 0;
+    double number = 0;
+    std::uint32_t str = 0;        // String: pool offset/length; Path: first segment index/count;
+    std::uint32_t len = 0;        // LoopVar: LoopField / number of `parent` hops
+    std::uint32_t source = 0;     // whole expression text in the pool, for error messages
+    std::uint32_t source_len = 0;
+    std::uint32_t pos = 0;        // offset of this node within the source
+};
+
+// `$loop.<field>` inside @foreach; `$loop.parent.<field>` reads the enclosing loop
+enum class LoopField : std::uint8_t { Index, Iteration, Remaining, Count, First, Last, Even, Odd, Depth };
+
+// One `a.b.0` path component, pre-split at compile time
+struct Segment {
+    std::uint32_t str = 0;
+    std::uint32_t len = 0;
+    std::int32_t index = -1;      // numeric components also index arrays
+};
+
+enum class FilterId : std::uint8_t { Escape, Upper, Lower, Trim, Truncate, Default, Format };
+
+struct FilterCall {
+    FilterId id = FilterId::Escape;
+    std::uint32_t arg_expr = 0;   // kNoExpr when the argument is not an expression
+    std::uint32_t arg = 0;        // raw argument text in the pool
+    std::uint32_t arg_len = 0;
+};
+
+inline constexpr std::uint32_t kNoExpr = 0xffffffffu;
+
+struct Program {
+    std::vector<Instr> code;
+    std::vector<Expr> exprs;
+    std::vector<Segment> segments;
+    std::vector<FilterCall> filters;
+    std::string pool;
+
+    std::string_view str(std::uint32_t offset, std::uint32_t length) const {
+        return std::string_view(pool).substr(offset, length);
+    }
+};
+
+// Read-only view of a program's tables. The interpreter runs views, so a program can execute
+// from a vector-backed Program or in place from a mapped precompiled file.
+struct ProgramView {
+    std::span<const Instr> code;
+    std::span<const Expr> exprs;
+    std::span<const Segment> segments;
+    std::span<const FilterCall> filters;
+    std::string_view pool;
+
+    ProgramView() = default;
+    ProgramView(const Program& program)
+        : code(program.code), exprs(program.exprs), segments(program.segments), filters(program.filters), pool(program.pool) {}
+
+    std::string_view str(std::uint32_t offset, std::uint32_t length) const { return pool.substr(offset, length); }
+};
+
+// Compile template source into a program. Malformed expressions compile to the same
+// inline "[Template Error: ...]" text the renderer has always produced. @extends, @include
+// and @component names resolve against BladeOptions::views_path.
+Program compile(std::string_view source);
+
+// Same, resolving view names against `views_path` ("layouts.app" -> layouts/app.breeze); the
+// files linked in are appended to `dependencies` when given
+Program compile(std::string_view source, const std::filesystem::path& views_path,
+                std::vector<std::filesystem::path>* dependencies = nullptr);
+
+// Execute a program against `context`, appending the output to `out`
+void execute(const ProgramView& program, const nlohmann::json& context, std::string& out);
+
+// Receives rendered output piece by piece
+using ChunkSink = std::function<void(std::string_view)>;
+
+// Execute into `buffer`, handing it to `sink` (and clearing it) whenever it reaches
+// `chunk_size` bytes, and once more at the end
+void execute(const ProgramView& program, const nlohmann::json& context, std::string& buffer,
+             const ChunkSink& sink, std::size_t chunk_size);
+
+// Binary compiled-template format: a fixed header (magic, format version, byte order and
+// struct layout) followed by the five tables, each 8-byte aligned, in native layout, and the
+// dependency manifest. A precompiled file is mapped and executed without decoding anything.
+inline constexpr std::uint32_t kFormatVersion = 4;
+
+// `dependencies` lists the partials linked into the program, one "<sha1 of content> <path>" per line
+std::string serialize(const Program& program, std::string_view dependencies = {});
+
+// Checks the header, table bounds and every cross-reference (jump targets, expression,
+// segment, filter and pool ranges), then returns a view into `bytes`. Files written by
+// another build, another format version or truncated on disk yield nullopt.
+std::optional<ProgramView> load(std::string_view bytes, std::string_view* dependencies = nullptr);
+
+// Write serialize(program) to `path` atomically (temporary file + rename)
+bool save(const Program& program, const std::filesystem::path& path, std::string_view dependencies = {});
+
+// A precompiled program mapped read-only from disk; the mapping lives as long as the object
+class MappedProgram {
+public:
+    // nullptr if the file is missing or fails load()
+    static std::shared_ptr<const MappedProgram> open(const std::filesystem::path& path);
+
+    ~MappedProgram();
+    MappedProgram(const MappedProgram&) = delete;
+    MappedProgram& operator=(const MappedProgram&) = delete;
+
+    const ProgramView& view() const { return view_; }
+    std::string_view dependencies() const { return dependencies_; }
+    std::size_t size() const { return size_; }
+
+private:
+    MappedProgram(void* base, std::size_t size) : base_(base), size_(size) {}
+
+    void* base_ = nullptr;
+    std::size_t size_ = 0;
+    ProgramView view_;
+    std::string_view dependencies_;
+};
+
+// --- ahead-of-time compiled templates ---
+//
+// breeze_add_views() (cmake/BreezeViews.cmake) runs breeze_viewc over each template at build
+// time. The generated C++ appends text straight to the output, resolves plain paths
+// (`{{ product.name }}`, `@if(user.is_admin)`) with direct JSON lookups and keeps control flow
+// native. Filters, operators, `$loop` and `@cache` go through Frame to the interpreter, which
+// evaluates them against the program tables embedded next to the generated code.
+
+class Interpreter;
+
+class Frame {
+public:
+    explicit Frame(Interpreter& interpreter);
+
+    // Generated code appends text to out() directly, then calls written() so streamed
+    // renders hand off full chunks
+    std::string& out() { return out_; }
+    void written() {
+        if (out_.size() >= flush_at_) flush();
+    }
+
+    // Plain paths, resolved one pre-split component at a time; nullptr when one is missing
+    const nlohmann::json* root() const { return root_; }
+    // Element of the @foreach entered or advanced last; generated code reads it at the top of each iteration
+    const nlohmann::json* item() const { return item_; }
+    static const nlohmann::json* member(const nlohmann::json* value, std::string_view key, std::int32_t index) {
+        if (!value) return nullptr;
+        if (value->is_object()) {
+            auto it = value->find(key);
+            return it != value->end() ? &*it : nullptr;
+        }
+        if (value->is_array() && index >= 0 && static_cast<std::size_t>(index) < value->size()) {
+            return &(*value)[static_cast<std::size_t>(index)];
+        }
+        return nullptr;
+    }
+
+    // Same truthiness as the interpreter: missing, null, false, 0, "" and empty containers are false
+    static bool truthy(const nlohmann::json* value) {
+        if (!value) return false;
+        switch (value->type()) {
+            case nlohmann::json::value_t::null: return false;
+            case nlohmann::json::value_t::boolean: return value->get<bool>();
+            case nlohmann::json::value_t::number_integer: return value->get<std::int64_t>() != 0;
+            case nlohmann::json::value_t::number_unsigned: return value->get<std::uint64_t>() != 0;
+            case nlohmann::json::value_t::number_float: return value->get<double>() != 0;
+            case nlohmann::json::value_t::string: return !value->get_ref<const std::string&>().empty();
+            default: return !value->empty();
+        }
+    }
+
+    // {{ path }} / {!! path !!} for a resolved value: strings are appended (HTML-escaped under
+    // autoescape) here; `expr` is the echo's expression, for values the interpreter prints
+    void echo_value(const nlohmann::json* value, std::uint32_t expr) { echo_value(value, expr, false); }
+    void echo_value_raw(const nlohmann::json* value, std::uint32_t expr) { echo_value(value, expr, true); }
+
+    // Everything else runs the matching instruction in the interpreter
+    void echo(std::uint32_t expr, std::uint32_t first_filter, std::uint32_t filters);
+    void echo_raw(std::uint32_t expr, std::uint32_t first_filter, std::uint32_t filters);
+    bool skip_unless(std::uint32_t expr);   // @if: true when the block is skipped (falsy or an error)
+    bool skip_if(std::uint32_t expr);       // @unless: true when the block is skipped (truthy or an error)
+    bool loop_begin(std::uint32_t expr, std::uint32_t symbol);   // false when there is nothing to iterate
+    bool loop_next();                       // advance; false after the last item
+    bool cache_begin(std::uint32_t key, std::uint32_t ttl);   // @cache: true when the stored fragment was used
+    void cache_end();
+
+private:
+    void echo_value(const nlohmann::json* value, std::uint32_t expr, bool raw) {
+        if (value && value->is_string()) {
+            const auto& text = value->get_ref<const std::string&>();
+            if (autoescape_ && !raw) str::append_html_escaped(out_, text);
+            else out_ += text;
+            written();
+            return;
+        }
+        echo_other(value, expr, raw);
+    }
+    void echo_other(const nlohmann::json* value, std::uint32_t expr, bool raw);
+    void flush();
+
+    Interpreter& interpreter_;
+    std::string& out_;
+    const nlohmann::json* root_;
+    const nlohmann::json* item_ = nullptr;
+    std::size_t flush_at_;
+    bool autoescape_;
+};
+
+using CompiledRender = void (*)(Frame& frame);
+
+struct CompiledView {
+    ProgramView program;
+    CompiledRender render = nullptr;
+};
+
+// Generate the C++ source for `program` registered as view `name` (what breeze_viewc writes).
+// Throws std::runtime_error for control flow the generator cannot structure.
+std::string generate_cpp(const Program& program, std::string_view name, std::string_view source_path = {});
+
+// Called from generated code during static initialization. `image` is serialize() output;
+// returns false (and the view stays interpreted) if it does not load().
+bool register_compiled(std::string_view name, std::string_view image, CompiledRender render);
+
+// The compiled view registered under a template name such as "index" or "admin/users";
+// nullptr if there is none or compiled views are disabled (BladeOptions::compiled)
+const CompiledView* find_compiled(std::string_view name);
+
+void execute(const CompiledView& view, const nlohmann::json& context, std::string& out);
+void execute(const CompiledView& view, const nlohmann::json& context, std::string& buffer,
+             const ChunkSink& sink, std::size_t chunk_size);
+
+} // namespace breeze::support::blade
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+namespace breeze::support {
+
+// Rendered output of Blade @cache(key, ttl) blocks, shared by every view. Keys hash to one of
+// kShards LRU lists, each behind its own mutex, so renders of different fragments rarely
+// contend. When an entry expires, the first renderer to see it re-renders while everyone else
+// keeps serving the stale copy until the new one is stored.
+class FragmentCache {
+public:
+    static FragmentCache& instance();
+
+    struct Lookup {
+        std::shared_ptr<const std::string> html;   // output to serve; null: render the fragment
+        bool refresh = false;                      // this caller renders it and must store() or release()
+    };
+
+    Lookup lookup(std::string_view key);
+
+    // A zero ttl keeps the fragment until it is evicted
+    void store(std::string_view key, std::string html, std::chrono::milliseconds ttl);
+
+    // Give up a refresh (the render failed), so the next lookup of an expired entry retries
+    void release(std::string_view key);
+
+    void configure(std::size_t max_items);
+    void clear();
+    nlohmann::json stats() const;
+
+private:
+    static constexpr std::size_t kShards = 16;
+    // A refresh that has not been stored after this long is assumed abandoned
+    static constexpr std::chrono::seconds kRefreshTimeout{30};
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const std::string> html;
+        Clock::time_point expires = Clock::time_point::max();
+        Clock::time_point refreshing_since = Clock::time_point::min();   // min(): nobody is refreshing
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;   // most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;   // views Entry::key
+        std::size_t capacity = 64;
+        std::uint64_t hits = 0;
+        std::uint64_t stale_hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    FragmentCache() = default;
+
+    Shard& shard_for(std::string_view key);
+
+    std::array<Shard, kShards> shards_;
+};
+
+} // namespace breeze::support
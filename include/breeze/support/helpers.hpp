@@ -2,6 +2,8 @@
 #include <breeze/core/application.hpp>
 #include <breeze/support/env.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace breeze {
 
@@ -23,7 +25,14 @@ inline std::string config(const std::string& key, const std::string& fallback =
  * Generate a URL for a named route.
  */
 inline std::string route(const std::string& name, const std::unordered_map<std::string, std::string>& params = {}) {
-    return core::Application::instance().kernel().router().route(name, params);
+    return core::Application::router().route(name, params);
+}
+
+/**
+ * Generate URLs for several named routes with a single router lookup.
+ */
+inline std::vector<std::string> route_batch(const std::vector<std::pair<std::string, http::Router::RouteParams>>& requests) {
+    return core::Application::router().route_batch(requests);
 }
 
 } // namespace breeze
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <breeze/support/allocations.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace breeze::support {
+
+// Log-linear (HDR-style) latency histogram over microseconds: sixteen sub-buckets per
+// power of two, so a bucket's bounds differ by at most 6.25% (exact below 16us).
+struct LatencyBuckets {
+    static constexpr std::size_t sub_buckets = 16;
+    static constexpr std::size_t count = 464; // covers 0us .. ~2^32us
+
+    static std::size_t index_for(std::uint64_t us);
+    static std::uint64_t upper_bound(std::size_t index); // exclusive, in microseconds
+};
+
+struct HistogramSnapshot {
+    std::array<std::uint64_t, LatencyBuckets::count> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t sum_us = 0;
+    std::uint64_t allocations = 0;      // heap activity attributed to the series; only
+    std::uint64_t allocated_bytes = 0;  // non-zero when allocation tracking is compiled in
+
+    // Upper bound (microseconds) of the bucket holding quantile q in [0, 1]
+    std::uint64_t quantile_us(double q) const;
+};
+
+// Process-wide request metrics. Recording is lock-free: series are found through an
+// open-addressed table of atomic pointers, and each series keeps per-thread-stripe
+// shards of relaxed atomic counters that are merged when /metrics is scraped.
+class Metrics {
+public:
+    static Metrics& instance();
+
+    // `allocations` is what the request allocated, when allocation tracking is active. Methods
+    // outside the standard set are recorded as "OTHER"; once kMaxSeries series exist, new
+    // combinations are recorded under method "*", route "<overflow>", status 0.
+    void observe_request(std::string_view method, std::string_view route, int status,
+                         std::chrono::microseconds duration, const AllocationCounts* allocations = nullptr);
+
+    // Debug switch: Kernel adds an X-Breeze-Allocations header to each response (needs tracking)
+    void set_allocation_header(bool enabled) { allocation_header_.store(enabled, std::memory_order_relaxed); }
+    bool allocation_header() const { return allocation_header_.load(std::memory_order_relaxed); }
+
+    void add_bytes_in(std::size_t bytes) { bytes_in_.fetch_add(bytes, std::memory_order_relaxed); }
+    void add_bytes_out(std::size_t bytes) { bytes_out_.fetch_add(bytes, std::memory_order_relaxed); }
+
+    // Connection accepted and not yet answered (the server calls these at accept and after the
+    // response has been written)
+    void connection_opened() { active_connections_.fetch_add(1, std::memory_order_relaxed); }
+    void connection_closed() { active_connections_.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Marks the calling worker busy for its lifetime; busy time feeds utilisation
+    class BusyScope {
+    public:
+        explicit BusyScope(Metrics& metrics);
+        ~BusyScope();
+        BusyScope(const BusyScope&) = delete;
+        BusyScope& operator=(const BusyScope&) = delete;
+    private:
+        Metrics& metrics_;
+        std::chrono::steady_clock::time_point started_;
+    };
+
+    // Merged histogram for one series (all zero if it was never recorded)
+    HistogramSnapshot snapshot(std::string_view method, std::string_view route, int status) const;
+
+    // Prometheus text exposition format (version 0.0.4)
+    std::string prometheus() const;
+
+    void reset();
+
+private:
+    static constexpr std::size_t kShards = 8;
+    static constexpr std::size_t kTableSize = 4096; // power of two
+    static constexpr std::size_t kMaxSeries = kTableSize / 2; // further series fold into overflow_
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, LatencyBuckets::count> buckets{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum_us{0};
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> allocated_bytes{0};
+    };
+
+    struct Series {
+        std::string method;
+        std::string route;
+        int status = 0;
+        std::size_t hash = 0;
+        std::array<Shard, kShards> shards;
+
+        HistogramSnapshot merge() const;
+    };
+
+    Metrics();
+
+    static std::size_t series_hash(std::string_view method, std::string_view route, int status);
+    const Series* find_series(std::string_view method, std::string_view route, int status, std::size_t hash) const;
+    Series& series_for(std::string_view method, std::string_view route, int status);
+    Series* insert_series(std::string_view method, std::string_view route, int status, std::size_t hash); // holds series_mutex_
+
+    std::array<std::atomic<Series*>, kTableSize> table_{};
+    std::mutex series_mutex_;                       // serialises series creation only
+    std::vector<std::unique_ptr<Series>> series_;   // owns everything in table_
+    Series* overflow_ = nullptr;                    // method "*", route "<overflow>", created up front
+
+    std::atomic<std::uint64_t> bytes_in_{0};
+    std::atomic<std::uint64_t> bytes_out_{0};
+    std::atomic<std::int64_t> active_connections_{0};
+    std::atomic<std::int64_t> busy_workers_{0};
+    std::atomic<std::uint64_t> busy_us_{0};
+    std::atomic<bool> allocation_header_{false};
+    std::atomic<std::chrono::steady_clock::time_point> started_{std::chrono::steady_clock::now()}; // reset() may race scrapes
+};
+
+} // namespace breeze::support
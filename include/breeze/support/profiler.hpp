@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace breeze::support {
+
+// One finished profiling run
+struct Profile {
+    std::uint64_t samples = 0;
+    std::uint64_t dropped = 0;                 // samples lost because the buffer was full
+    std::chrono::milliseconds duration{0};
+    int hz = 0;
+
+    // "route;outermost;...;innermost count" lines, the input format of flamegraph.pl / speedscope
+    std::string collapsed;
+};
+
+// Process-wide CPU sampling profiler. setitimer(ITIMER_PROF) delivers SIGPROF to whichever
+// thread is burning CPU; the handler captures backtrace() frames plus the route that thread is
+// serving (Router::matched_pattern) into a preallocated buffer. Frames are symbolized with
+// dladdr and demangled only after the timer stops. Executables need exported symbols
+// (ENABLE_EXPORTS / -rdynamic) for readable frame names; otherwise frames print as module+offset.
+class SamplingProfiler {
+public:
+    static constexpr std::size_t max_frames = 48;
+    static constexpr std::size_t max_route = 64;
+    static constexpr std::size_t max_samples = 20000;
+
+    static SamplingProfiler& instance();
+
+    // Starts sampling at `hz` samples per CPU-second. Returns false if a run is in progress.
+    bool start(int hz = 99);
+
+    // Stops sampling and aggregates the samples into collapsed stacks
+    Profile stop();
+
+    // start(), sleep for `duration`, stop(). Throws std::runtime_error if already running.
+    Profile collect(std::chrono::milliseconds duration, int hz = 99);
+
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+private:
+    struct Sample {
+        std::uint32_t depth = 0;
+        std::uint32_t route_length = 0;
+        void* frames[max_frames];
+        char route[max_route];
+    };
+
+    SamplingProfiler() = default;
+
+    static void on_signal(int);
+    std::string aggregate(std::size_t count) const;
+
+    std::atomic<bool> running_{false};
+    std::vector<Sample> samples_;
+    std::atomic<std::size_t> next_{0};
+    std::atomic<bool> armed_{false};          // handler only writes while set
+    std::chrono::steady_clock::time_point started_;
+    int hz_ = 0;
+};
+
+} // namespace breeze::support
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <string_view>
 
@@ -9,4 +10,16 @@ std::string trim(std::string_view s);
 std::string to_lower(std::string_view s);
 std::string replace_all(std::string_view s, std::string_view from, std::string_view to);
 
+// Offset of the first character HTML escaping would replace (& < > " '), or npos
+std::size_t find_html_special(std::string_view s);
+
+// Append `s` with & < > " ' replaced by entities. Clean runs are found 16 or 32 bytes at a
+// time (SSE2, or AVX2 when the CPU has it) and copied in one append.
+void append_html_escaped(std::string& out, std::string_view s);
+
+// In place, ASCII only: other bytes (including UTF-8 sequences) are left as they are
+void ascii_upper(std::string& s);
+void ascii_lower(std::string& s);
+void trim_in_place(std::string& s);
+
 } // namespace breeze::support::str
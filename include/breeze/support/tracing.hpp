@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace breeze::support {
+
+struct TraceOptions {
+    bool enabled = true;
+    bool server_timing = false;                        // add a Server-Timing header to responses
+    std::chrono::microseconds slow_threshold{250000};  // traces at least this long are exported
+    std::filesystem::path export_path = "storage/logs/traces.log";
+};
+
+// One timed region inside a trace. Names are string literals; the detail is copied.
+struct SpanRecord {
+    const char* name = "";
+    char detail[40] = {};
+    std::uint32_t start_us = 0;    // offset from the start of the trace
+    std::uint32_t duration_us = 0;
+    std::uint16_t depth = 0;
+};
+
+// Per-request trace. Ids, the request line and spans live in fixed inline buffers, so
+// instrumenting a request never allocates; spans beyond the capacity are counted and
+// discarded, and a long method or path is truncated in the export record.
+class Trace {
+public:
+    static constexpr std::size_t capacity = 64;
+    using clock = std::chrono::steady_clock;
+
+    Trace();
+
+    // Current trace of the calling thread (nullptr when tracing is off or idle)
+    static Trace* current() { return current_; }
+
+    // Join the caller's trace from a W3C `traceparent` header; returns false if invalid
+    bool adopt_parent(std::string_view traceparent);
+
+    // `traceparent` value for outgoing calls made while handling this request
+    std::string traceparent() const;
+
+    std::string_view trace_id() const { return {trace_id_.data(), trace_id_.size()}; }
+    std::string_view parent_id() const { return has_parent_ ? std::string_view(parent_id_.data(), parent_id_.size()) : std::string_view(); }
+    std::string_view span_id() const { return {span_id_.data(), span_id_.size()}; }
+    bool sampled() const { return sampled_; }
+
+    std::chrono::microseconds elapsed() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - started_);
+    }
+
+    std::size_t span_count() const { return count_; }
+    std::size_t dropped_spans() const { return dropped_; }
+    const SpanRecord& span(std::size_t i) const { return spans_[i]; }
+
+    // Aggregated per-name durations, e.g. `dispatch;dur=1.204, container;dur=0.031;desc="x3"`
+    std::string server_timing() const;
+
+    // Set by the outermost owner for the export record
+    void describe(std::string_view method, std::string_view path, int status);
+
+private:
+    friend class Span;
+    friend class TraceScope;
+    friend class Tracer;
+
+    std::size_t open(const char* name, std::string_view detail) {
+        if (count_ == capacity) {
+            ++dropped_;
+            return capacity;
+        }
+        auto& rec = spans_[count_];
+        rec.name = name;
+        auto n = std::min(detail.size(), sizeof(rec.detail) - 1);
+        std::memcpy(rec.detail, detail.data(), n);
+        rec.detail[n] = '\0';
+        rec.start_us = static_cast<std::uint32_t>(elapsed().count());
+        rec.depth = depth_++;
+        return count_++;
+    }
+
+    void close(std::size_t index) {
+        --depth_;
+        if (index == capacity) return;
+        auto& rec = spans_[index];
+        rec.duration_us = static_cast<std::uint32_t>(elapsed().count()) - rec.start_us;
+    }
+
+    std::string to_json() const;
+
+    static inline thread_local Trace* current_ = nullptr;
+
+    clock::time_point started_;
+    std::array<SpanRecord, capacity> spans_;
+    std::size_t count_ = 0;
+    std::size_t dropped_ = 0;
+    std::uint16_t depth_ = 0;
+    std::array<char, 32> trace_id_;    // lowercase hex
+    std::array<char, 16> parent_id_;   // from the incoming traceparent, if has_parent_
+    std::array<char, 16> span_id_;     // identifies this server's work
+    bool has_parent_ = false;
+    bool sampled_ = false;
+    char method_[16] = {};
+    char path_[128] = {};
+    int status_ = 0;
+};
+
+// Process-wide tracing settings and slow-trace exporter
+class Tracer {
+public:
+    static Tracer& instance();
+
+    void configure(TraceOptions options);
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool server_timing() const { return server_timing_.load(std::memory_order_relaxed); }
+
+    // Append the trace to the export file if it was slow enough; returns true if written
+    bool finish(const Trace& trace);
+
+    std::uint64_t exported() const { return exported_.load(std::memory_order_relaxed); }
+
+private:
+    Tracer() = default;
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<bool> server_timing_{false};
+    std::atomic<std::int64_t> slow_threshold_us_{250000};
+    std::atomic<std::uint64_t> exported_{0};
+
+    std::mutex export_mutex_;
+    std::filesystem::path export_path_ = "storage/logs/traces.log";
+};
+
+// Starts a trace for the calling thread unless one is already active, in which case it
+// does nothing; the outermost scope owns the trace and exports it when it ends.
+class TraceScope {
+public:
+    TraceScope() {
+        if (!Trace::current_ && Tracer::instance().enabled()) {
+            Trace::current_ = &trace_.emplace();
+        }
+    }
+
+    ~TraceScope() {
+        if (!trace_) return;
+        Trace::current_ = nullptr;
+        Tracer::instance().finish(*trace_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    bool owner() const { return trace_.has_value(); }
+
+private:
+    std::optional<Trace> trace_;
+};
+
+// RAII span: `Span span("dispatch");`. Costs one thread-local load when no trace is active.
+class Span {
+public:
+    explicit Span(const char* name, std::string_view detail = {}) : trace_(Trace::current_) {
+        if (trace_) index_ = trace_->open(name, detail);
+    }
+
+    ~Span() {
+        if (trace_) trace_->close(index_);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    Trace* trace_;
+    std::size_t index_ = 0;
+};
+
+} // namespace breeze::support
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <breeze/http/request.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace breeze::support {
+
+// One sampled request as stored in a capture file
+struct CapturedRequest {
+    std::uint64_t offset_us = 0;     // arrival time since capture started
+    std::uint32_t duration_us = 0;   // time spent in the application when captured
+    std::uint16_t status = 0;
+    std::string method;
+    std::string path;
+    std::string query;
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    // Raw HTTP/1.1 request suitable for sending to a server (or Server::parse_request)
+    std::string to_http(const std::string& host = "localhost") const;
+};
+
+struct TrafficCaptureOptions {
+    bool enabled = false;
+    std::filesystem::path file = "storage/capture/traffic.bin";
+    unsigned sample_every = 1;                   // keep 1 in N requests
+    std::size_t max_bytes = 100 * 1024 * 1024;   // stop capturing once the file reaches this size
+    std::vector<std::string> redact_headers = {"authorization", "cookie"};
+};
+
+// Samples requests into a compact binary log. Request threads only append encoded records to
+// an in-memory buffer; a background thread writes it out. Layout (integers little-endian):
+//   file:   "BRZCAP" u16 version
+//   record: u32 payload size, then u64 offset_us, u32 duration_us, u16 status,
+//           u32-prefixed method, path, query and body, u16 header count,
+//           u16-prefixed header name and value for each header
+class TrafficCapture {
+public:
+    static constexpr std::uint16_t version = 1;
+
+    static TrafficCapture& instance();
+
+    ~TrafficCapture();
+
+    // Opens (truncating) the capture file, resets the time origin and starts the writer thread
+    void configure(TrafficCaptureOptions options);
+    // Stops the writer and writes out everything recorded so far
+    void close();
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Cheap per-request sampling decision, taken before the request is handled
+    bool should_sample() noexcept;
+
+    void record(const breeze::http::Request& request, int status, std::chrono::microseconds duration,
+                std::chrono::steady_clock::time_point arrived);
+
+    std::uint64_t captured() const { return captured_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t kFlushBytes = 64 * 1024;      // wake the writer early past this
+    static constexpr std::chrono::milliseconds kFlushInterval{200};
+
+    TrafficCapture() = default;
+
+    void writer_loop();
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<unsigned> sample_every_{1};
+    std::atomic<std::uint64_t> counter_{0};
+    std::atomic<std::uint64_t> captured_{0};
+
+    std::mutex mutex_;                       // guards everything below except file_
+    TrafficCaptureOptions options_;
+    std::string pending_;                    // encoded records not yet written
+    std::size_t bytes_written_ = 0;          // file size once pending_ is written
+    std::chrono::steady_clock::time_point origin_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    std::FILE* file_ = nullptr;              // written by the writer thread, opened/closed around it
+    std::thread writer_;
+};
+
+// Sequential reader for capture files; throws std::runtime_error on a malformed file
+class TrafficReader {
+public:
+    explicit TrafficReader(const std::filesystem::path& file);
+    ~TrafficReader();
+
+    TrafficReader(const TrafficReader&) = delete;
+    TrafficReader& operator=(const TrafficReader&) = delete;
+
+    // Reads the next record; returns false at end of file
+    bool next(CapturedRequest& out);
+
+    static std::vector<CapturedRequest> read_all(const std::filesystem::path& file);
+
+private:
+    std::FILE* file_ = nullptr;
+    std::string buffer_;
+};
+
+} // namespace breeze::support
@@ -3,18 +3,41 @@
 #include <string>
 #include <nlohmann/json.hpp>
 #include <filesystem>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <breeze/support/blade.hpp>
 #include <breeze/support/view_engine.hpp>
 
 namespace breeze::support {
 
+// Renders views from `views_path`; a view built into the binary with breeze_add_views()
+// runs its generated C++ instead (see blade::find_compiled)
 class View : public IViewEngine {
 public:
     explicit View(std::filesystem::path views_path);
 
     std::string render(const std::string& template_name, const nlohmann::json& data) override;
 
+    // Append the rendered view to `out`
+    void render_to(std::string& out, const std::string& template_name, const nlohmann::json& data);
+
+    // Render the view in chunks of about `chunk_size` bytes (see Blade::stream_from_file)
+    void stream(const std::string& template_name, const nlohmann::json& data, const Blade::ChunkSink& sink,
+                std::size_t chunk_size = 16 * 1024);
+
+    // Template file extensions, in lookup order
+    static const std::vector<std::string>& extensions();
+
 private:
+    std::optional<std::filesystem::path> resolve(const std::string& template_name) const;
+    std::string not_found(const std::string& template_name) const;
+
     std::filesystem::path views_path_;
+    // Resolved template paths, kept only while views are immutable (BladeOptions::immutable)
+    mutable std::mutex resolved_mutex_;
+    mutable std::unordered_map<std::string, std::filesystem::path> resolved_;
 };
 
 } // namespace breeze::support
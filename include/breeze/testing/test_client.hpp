@@ -0,0 +1,219 @@
+#pragma once
+
+#include <breeze/core/application.hpp>
+#include <breeze/http/server.hpp>
+#include <breeze/support/allocations.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace breeze::testing {
+
+// A response parsed back out of the raw bytes the server would have written
+struct TestResponse {
+    int status = 0;
+    std::string reason;
+    std::vector<std::pair<std::string, std::string>> headers;  // names lower-cased
+    std::string body;
+    std::string raw;
+
+    bool ok() const { return status >= 200 && status < 300; }
+
+    std::string header(std::string name) const {
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        for (const auto& [key, value] : headers) {
+            if (key == name) return value;
+        }
+        return "";
+    }
+
+    nlohmann::json json() const { return nlohmann::json::parse(body); }
+};
+
+// Limits a request must stay within; unset fields are not checked
+struct Budget {
+    std::optional<std::uint64_t> max_allocations;        // worst iteration, per request
+    std::optional<std::chrono::microseconds> max_p99;
+    std::size_t iterations = 200;
+    std::size_t warmup = 10;
+};
+
+struct Measurement {
+    std::string label;
+    std::size_t iterations = 0;
+    bool allocations_counted = false;  // false unless allocation_hooks.hpp is linked in
+    std::uint64_t min_allocations = 0;
+    std::uint64_t max_allocations = 0;
+    double mean_allocations = 0;
+    double mean_bytes = 0;
+    std::chrono::microseconds p50{0};
+    std::chrono::microseconds p99{0};
+    std::chrono::microseconds max{0};
+
+    // Human readable budget violations; empty when the budget holds
+    std::vector<std::string> violations(const Budget& budget) const {
+        std::vector<std::string> out;
+        if (budget.max_allocations && !allocations_counted) {
+            out.push_back(label + ": allocation budget set but allocation hooks are not installed");
+        } else if (budget.max_allocations && max_allocations > *budget.max_allocations) {
+            out.push_back(label + ": " + std::to_string(max_allocations) + " allocations per request, budget " +
+                          std::to_string(*budget.max_allocations));
+        }
+        if (budget.max_p99 && p99 > *budget.max_p99) {
+            out.push_back(label + ": p99 " + std::to_string(p99.count()) + "us, budget " +
+                          std::to_string(budget.max_p99->count()) + "us");
+        }
+        return out;
+    }
+};
+
+class BudgetExceeded : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Drives an Application with raw HTTP bytes through the same parse -> Kernel::handle ->
+ * serialize path as the socket server (Server::process), without opening sockets.
+ *
+ *   breeze::testing::TestClient client(app);
+ *   auto res = client.get("/users/7");
+ *   client.expect_within(TestClient::request("GET", "/ping"), {.max_allocations = 40});
+ *
+ * Allocation budgets need the counting operator new: include
+ * <breeze/support/allocation_hooks.hpp> from one file of the test executable.
+ */
+class TestClient {
+public:
+    using Headers = std::vector<std::pair<std::string, std::string>>;
+
+    explicit TestClient(breeze::core::Application& app)
+        : server_([&app](const breeze::http::Request& req) { return app.handle(req); }) {}
+
+    // Build a raw HTTP/1.1 request
+    static std::string request(const std::string& method, const std::string& target, const std::string& body = "",
+                               const Headers& headers = {}) {
+        std::string raw = method + " " + target + " HTTP/1.1\r\nHost: localhost\r\n";
+        for (const auto& [name, value] : headers) raw += name + ": " + value + "\r\n";
+        if (!body.empty()) raw += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        raw += "\r\n" + body;
+        return raw;
+    }
+
+    TestResponse send(const std::string& raw) { return parse_response(server_.process(raw, remote_addr_)); }
+
+    TestResponse get(const std::string& target, const Headers& headers = {}) {
+        return send(request("GET", target, "", headers));
+    }
+
+    TestResponse post(const std::string& target, const std::string& body,
+                      const std::string& content_type = "application/json", Headers headers = {}) {
+        headers.emplace_back("Content-Type", content_type);
+        return send(request("POST", target, body, headers));
+    }
+
+    // Value injected as x-remote-addr, as the server does from the peer address
+    void set_remote_addr(std::string addr) { remote_addr_ = std::move(addr); }
+
+    // Time and count allocations for `iterations` runs of one request (after `warmup` runs
+    // that fill lazy caches such as compiled routes and views)
+    Measurement measure(const std::string& raw, std::size_t iterations = 200, std::size_t warmup = 10) {
+        for (std::size_t i = 0; i < warmup; ++i) (void)server_.process(raw, remote_addr_);
+
+        Measurement m;
+        m.label = raw.substr(0, raw.find(" HTTP/"));
+        m.iterations = std::max<std::size_t>(iterations, 1);
+        m.allocations_counted = breeze::support::allocations::available();
+        m.min_allocations = UINT64_MAX;
+
+        std::vector<std::chrono::microseconds> latencies;
+        latencies.reserve(m.iterations);
+        std::uint64_t total_allocations = 0;
+        std::uint64_t total_bytes = 0;
+        for (std::size_t i = 0; i < m.iterations; ++i) {
+            std::string out;
+            breeze::support::AllocationScope scope;
+            auto started = std::chrono::steady_clock::now();
+            out = server_.process(raw, remote_addr_);
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            auto counts = scope.counts();
+
+            latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+            total_allocations += counts.allocations;
+            total_bytes += counts.bytes;
+            m.min_allocations = std::min(m.min_allocations, counts.allocations);
+            m.max_allocations = std::max(m.max_allocations, counts.allocations);
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&latencies](double p) {
+            auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(latencies.size())));
+            return latencies[std::clamp<std::size_t>(rank, 1, latencies.size()) - 1];
+        };
+        m.p50 = at(0.50);
+        m.p99 = at(0.99);
+        m.max = latencies.back();
+        m.mean_allocations = static_cast<double>(total_allocations) / static_cast<double>(m.iterations);
+        m.mean_bytes = static_cast<double>(total_bytes) / static_cast<double>(m.iterations);
+        return m;
+    }
+
+    // Measure and throw BudgetExceeded listing every violated limit
+    Measurement expect_within(const std::string& raw, const Budget& budget) {
+        auto m = measure(raw, budget.iterations, budget.warmup);
+        auto problems = m.violations(budget);
+        if (!problems.empty()) {
+            std::string message = "performance budget exceeded";
+            for (const auto& p : problems) message += "\n  " + p;
+            throw BudgetExceeded(message);
+        }
+        return m;
+    }
+
+    static TestResponse parse_response(std::string raw) {
+        TestResponse res;
+        auto head_end = raw.find("\r\n\r\n");
+        if (head_end == std::string::npos) throw std::runtime_error("malformed response: no header terminator");
+
+        auto line_end = raw.find("\r\n");
+        auto status_line = raw.substr(0, line_end);
+        auto first_space = status_line.find(' ');
+        if (first_space == std::string::npos) throw std::runtime_error("malformed status line: " + status_line);
+        auto second_space = status_line.find(' ', first_space + 1);
+        res.status = std::stoi(status_line.substr(first_space + 1, second_space - first_space - 1));
+        if (second_space != std::string::npos) res.reason = status_line.substr(second_space + 1);
+
+        auto pos = line_end + 2;
+        while (pos < head_end) {
+            auto next = raw.find("\r\n", pos);
+            auto line = raw.substr(pos, next - pos);
+            pos = next + 2;
+            auto colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            auto name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+            auto value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            res.headers.emplace_back(std::move(name), std::move(value));
+        }
+        res.body = raw.substr(head_end + 4);
+        res.raw = std::move(raw);
+        return res;
+    }
+
+private:
+    breeze::http::Server server_;
+    std::string remote_addr_ = "127.0.0.1";
+};
+
+} // namespace breeze::testing
@@ -3,6 +3,10 @@
 #include "app/Providers/MiddlewareServiceProvider.hpp"
 #include "app/Providers/ControllerServiceProvider.hpp"
 
+#ifdef BREEZE_ALLOCATION_TRACKING
+#include <breeze/support/allocation_hooks.hpp>
+#endif
+
 // Forward declarations of route registration functions
 void register_web_routes(breeze::core::Application& app);
 void register_api_routes(breeze::core::Application& app);
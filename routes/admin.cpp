@@ -1,4 +1,7 @@
 #include <breeze/breeze.hpp>
+#include <app/Http/Middleware/AdminOnly.hpp>
+
+#include <algorithm>
 
 void register_admin_routes(breeze::core::Application& app) {
     auto& router = app.kernel().router();
@@ -13,5 +16,34 @@ void register_admin_routes(breeze::core::Application& app) {
             return breeze::http::Response::json({{"status", "ok"}, {"message", "Blade cache cleared"}});
         });
     });
-}
 
+    // Prometheus scrape endpoint; path and token come from config/metrics.json
+    if (app.config().get<bool>("metrics.enabled", true)) {
+        router.get(app.config().get("metrics.path", std::string("/admin/metrics")), [](const breeze::http::Request&) {
+            breeze::http::Response res(breeze::http::StatusCode::OK, breeze::support::Metrics::instance().prometheus());
+            res.set_header("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+            return res;
+        }).middleware(app::Http::Middleware::AdminOnly(app.config().get("metrics.token", std::string())));
+    }
+
+    // On-demand CPU profile: GET /admin/profile?seconds=10&hz=99 -> collapsed stacks for flamegraph.pl
+    if (app.config().get<bool>("profiler.enabled", true)) {
+        int max_seconds = app.config().get<int>("profiler.max_seconds", 30);
+        int default_hz = app.config().get<int>("profiler.hz", 99);
+        router.get(app.config().get("profiler.path", std::string("/admin/profile")), [max_seconds, default_hz](const breeze::http::Request& req) {
+            int seconds = std::clamp(req.query<int>("seconds", 10), 1, max_seconds);
+            int hz = std::clamp(req.query<int>("hz", default_hz), 1, 1000);
+            auto& profiler = breeze::support::SamplingProfiler::instance();
+            if (!profiler.start(hz)) {
+                return breeze::http::Response(breeze::http::StatusCode::Conflict, "A profile is already being collected\n");
+            }
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            auto profile = profiler.stop();
+            breeze::http::Response res(breeze::http::StatusCode::OK, std::move(profile.collapsed));
+            res.set_header("Content-Type", "text/plain; charset=utf-8");
+            res.set_header("X-Profile-Samples", std::to_string(profile.samples));
+            res.set_header("X-Profile-Dropped", std::to_string(profile.dropped));
+            return res;
+        }).middleware(app::Http::Middleware::AdminOnly(app.config().get("profiler.token", std::string())));
+    }
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Compare breeze_bench JSON results against a stored baseline.
+
+Usage:
+    scripts/bench_compare.py BASELINE.json CURRENT.json [--threshold PCT]
+    scripts/bench_compare.py BASELINE.json CURRENT.json --update   # store CURRENT as the new baseline
+
+Exits with status 1 when any benchmark is slower than the baseline by more than
+the threshold (default 10%), so it can gate CI. Benchmarks present in only one
+file are listed but never fail the comparison.
+"""
+
+import argparse
+import json
+import shutil
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data.get("context", {}), {b["name"]: b for b in data.get("benchmarks", [])}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--update", action="store_true", help="overwrite the baseline with the current results")
+    args = parser.parse_args()
+
+    if args.update:
+        shutil.copyfile(args.current, args.baseline)
+        print(f"Baseline updated: {args.baseline}")
+        return 0
+
+    base_ctx, baseline = load(args.baseline)
+    cur_ctx, current = load(args.current)
+    if base_ctx.get("build_type") != cur_ctx.get("build_type"):
+        print(f"warning: build types differ ({base_ctx.get('build_type')!r} vs {cur_ctx.get('build_type')!r})")
+
+    regressions = []
+    width = max((len(n) for n in list(current) + list(baseline)), default=10)
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'current':>12}  {'change':>8}")
+    for name, cur in current.items():
+        base = baseline.get(name)
+        if base is None:
+            print(f"{name:<{width}}  {'-':>12}  {cur['ns_per_op']:>10.1f}ns  {'new':>8}")
+            continue
+        change = (cur["ns_per_op"] - base["ns_per_op"]) / base["ns_per_op"] * 100.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print(f"{name:<{width}}  {base['ns_per_op']:>10.1f}ns  {cur['ns_per_op']:>10.1f}ns  {change:>+7.1f}%{flag}")
+
+    for name in sorted(baseline.keys() - current.keys()):
+        print(f"{name:<{width}}  (missing from current run)")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than baseline by more than {args.threshold:g}%")
+        return 1
+    print("\nNo regressions.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
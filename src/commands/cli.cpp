@@ -4,10 +4,36 @@
 #include <unordered_map>
 #include <breeze/core/command.hpp>
 #include <breeze/commands/serve_command.hpp>
+#include <breeze/commands/bench_command.hpp>
+#include <breeze/commands/replay_command.hpp>
+#include <breeze/commands/view_cache_command.hpp>
+#include "app/Providers/ViewServiceProvider.hpp"
+#include "app/Providers/MiddlewareServiceProvider.hpp"
+#include "app/Providers/ControllerServiceProvider.hpp"
+
+#ifdef BREEZE_ALLOCATION_TRACKING
+#include <breeze/support/allocation_hooks.hpp>
+#endif
+
+void register_web_routes(breeze::core::Application& app);
+void register_api_routes(breeze::core::Application& app);
+void register_admin_routes(breeze::core::Application& app);
 
 int main(int argc, char** argv) {
     breeze::core::CommandRegistry registry;
     registry.register_command(std::make_shared<breeze::commands::ServeCommand>());
+    // In-process benchmarks and replays run the same providers and routes as breeze_app
+    auto setup_app = [](breeze::core::Application& app) {
+        app.register_provider<::app::Providers::ViewServiceProvider>();
+        app.register_provider<::app::Providers::MiddlewareServiceProvider>();
+        app.register_provider<::app::Providers::ControllerServiceProvider>();
+        register_web_routes(app);
+        register_api_routes(app);
+        register_admin_routes(app);
+    };
+    registry.register_command(std::make_shared<breeze::commands::BenchCommand>(setup_app));
+    registry.register_command(std::make_shared<breeze::commands::ReplayCommand>(setup_app));
+    registry.register_command(std::make_shared<breeze::commands::ViewCacheCommand>());
 
     if (argc < 2) {
         std::cout << "Breeze Framework CLI\n\n";
@@ -28,18 +54,11 @@ int main(int argc, char** argv) {
     }
 
     std::unordered_map<std::string, std::string> options;
-    for (int i = 2; i < argc; ++i) {
-        std::string arg = argv[i];
-        if (arg.substr(0, 2) == "--") {
-            auto eq_pos = arg.find('=');
-            if (eq_pos != std::string::npos) {
-                options[arg.substr(2, eq_pos - 2)] = arg.substr(eq_pos + 1);
-            } else if (i + 1 < argc && argv[i+1][0] != '-') {
-                options[arg.substr(2)] = argv[++i];
-            } else {
-                options[arg.substr(2)] = "true";
-            }
-        }
+    try {
+        options = command->parse_arguments(std::vector<std::string>(argv + 2, argv + argc));
+    } catch (const std::invalid_argument& e) {
+        std::cerr << command_name << ": " << e.what() << "\n";
+        return 1;
     }
 
     return command->handle(options);
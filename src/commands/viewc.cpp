@@ -0,0 +1,74 @@
+// breeze_viewc <template> <output.cpp> <view name> [<views dir>]
+//
+// Build-time Blade -> C++ compiler behind breeze_add_views() (cmake/BreezeViews.cmake). The
+// output registers the view's generated render function with blade::register_compiled.
+// Layouts, partials and components are resolved against <views dir> and linked in; the files
+// used are listed in <output.cpp>.d (Makefile syntax) so the build regenerates on their edits.
+#include <breeze/support/blade_program.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Make-style depfile escaping: spaces and '#' are special in rule lines
+std::string depfile_path(const std::string& path) {
+    std::string out;
+    for (char c : path) {
+        if (c == ' ' || c == '#') out += '\\';
+        if (c == '$') out += '$';
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 4 && argc != 5) {
+        std::cerr << "usage: breeze_viewc <template> <output.cpp> <view name> [<views dir>]\n";
+        return 2;
+    }
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "breeze_viewc: cannot read " << argv[1] << "\n";
+        return 1;
+    }
+    std::string source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::filesystem::path views_dir = argc == 5 ? argv[4] : "resources/views";
+    std::vector<std::filesystem::path> dependencies;
+    std::string generated;
+    if (source.find("@cpp{") != std::string::npos) {
+        // Inline C++ runs when the template is first rendered, so such views stay interpreted
+        generated = "// " + std::string(argv[1]) + " uses @cpp{ } and is rendered by the interpreter.\n";
+    } else {
+        try {
+            generated = breeze::support::blade::generate_cpp(breeze::support::blade::compile(source, views_dir, &dependencies), argv[3], argv[1]);
+        } catch (const std::exception& e) {
+            std::cerr << "breeze_viewc: " << argv[1] << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out << generated;
+    if (!out) {
+        std::cerr << "breeze_viewc: cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::ofstream depfile(std::string(argv[2]) + ".d", std::ios::binary | std::ios::trunc);
+    depfile << depfile_path(argv[2]) << ":";
+    for (const auto& dependency : dependencies) depfile << " \\\n  " << depfile_path(dependency.string());
+    depfile << "\n";
+    if (!depfile) {
+        std::cerr << "breeze_viewc: cannot write " << argv[2] << ".d\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,26 +1,95 @@
 #include <breeze/core/kernel.hpp>
-#include <iostream>
+#include <breeze/core/request_scope.hpp>
+#include <breeze/support/access_log.hpp>
+#include <breeze/support/metrics.hpp>
+#include <breeze/support/tracing.hpp>
+#include <chrono>
+#include <optional>
 
 namespace breeze::core {
 
 breeze::http::Response Kernel::handle(const breeze::http::Request& request) const
 {
+    // Scoped services created while handling this request are released together at the end.
+    // Joins the server's scope, which stays open until a streamed body has been written, or
+    // opens one when the kernel is driven directly.
+    std::optional<RequestScope> owned_scope;
+    if (!RequestScope::current()) owned_scope.emplace();
+    // Joins the server's trace, or starts one when the kernel is driven directly
+    breeze::support::TraceScope trace_scope;
+    auto* trace = breeze::support::Trace::current();
+    if (trace) {
+        auto traceparent = request.header("traceparent");
+        if (!traceparent.empty()) trace->adopt_parent(traceparent);
+    }
+    auto started = std::chrono::steady_clock::now();
+    auto elapsed = [&started] {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    };
+    auto& access_log = breeze::support::AccessLog::instance();
+    auto& metrics = breeze::support::Metrics::instance();
+    breeze::http::Router::clear_matched_pattern();
+    // Label by route template, not raw path, so the series count stays bounded
+    auto route_label = [] {
+        const auto* pattern = breeze::http::Router::matched_pattern();
+        return pattern ? std::string_view(*pattern) : std::string_view("<unmatched>");
+    };
+
+    // Allocation tracking builds only: everything the application allocates for this request
+    std::optional<breeze::support::AllocationScope> allocation_scope;
+    if (breeze::support::allocations::available()) allocation_scope.emplace();
+    auto allocations = [&allocation_scope]() -> std::optional<breeze::support::AllocationCounts> {
+        if (!allocation_scope) return std::nullopt;
+        return allocation_scope->counts();
+    };
+
     try {
         // Run the middleware pipeline (which may call router_.dispatch)
         auto res = middleware_.run(request, [this](const breeze::http::Request& req) {
             return router_.dispatch(req);
         });
 
-        // Mandatory logging for every request (same format as RequestLogger)
-        std::string method = request.method();
-        std::string path = request.path();
-        std::string ip = request.header("x-remote-addr", "unknown");
-        int status = static_cast<int>(res.status());
-        std::cout << "[Request] " << method << " " << path << " - " << ip << " - " << status << std::endl;
-
+        // Every request is logged here, asynchronously (see AccessLog)
+        auto duration = elapsed();
+        auto allocated = allocations();
+        auto status = static_cast<int>(res.status());
+        if (trace) {
+            trace->describe(request.method(), request.path(), status);
+            if (breeze::support::Tracer::instance().server_timing()) {
+                res.set_header("Server-Timing", trace->server_timing());
+            }
+        }
+        if (res.streamed() && !owned_scope) {
+            // The body is produced after this returns, inside the server's scope: measure and
+            // log the request once it has been written
+            RequestScope::current()->defer([&access_log, &metrics, started, allocation_scope, status,
+                                            method = request.method(), path = request.path(),
+                                            remote = request.header("x-remote-addr", "unknown"),
+                                            route = std::string(route_label())] {
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+                std::optional<breeze::support::AllocationCounts> allocated;
+                if (allocation_scope) allocated = allocation_scope->counts();
+                access_log.log_request(method, path, remote, status, duration);
+                metrics.observe_request(method, route, status, duration, allocated ? &*allocated : nullptr);
+            });
+        } else {
+            access_log.log_request(request.method(), request.path(), request.header("x-remote-addr", "unknown"),
+                                   status, duration);
+            metrics.observe_request(request.method(), route_label(), status, duration,
+                                    allocated ? &*allocated : nullptr);
+        }
+        if (allocated && metrics.allocation_header()) {
+            res.set_header("X-Breeze-Allocations", std::to_string(allocated->allocations) +
+                                                   "; bytes=" + std::to_string(allocated->bytes));
+        }
         return res;
     } catch (const std::exception& e) {
-        std::cout << "[Request] " << request.method() << " " << request.path() << " - " << request.header("x-remote-addr", "unknown") << " - " << "500 (exception: " << e.what() << ")" << std::endl;
+        auto duration = elapsed();
+        auto allocated = allocations();
+        access_log.log_request(request.method(), request.path(), request.header("x-remote-addr", "unknown"),
+                               500, duration, std::string("exception: ") + e.what());
+        if (trace) trace->describe(request.method(), request.path(), 500);
+        metrics.observe_request(request.method(), route_label(), 500, duration, allocated ? &*allocated : nullptr);
         return breeze::http::Response::error(std::string("Kernel failed: ") + e.what());
     }
 }
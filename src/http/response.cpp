@@ -21,4 +21,21 @@ Response Response::view(const std::string& template_name, const nlohmann::json&
     return res;
 }
 
+Response Response::view_stream(const std::string& template_name, nlohmann::json data, std::size_t chunk_size) {
+    if (!breeze::core::Application::has_instance()) {
+        return Response::error("Application instance not initialized");
+    }
+    auto& app = breeze::core::Application::instance();
+    auto view_engine = app.container().make<breeze::support::View>();
+
+    if (!view_engine) {
+        return Response::error("View engine not found in container");
+    }
+
+    // The view renders after the handler has returned, so it owns its data
+    return Response::stream([view_engine, template_name, data = std::move(data), chunk_size](Stream& out) {
+        view_engine->stream(template_name, data, [&out](std::string_view chunk) { out.write(chunk); }, chunk_size);
+    });
+}
+
 } // namespace breeze::http
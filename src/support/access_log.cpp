@@ -0,0 +1,327 @@
+#include <breeze/support/access_log.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+namespace breeze::support {
+
+namespace {
+
+// Per-thread handle on a ring; marks it retired when the thread exits so the writer
+// can recycle it (the server spawns a thread per connection)
+struct ThreadRing {
+    std::shared_ptr<AccessLog::Ring> ring;
+    unsigned sample_counter = 0;
+    ~ThreadRing() {
+        if (ring) ring->retired.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRing thread_ring;
+
+template<std::size_t N>
+void copy_field(char (&dst)[N], std::string_view src) {
+    auto n = std::min(src.size(), N - 1);
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+LogLevel level_for_status(int status) {
+    if (status >= 500) return LogLevel::Error;
+    if (status >= 400) return LogLevel::Warning;
+    return LogLevel::Info;
+}
+
+const char* level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::Info: return "info";
+        case LogLevel::Warning: return "warning";
+        case LogLevel::Error: return "error";
+    }
+    return "info";
+}
+
+void append_json_escaped(std::string& out, const char* s) {
+    for (; *s; ++s) {
+        char c = *s;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+}
+
+} // namespace
+
+AccessLog& AccessLog::instance() {
+    static AccessLog log;
+    return log;
+}
+
+AccessLog::~AccessLog() {
+    stop();
+}
+
+void AccessLog::configure(AccessLogOptions options) {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = false;
+        writer_started_.store(false, std::memory_order_release);
+    }
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    options_ = std::move(options);
+    if (options_.sample_every == 0) options_.sample_every = 1;
+    min_level_.store(options_.min_level, std::memory_order_relaxed);
+    sample_every_.store(options_.sample_every, std::memory_order_relaxed);
+    enabled_.store(options_.enabled, std::memory_order_release);
+}
+
+void AccessLog::start_writer() noexcept {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    // Checked once per configure(): after stop() records wait for the next flush() or stop()
+    writer_started_.store(true, std::memory_order_release);
+    if (stopping_ || writer_.joinable()) return;
+    try {
+        writer_ = std::thread([this] { writer_loop(); });
+    } catch (...) {
+        // Records stay in the rings until flush() or stop() drains them
+    }
+}
+
+void AccessLog::log_request(std::string_view method, std::string_view path, std::string_view ip,
+                            int status, std::chrono::microseconds duration, std::string_view note) noexcept {
+    if (!enabled_.load(std::memory_order_acquire)) return;
+
+    auto level = level_for_status(status);
+    if (level < min_level_.load(std::memory_order_relaxed)) return;
+
+    // Sampling never hides errors
+    auto every = sample_every_.load(std::memory_order_relaxed);
+    if (every > 1 && level < LogLevel::Error && (++thread_ring.sample_counter % every) != 0) {
+        sampled_out_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!thread_ring.ring) {
+        try {
+            thread_ring.ring = acquire_ring();
+        } catch (...) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    auto& ring = *thread_ring.ring;
+    auto head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) == Ring::capacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& rec = ring.records[head & (Ring::capacity - 1)];
+    rec.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    rec.duration_us = static_cast<std::uint32_t>(std::min<std::int64_t>(duration.count(), UINT32_MAX));
+    rec.status = static_cast<std::uint16_t>(status);
+    rec.level = level;
+    copy_field(rec.method, method);
+    copy_field(rec.ip, ip);
+    copy_field(rec.path, path);
+    copy_field(rec.note, note);
+    ring.head.store(head + 1, std::memory_order_release);
+
+    if (!writer_started_.load(std::memory_order_acquire)) start_writer();
+}
+
+std::shared_ptr<AccessLog::Ring> AccessLog::acquire_ring() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    std::shared_ptr<Ring> ring;
+    if (!free_rings_.empty()) {
+        ring = std::move(free_rings_.back());
+        free_rings_.pop_back();
+        ring->retired.store(false, std::memory_order_relaxed);
+    } else {
+        ring = std::make_shared<Ring>();
+    }
+    rings_.push_back(ring);
+    return ring;
+}
+
+void AccessLog::writer_loop() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, options_.flush_interval, [this] { return stopping_; });
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+void AccessLog::flush() {
+    drain();
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    if (file_) std::fflush(file_);
+}
+
+void AccessLog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (writer_.joinable()) writer_.join();
+    drain();
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+std::filesystem::path AccessLog::file_path() const {
+    return options_.directory / options_.file_name;
+}
+
+void AccessLog::drain() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+    }
+
+    buffer_.clear();
+    std::uint64_t count = 0;
+    std::vector<Ring*> finished;
+    for (auto& ring : rings) {
+        // Read `retired` before the records: a retired ring gets no further writes
+        bool retired = ring->retired.load(std::memory_order_acquire);
+        auto tail = ring->tail.load(std::memory_order_relaxed);
+        auto head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail, ++count) {
+            format(ring->records[tail & (Ring::capacity - 1)], buffer_);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        if (retired) finished.push_back(ring.get());
+    }
+
+    if (!finished.empty()) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (auto* done : finished) {
+            auto it = std::find_if(rings_.begin(), rings_.end(), [done](const auto& r) { return r.get() == done; });
+            if (it == rings_.end()) continue;
+            free_rings_.push_back(std::move(*it));
+            rings_.erase(it);
+        }
+    }
+
+    if (!buffer_.empty()) {
+        write_out(buffer_);
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void AccessLog::format(const AccessRecord& rec, std::string& out) const {
+    if (options_.json) {
+        std::time_t secs = static_cast<std::time_t>(rec.timestamp_us / 1000000);
+        std::tm tm{};
+        gmtime_r(&secs, &tm);
+        char ts[40];
+        std::size_t n = std::strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%S", &tm);
+        std::snprintf(ts + n, sizeof(ts) - n, ".%06lldZ", static_cast<long long>(rec.timestamp_us % 1000000));
+
+        out += "{\"ts\":\"";
+        out += ts;
+        out += "\",\"level\":\"";
+        out += level_name(rec.level);
+        out += "\",\"method\":\"";
+        append_json_escaped(out, rec.method);
+        out += "\",\"path\":\"";
+        append_json_escaped(out, rec.path);
+        out += "\",\"status\":";
+        out += std::to_string(rec.status);
+        out += ",\"duration_us\":";
+        out += std::to_string(rec.duration_us);
+        out += ",\"ip\":\"";
+        append_json_escaped(out, rec.ip);
+        out += '"';
+        if (rec.note[0]) {
+            out += ",\"note\":\"";
+            append_json_escaped(out, rec.note);
+            out += '"';
+        }
+        out += "}\n";
+        return;
+    }
+
+    // Same shape as the previous console line, plus the duration
+    out += "[Request] ";
+    out += rec.method;
+    out += ' ';
+    out += rec.path;
+    out += " - ";
+    out += rec.ip;
+    out += " - ";
+    out += std::to_string(rec.status);
+    if (rec.note[0]) {
+        out += " (";
+        out += rec.note;
+        out += ')';
+    }
+    out += " - ";
+    out += std::to_string(rec.duration_us);
+    out += "us\n";
+}
+
+void AccessLog::write_out(const std::string& lines) {
+    if (options_.console) {
+        std::fwrite(lines.data(), 1, lines.size(), stdout);
+        std::fflush(stdout);
+    }
+
+    if (!file_) {
+        std::error_code ec;
+        std::filesystem::create_directories(options_.directory, ec);
+        file_ = std::fopen(file_path().c_str(), "ab");
+        if (!file_) return;
+        file_bytes_ = static_cast<std::size_t>(std::filesystem::file_size(file_path(), ec));
+        if (ec) file_bytes_ = 0;
+    }
+
+    std::fwrite(lines.data(), 1, lines.size(), file_);
+    file_bytes_ += lines.size();
+    if (options_.max_file_bytes > 0 && file_bytes_ >= options_.max_file_bytes) rotate();
+}
+
+void AccessLog::rotate() {
+    std::fclose(file_);
+    file_ = nullptr;
+    file_bytes_ = 0;
+
+    std::error_code ec;
+    auto base = file_path().string();
+    if (options_.max_files == 0) {
+        std::filesystem::remove(base, ec);
+        return;
+    }
+    std::filesystem::remove(base + "." + std::to_string(options_.max_files), ec);
+    for (unsigned i = options_.max_files; i > 1; --i) {
+        std::filesystem::rename(base + "." + std::to_string(i - 1), base + "." + std::to_string(i), ec);
+    }
+    std::filesystem::rename(base, base + ".1", ec);
+}
+
+} // namespace breeze::support
@@ -1,7 +1,10 @@
 #include <breeze/support/blade.hpp>
-#include <breeze/core/application.hpp>
+#include <breeze/support/blade_program.hpp>
+#include <breeze/support/fragment_cache.hpp>
+#include <breeze/support/str.hpp>
+#include <breeze/support/tracing.hpp>
+#include <breeze/support/view.hpp>
 
-#include <regex>
 #include <sstream>
 #include <cctype>
 #include <algorithm>
@@ -11,9 +14,19 @@
 #include <mutex>
 #include <list>
 #include <chrono>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <optional>
 #include <fstream>
+#include <iostream>
+#include <atomic>
+#include <cstring>
 #include <openssl/sha.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace breeze::support {
 
@@ -33,31 +46,6 @@ static std::string trim(const std::string& s) {
     return s.substr(a, b - a);
 }
 
-static std::string html_escape(const std::string& s) {
-    std::string out; out.reserve(s.size());
-    for (char c : s) {
-        switch (c) {
-            case '&': out += "&amp;"; break;
-            case '<': out += "&lt;"; break;
-            case '>': out += "&gt;"; break;
-            case '"': out += "&quot;"; break;
-            case '\'': out += "&#39;"; break;
-            default: out.push_back(c); break;
-        }
-    }
-    return out;
-}
-
-static std::string to_upper(std::string s) {
-    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return static_cast<char>(std::toupper(c)); });
-    return s;
-}
-
-static std::string to_lower(std::string s) {
-    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
-    return s;
-}
-
 // Resolve dotted json path, return nullptr if not found
 static const nlohmann::json* get_json_ptr(const std::string& key, const nlohmann::json& data) {
     auto parts = split_dot(key);
@@ -78,15 +66,6 @@ static std::string resolve_data_simple(const std::string& key, const nlohmann::j
     return std::string{};
 }
 
-static bool is_truthy_value(const nlohmann::json& current) {
-    if (current.is_boolean()) return current.get<bool>();
-    if (current.is_null()) return false;
-    if (current.is_string()) return !current.get<std::string>().empty();
-    if (current.is_number()) return current.get<double>() != 0;
-    if (current.is_array() || current.is_object()) return !current.empty();
-    return true;
-}
-
 // --- expression parsing with errors ---
 struct ExprError : public std::runtime_error {
     std::string expr;
@@ -94,136 +73,1300 @@ struct ExprError : public std::runtime_error {
     ExprError(std::string m, std::string e, size_t p) : std::runtime_error(m), expr(std::move(e)), pos(p) {}
 };
 
-class ExprParser {
+// --- Template AST and compilation caching ---
+struct FilterSpec { std::string name; std::string arg; };
+struct Node {
+    enum Type { TEXT, VAR, IF, UNLESS, FOREACH, EXTENDS, SECTION, YIELD, INCLUDE, COMPONENT, SLOT, CACHE } type;
+    std::string text; // for TEXT; CACHE: ttl expression
+    std::string expr; // for VAR or IF condition; SECTION / YIELD: inline value or default expression; CACHE: key
+    std::string name; // view name for EXTENDS / INCLUDE / COMPONENT, section name for SECTION / YIELD / SLOT
+    std::vector<FilterSpec> filters; // for VAR
+    bool raw = false;                // VAR written as {!! !!}: never auto-escaped
+    std::vector<std::shared_ptr<Node>> children; // for blocks
+    // foreach specifics
+    std::string list_name;
+    std::string item_name;
+};
+
+// forward declaration of parse_nodes so compilation unit can reference it earlier
+static std::vector<std::shared_ptr<Node>> parse_nodes(std::string_view s);
+
+// --- compilation to blade::Program ---
+namespace blade {
+
+namespace {
+
+std::uint32_t add_string(Program& program, std::string_view text) {
+    auto offset = static_cast<std::uint32_t>(program.pool.size());
+    program.pool.append(text);
+    return offset;
+}
+
+// Evaluation result. Strings and containers from the context are borrowed, never copied.
+struct Value {
+    enum class Kind : std::uint8_t { Null, Bool, Int, Number, String, Owned, Json };
+    Kind kind = Kind::Null;
+    bool boolean = false;
+    std::int64_t integer = 0;
+    double number = 0;
+    std::string_view string;
+    const nlohmann::json* json = nullptr;   // arrays and objects
+    std::string owned;                      // results of string concatenation
+
+    static Value of(bool b) { Value v; v.kind = Kind::Bool; v.boolean = b; return v; }
+    static Value of(double d) { Value v; v.kind = Kind::Number; v.number = d; return v; }
+    static Value of(std::string_view s) { Value v; v.kind = Kind::String; v.string = s; return v; }
+    static Value of_int(std::size_t i) { Value v; v.kind = Kind::Int; v.integer = static_cast<std::int64_t>(i); return v; }
+
+    static Value of(const nlohmann::json& j) {
+        Value v;
+        switch (j.type()) {
+            case nlohmann::json::value_t::null: break;
+            case nlohmann::json::value_t::boolean: v.kind = Kind::Bool; v.boolean = j.get<bool>(); break;
+            case nlohmann::json::value_t::number_integer: v.kind = Kind::Int; v.integer = j.get<std::int64_t>(); break;
+            case nlohmann::json::value_t::number_unsigned: {
+                auto u = j.get<std::uint64_t>();
+                if (u <= static_cast<std::uint64_t>(INT64_MAX)) { v.kind = Kind::Int; v.integer = static_cast<std::int64_t>(u); }
+                else { v.kind = Kind::Number; v.number = static_cast<double>(u); }
+                break;
+            }
+            case nlohmann::json::value_t::number_float: v.kind = Kind::Number; v.number = j.get<double>(); break;
+            case nlohmann::json::value_t::string: v.kind = Kind::String; v.string = j.get_ref<const std::string&>(); break;
+            default: v.kind = Kind::Json; v.json = &j; break;
+        }
+        return v;
+    }
+
+    bool is_number() const { return kind == Kind::Int || kind == Kind::Number; }
+    double as_double() const { return kind == Kind::Int ? static_cast<double>(integer) : number; }
+    bool is_string() const { return kind == Kind::String || kind == Kind::Owned; }
+    std::string_view text() const { return kind == Kind::Owned ? std::string_view(owned) : string; }
+
+    bool truthy() const {
+        switch (kind) {
+            case Kind::Null: return false;
+            case Kind::Bool: return boolean;
+            case Kind::Int: return integer != 0;
+            case Kind::Number: return number != 0;
+            case Kind::String: case Kind::Owned: return !text().empty();
+            case Kind::Json: return !json->empty();
+        }
+        return true;
+    }
+};
+
+// Same spelling as nlohmann::json::dump for doubles: shortest round-trip, always with a fraction
+void append_double(std::string& out, double d) {
+    if (!std::isfinite(d)) { out += "null"; return; }
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), d);
+    std::string_view digits(buf, static_cast<std::size_t>(end - buf));
+    out += digits;
+    if (digits.find_first_of(".e") == std::string_view::npos) out += ".0";
+}
+
+void append_int(std::string& out, std::int64_t i) {
+    char buf[24];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), i);
+    out.append(buf, static_cast<std::size_t>(end - buf));
+}
+
+// {{ }} output: null renders as nothing
+void append_echo(std::string& out, const Value& v) {
+    switch (v.kind) {
+        case Value::Kind::Null: break;
+        case Value::Kind::Bool: out += v.boolean ? "true" : "false"; break;
+        case Value::Kind::Int: append_int(out, v.integer); break;
+        case Value::Kind::Number: append_double(out, v.number); break;
+        case Value::Kind::String: case Value::Kind::Owned: out += v.text(); break;
+        case Value::Kind::Json: out += v.json->dump(); break;
+    }
+}
+
+// Operand text for string comparison and concatenation: null is spelled out
+std::string plain_text(const Value& v) {
+    if (v.is_string()) return std::string(v.text());
+    if (v.kind == Value::Kind::Null) return "null";
+    std::string out;
+    append_echo(out, v);
+    return out;
+}
+
+bool compare(const Value& left, BinOp op, const Value& right) {
+    if (left.is_number() && right.is_number()) {
+        double a = left.as_double(), b = right.as_double();
+        switch (op) {
+            case BinOp::Eq: return a == b; case BinOp::Ne: return a != b;
+            case BinOp::Lt: return a < b;  case BinOp::Gt: return a > b;
+            case BinOp::Le: return a <= b; case BinOp::Ge: return a >= b;
+            default: return false;
+        }
+    }
+    if (left.kind == Value::Kind::Bool && right.kind == Value::Kind::Bool) {
+        if (op == BinOp::Eq) return left.boolean == right.boolean;
+        if (op == BinOp::Ne) return left.boolean != right.boolean;
+        return false;
+    }
+    // Strings compare in place; anything else through its text form
+    std::string left_buf, right_buf;
+    std::string_view a = left.is_string() ? left.text() : std::string_view(left_buf = plain_text(left));
+    std::string_view b = right.is_string() ? right.text() : std::string_view(right_buf = plain_text(right));
+    switch (op) {
+        case BinOp::Eq: return a == b; case BinOp::Ne: return a != b;
+        case BinOp::Lt: return a < b;  case BinOp::Gt: return a > b;
+        case BinOp::Le: return a <= b; case BinOp::Ge: return a >= b;
+        default: return false;
+    }
+}
+
+bool is_literal(const Expr& e) {
+    return e.kind == ExprKind::Null || e.kind == ExprKind::Bool || e.kind == ExprKind::Number || e.kind == ExprKind::String;
+}
+
+// Context for evaluating constants at compile time
+const nlohmann::json& empty_context() {
+    static const nlohmann::json empty;
+    return empty;
+}
+
+// One active @foreach: the loop variable is a view of list[index], never a copy
+struct LoopFrame {
+    const nlohmann::json* list = nullptr;
+    std::size_t index = 0;
+    std::string_view name;
+};
+
+// Evaluates expression trees against the root context plus the scope of enclosing loops
+class Evaluator {
 public:
-    ExprParser(const std::string& s, const nlohmann::json& ctx) : str_(s), pos_(0), ctx_(ctx) {}
+    Evaluator(const ProgramView& program, const nlohmann::json& context) : program_(program), root_(&context) {}
+
+    std::vector<LoopFrame>& loops() { return loops_; }
+    const nlohmann::json& root() const { return *root_; }
+
+    Value eval(std::uint32_t index) const {
+        const auto& e = program_.exprs[index];
+        switch (e.kind) {
+            case ExprKind::Null: return {};
+            case ExprKind::Bool: return Value::of(e.boolean);
+            case ExprKind::Number: return Value::of(e.number);
+            case ExprKind::String: return Value::of(program_.str(e.str, e.len));
+            case ExprKind::Path: {
+                const auto* found = lookup(e);
+                return found ? Value::of(*found) : Value{};
+            }
+            case ExprKind::LoopVar: return loop_variable(e);
+            case ExprKind::Not: return Value::of(!eval(e.lhs).truthy());
+            case ExprKind::Negate: {
+                auto v = eval(e.lhs);
+                if (!v.is_number()) fail(e, "Unary - applied to non-number");
+                return Value::of(-v.as_double());
+            }
+            case ExprKind::And: return Value::of(eval(e.lhs).truthy() && eval(e.rhs).truthy());
+            case ExprKind::Or: return Value::of(eval(e.lhs).truthy() || eval(e.rhs).truthy());
+            case ExprKind::Compare: return Value::of(compare(eval(e.lhs), e.op, eval(e.rhs)));
+            case ExprKind::Arith: return arithmetic(e, eval(e.lhs), eval(e.rhs));
+        }
+        return {};
+    }
+
+    bool test(std::uint32_t index) const { return eval(index).truthy(); }
 
-    nlohmann::json eval() {
+    // Resolve a pre-split path; nullptr when any component is missing. The first component
+    // is looked up in the loop scopes, innermost first, so loop variables shadow the root.
+    const nlohmann::json* lookup(const Expr& e) const {
+        const nlohmann::json* current = root_;
+        std::uint32_t i = 0;
+        if (!loops_.empty()) {
+            const auto& first = program_.segments[e.str];
+            auto name = program_.str(first.str, first.len);
+            for (auto frame = loops_.rbegin(); frame != loops_.rend(); ++frame) {
+                if (frame->name == name) {
+                    current = &(*frame->list)[frame->index];
+                    i = 1;
+                    break;
+                }
+            }
+        }
+        for (; i < e.len; ++i) {
+            const auto& seg = program_.segments[e.str + i];
+            if (current->is_object()) {
+                auto it = current->find(program_.str(seg.str, seg.len));
+                if (it == current->end()) return nullptr;
+                current = &*it;
+            } else if (current->is_array() && seg.index >= 0 && static_cast<std::size_t>(seg.index) < current->size()) {
+                current = &(*current)[static_cast<std::size_t>(seg.index)];
+            } else {
+                return nullptr;
+            }
+        }
+        return current;
+    }
+
+private:
+    [[noreturn]] void fail(const Expr& e, const char* message) const {
+        throw ExprError(message, std::string(program_.str(e.source, e.source_len)), e.pos);
+    }
+
+    // $loop metadata is derived from the frame; null outside a loop (or past the outermost parent)
+    Value loop_variable(const Expr& e) const {
+        if (e.len >= loops_.size()) return {};
+        auto depth = loops_.size() - e.len;
+        const auto& frame = loops_[depth - 1];
+        auto count = frame.list->size();
+        switch (static_cast<LoopField>(e.str)) {
+            case LoopField::Index: return Value::of_int(frame.index);
+            case LoopField::Iteration: return Value::of_int(frame.index + 1);
+            case LoopField::Remaining: return Value::of_int(count - frame.index - 1);
+            case LoopField::Count: return Value::of_int(count);
+            case LoopField::First: return Value::of(frame.index == 0);
+            case LoopField::Last: return Value::of(frame.index + 1 == count);
+            case LoopField::Even: return Value::of((frame.index + 1) % 2 == 0);
+            case LoopField::Odd: return Value::of((frame.index + 1) % 2 == 1);
+            case LoopField::Depth: return Value::of_int(depth);
+        }
+        return {};
+    }
+
+    Value arithmetic(const Expr& e, const Value& left, const Value& right) const {
+        if (left.is_number() && right.is_number()) {
+            double a = left.as_double(), b = right.as_double();
+            switch (e.op) {
+                case BinOp::Add: return Value::of(a + b);
+                case BinOp::Sub: return Value::of(a - b);
+                case BinOp::Mul: return Value::of(a * b);
+                case BinOp::Div: if (b == 0) fail(e, "Division by zero"); return Value::of(a / b);
+                case BinOp::Mod: if (b == 0) fail(e, "Division by zero for modulus"); return Value::of(std::fmod(a, b));
+                default: break;
+            }
+        }
+        if (e.op == BinOp::Add) {
+            Value v;
+            v.kind = Value::Kind::Owned;
+            v.owned = plain_text(left);
+            v.owned += plain_text(right);
+            return v;
+        }
+        fail(e, "Arithmetic operation on non-numeric operands");
+    }
+
+    ProgramView program_;
+    const nlohmann::json* root_;
+    std::vector<LoopFrame> loops_;
+};
+
+// Recursive-descent parser producing Expr nodes; literal-only subtrees are folded
+class ExprCompiler {
+public:
+    ExprCompiler(Program& program, std::string_view source)
+        : program_(program), src_(source), source_(add_string(program, source)) {}
+
+    std::uint32_t compile() {
         skip_ws();
-        auto v = parse_or();
+        auto root = parse_or();
         skip_ws();
-        return v;
+        return root;
     }
 
-    bool eval_bool() {
-        return is_truthy_value(eval());
+private:
+    Program& program_;
+    std::string_view src_;
+    std::uint32_t source_;
+    std::size_t pos_ = 0;
+
+    void skip_ws() { while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_]))) ++pos_; }
+    bool starts_with(std::string_view t) const { return src_.substr(pos_, t.size()) == t; }
+    [[noreturn]] void fail(const char* message) const { throw ExprError(message, std::string(src_), pos_); }
+
+    std::uint32_t node(Expr e) {
+        e.source = source_;
+        e.source_len = static_cast<std::uint32_t>(src_.size());
+        e.pos = static_cast<std::uint32_t>(pos_);
+        program_.exprs.push_back(e);
+        return static_cast<std::uint32_t>(program_.exprs.size() - 1);
     }
 
-private:
-    std::string str_;
-    size_t pos_;
-    const nlohmann::json& ctx_;
+    std::uint32_t unary(ExprKind kind, std::uint32_t operand) {
+        Expr e; e.kind = kind; e.lhs = operand;
+        return fold(node(e));
+    }
+
+    std::uint32_t binary(ExprKind kind, BinOp op, std::uint32_t lhs, std::uint32_t rhs) {
+        Expr e; e.kind = kind; e.op = op; e.lhs = lhs; e.rhs = rhs;
+        return fold(node(e));
+    }
 
-    void skip_ws() { while (pos_ < str_.size() && std::isspace(static_cast<unsigned char>(str_[pos_]))) ++pos_; }
-    bool starts_with(const std::string& t) { return str_.substr(pos_, t.size()) == t; }
+    // Constant folding: evaluate once now if every operand is a literal. Errors (e.g. a
+    // literal division by zero) are left for render time so they surface in the output.
+    std::uint32_t fold(std::uint32_t index) {
+        auto e = program_.exprs[index];
+        bool constant = is_literal(program_.exprs[e.lhs]) &&
+                        (e.kind == ExprKind::Not || e.kind == ExprKind::Negate || is_literal(program_.exprs[e.rhs]));
+        if (!constant) return index;
+        Value v;
+        try {
+            v = Evaluator(program_, empty_context()).eval(index);
+        } catch (const ExprError&) {
+            return index;
+        }
+        Expr literal;
+        literal.source = e.source;
+        literal.source_len = e.source_len;
+        literal.pos = e.pos;
+        switch (v.kind) {
+            case Value::Kind::Bool: literal.kind = ExprKind::Bool; literal.boolean = v.boolean; break;
+            case Value::Kind::Number: literal.kind = ExprKind::Number; literal.number = v.number; break;
+            case Value::Kind::Int: literal.kind = ExprKind::Number; literal.number = static_cast<double>(v.integer); break;
+            case Value::Kind::String: case Value::Kind::Owned: {
+                std::string text(v.text());
+                literal.kind = ExprKind::String;
+                literal.str = add_string(program_, text);
+                literal.len = static_cast<std::uint32_t>(text.size());
+                break;
+            }
+            default: literal.kind = ExprKind::Null; break;
+        }
+        program_.exprs[index] = literal;
+        return index;
+    }
 
-    nlohmann::json parse_or() {
+    std::uint32_t parse_or() {
         auto left = parse_and(); skip_ws();
-        while (starts_with("||")) { pos_ += 2; skip_ws(); auto right = parse_and(); left = (is_truthy_value(left) || is_truthy_value(right)); skip_ws(); }
+        while (starts_with("||")) { pos_ += 2; skip_ws(); auto right = parse_and(); left = binary(ExprKind::Or, BinOp::Eq, left, right); skip_ws(); }
         return left;
     }
 
-    nlohmann::json parse_and() {
+    std::uint32_t parse_and() {
         auto left = parse_comparison(); skip_ws();
-        while (starts_with("&&")) { pos_ += 2; skip_ws(); auto right = parse_comparison(); left = (is_truthy_value(left) && is_truthy_value(right)); skip_ws(); }
+        while (starts_with("&&")) { pos_ += 2; skip_ws(); auto right = parse_comparison(); left = binary(ExprKind::And, BinOp::Eq, left, right); skip_ws(); }
         return left;
     }
 
-    nlohmann::json parse_comparison() {
+    std::uint32_t parse_comparison() {
         auto left = parse_additive(); skip_ws();
-        const std::vector<std::string> ops = {"==","!=" , ">=","<=","<",">"};
-        for (auto& op : ops) {
-            if (starts_with(op)) {
-                pos_ += op.size(); skip_ws(); auto right = parse_additive(); return compare_values(left, op, right);
+        static constexpr std::pair<std::string_view, BinOp> ops[] = {
+            {"==", BinOp::Eq}, {"!=", BinOp::Ne}, {">=", BinOp::Ge}, {"<=", BinOp::Le}, {"<", BinOp::Lt}, {">", BinOp::Gt}};
+        for (const auto& [text, op] : ops) {
+            if (starts_with(text)) {
+                pos_ += text.size(); skip_ws();
+                auto right = parse_additive();
+                return binary(ExprKind::Compare, op, left, right);
             }
         }
         return left;
     }
 
-    nlohmann::json parse_additive() {
+    std::uint32_t parse_additive() {
         auto left = parse_multiplicative(); skip_ws();
-        while (pos_ < str_.size()) {
-            if (starts_with("+")) { ++pos_; skip_ws(); auto right = parse_multiplicative(); left = arithmetic_op(left, right, '+'); skip_ws(); continue; }
-            if (starts_with("-")) { ++pos_; skip_ws(); auto right = parse_multiplicative(); left = arithmetic_op(left, right, '-'); skip_ws(); continue; }
-            break;
+        while (pos_ < src_.size() && (src_[pos_] == '+' || src_[pos_] == '-')) {
+            auto op = src_[pos_++] == '+' ? BinOp::Add : BinOp::Sub;
+            skip_ws();
+            auto right = parse_multiplicative();
+            left = binary(ExprKind::Arith, op, left, right);
+            skip_ws();
         }
         return left;
     }
 
-    nlohmann::json parse_multiplicative() {
+    std::uint32_t parse_multiplicative() {
         auto left = parse_unary(); skip_ws();
-        while (pos_ < str_.size()) {
-            if (starts_with("*")) { ++pos_; skip_ws(); auto right = parse_unary(); left = arithmetic_op(left, right, '*'); skip_ws(); continue; }
-            if (starts_with("/")) { ++pos_; skip_ws(); auto right = parse_unary(); left = arithmetic_op(left, right, '/'); skip_ws(); continue; }
-            if (starts_with("%")) { ++pos_; skip_ws(); auto right = parse_unary(); left = arithmetic_op(left, right, '%'); skip_ws(); continue; }
-            break;
+        while (pos_ < src_.size() && (src_[pos_] == '*' || src_[pos_] == '/' || src_[pos_] == '%')) {
+            char c = src_[pos_++];
+            auto op = c == '*' ? BinOp::Mul : c == '/' ? BinOp::Div : BinOp::Mod;
+            skip_ws();
+            auto right = parse_unary();
+            left = binary(ExprKind::Arith, op, left, right);
+            skip_ws();
         }
         return left;
     }
 
-    nlohmann::json parse_unary() {
+    std::uint32_t parse_unary() {
         skip_ws();
-        if (starts_with("!")) { ++pos_; skip_ws(); auto v = parse_unary(); return !is_truthy_value(v); }
-        if (starts_with("-")) { ++pos_; skip_ws(); auto v = parse_unary(); if (v.is_number()) return -v.get<double>(); throw ExprError("Unary - applied to non-number","",pos_); }
+        if (starts_with("!")) { ++pos_; skip_ws(); return unary(ExprKind::Not, parse_unary()); }
+        if (starts_with("-")) { ++pos_; skip_ws(); return unary(ExprKind::Negate, parse_unary()); }
         return parse_primary();
     }
 
-    nlohmann::json parse_primary() {
-        skip_ws(); if (pos_ >= str_.size()) return nullptr;
-        if (str_[pos_] == '(') { ++pos_; skip_ws(); auto v = parse_or(); skip_ws(); if (pos_ < str_.size() && str_[pos_] == ')') ++pos_; else throw ExprError("Missing closing parenthesis", str_, pos_); return v; }
-        if (str_[pos_] == '"' || str_[pos_] == '\'') {
-            char quote = str_[pos_++]; std::string out; while (pos_ < str_.size() && str_[pos_] != quote) { if (str_[pos_] == '\\' && pos_ + 1 < str_.size()) { out.push_back(str_[pos_ + 1]); pos_ += 2; continue; } out.push_back(str_[pos_++]); } if (pos_ < str_.size() && str_[pos_] == quote) ++pos_; return out; }
-        if (std::isalpha(static_cast<unsigned char>(str_[pos_])) || str_[pos_] == '_') {
-            size_t start = pos_; while (pos_ < str_.size() && (std::isalnum(static_cast<unsigned char>(str_[pos_])) || str_[pos_] == '_' || str_[pos_] == '.')) ++pos_;
-            std::string tok = str_.substr(start, pos_ - start);
-            if (tok == "true") return true; if (tok == "false") return false; if (tok == "null") return nullptr;
-            if (auto p = get_json_ptr(tok, ctx_); p) return *p; return nullptr;
+    // $loop[.parent]*.field
+    std::uint32_t loop_variable(std::string_view token, Expr e) {
+        static constexpr std::pair<std::string_view, LoopField> fields[] = {
+            {"index", LoopField::Index}, {"iteration", LoopField::Iteration}, {"remaining", LoopField::Remaining},
+            {"count", LoopField::Count}, {"first", LoopField::First}, {"last", LoopField::Last},
+            {"even", LoopField::Even}, {"odd", LoopField::Odd}, {"depth", LoopField::Depth}};
+        auto rest = token.substr(4);
+        std::uint32_t hops = 0;
+        while (rest.starts_with(".parent")) { rest.remove_prefix(7); ++hops; }
+        for (const auto& [name, field] : fields) {
+            if (rest.size() == name.size() + 1 && rest[0] == '.' && rest.substr(1) == name) {
+                e.kind = ExprKind::LoopVar;
+                e.str = static_cast<std::uint32_t>(field);
+                e.len = hops;
+                return node(e);
+            }
+        }
+        fail("Unknown $loop property");
+    }
+
+    std::uint32_t parse_primary() {
+        skip_ws();
+        Expr e;
+        if (pos_ >= src_.size()) return node(e);
+        char c = src_[pos_];
+        if (c == '(') {
+            ++pos_; skip_ws();
+            auto inner = parse_or(); skip_ws();
+            if (pos_ < src_.size() && src_[pos_] == ')') ++pos_; else fail("Missing closing parenthesis");
+            return inner;
+        }
+        if (c == '"' || c == '\'') {
+            char quote = src_[pos_++];
+            std::string text;
+            while (pos_ < src_.size() && src_[pos_] != quote) {
+                if (src_[pos_] == '\\' && pos_ + 1 < src_.size()) { text.push_back(src_[pos_ + 1]); pos_ += 2; continue; }
+                text.push_back(src_[pos_++]);
+            }
+            if (pos_ < src_.size()) ++pos_;
+            e.kind = ExprKind::String;
+            e.str = add_string(program_, text);
+            e.len = static_cast<std::uint32_t>(text.size());
+            return node(e);
+        }
+        bool sigil = c == '$' && pos_ + 1 < src_.size() &&
+                     (std::isalpha(static_cast<unsigned char>(src_[pos_ + 1])) || src_[pos_ + 1] == '_');
+        if (sigil || std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            // `$user.name` is accepted as a Laravel-style spelling of `user.name`
+            if (sigil) ++pos_;
+            auto start = pos_;
+            while (pos_ < src_.size() && (std::isalnum(static_cast<unsigned char>(src_[pos_])) || src_[pos_] == '_' || src_[pos_] == '.')) ++pos_;
+            auto token = src_.substr(start, pos_ - start);
+            if (!sigil && (token == "true" || token == "false")) { e.kind = ExprKind::Bool; e.boolean = token == "true"; return node(e); }
+            if (!sigil && token == "null") return node(e);
+            if (sigil && (token == "loop" || token.starts_with("loop."))) return loop_variable(token, e);
+            e.kind = ExprKind::Path;
+            e.str = static_cast<std::uint32_t>(program_.segments.size());
+            std::size_t begin = 0;
+            while (true) {
+                auto dot = token.find('.', begin);
+                auto part = token.substr(begin, dot == std::string_view::npos ? std::string_view::npos : dot - begin);
+                Segment seg;
+                seg.str = add_string(program_, part);
+                seg.len = static_cast<std::uint32_t>(part.size());
+                if (!part.empty() && part.size() < 10 && std::all_of(part.begin(), part.end(), [](unsigned char ch) { return std::isdigit(ch); })) {
+                    seg.index = std::stoi(std::string(part));
+                }
+                program_.segments.push_back(seg);
+                if (dot == std::string_view::npos) break;
+                begin = dot + 1;
+            }
+            e.len = static_cast<std::uint32_t>(program_.segments.size()) - e.str;
+            return node(e);
+        }
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            auto start = pos_;
+            while (pos_ < src_.size() && std::isdigit(static_cast<unsigned char>(src_[pos_]))) ++pos_;
+            if (pos_ < src_.size() && src_[pos_] == '.') {
+                ++pos_;
+                while (pos_ < src_.size() && std::isdigit(static_cast<unsigned char>(src_[pos_]))) ++pos_;
+            }
+            e.kind = ExprKind::Number;
+            try { e.number = std::stod(std::string(src_.substr(start, pos_ - start))); }
+            catch (...) { pos_ = start; fail("Invalid number literal"); }
+            return node(e);
+        }
+        fail("Unexpected token in expression");
+    }
+};
+
+std::string error_text(const ExprError& e) {
+    std::ostringstream oss; oss << "[Template Error: expr=\"" << e.expr << "\" pos=" << e.pos << " msg=" << e.what() << "]";
+    return oss.str();
+}
+
+std::string error_text(const std::exception& e) {
+    return std::string("[Template Error: msg=") + e.what() + "]";
+}
+
+// Lowers the parsed node tree into instructions
+class ProgramBuilder {
+public:
+    explicit ProgramBuilder(Program& program) : program_(program) {}
+
+    void build(const std::vector<std::shared_ptr<Node>>& list) {
+        nodes(list);
+        flush();
+    }
+
+private:
+    Program& program_;
+    std::string pending_;   // text not yet emitted; adjacent text and folded constants merge here
+
+    void nodes(const std::vector<std::shared_ptr<Node>>& list) {
+        for (const auto& n : list) node(*n);
+    }
+
+    void flush() {
+        if (pending_.empty()) return;
+        program_.code.push_back({Op::Text, add_string(program_, pending_), static_cast<std::uint32_t>(pending_.size()), 0});
+        pending_.clear();
+    }
+
+    // Index of the next instruction; used as a jump target, so pending text must land first
+    std::uint32_t here() {
+        flush();
+        return static_cast<std::uint32_t>(program_.code.size());
+    }
+
+    void emit(Op op, std::uint32_t a = 0, std::uint32_t b = 0, std::uint32_t c = 0) {
+        flush();
+        program_.code.push_back({op, a, b, c});
+    }
+
+    void text(std::string_view s) { pending_.append(s); }
+
+    std::optional<std::uint32_t> expression(const std::string& source) {
+        try {
+            return ExprCompiler(program_, source).compile();
+        } catch (const ExprError& e) {
+            text(error_text(e));
+            return std::nullopt;
         }
-        if (std::isdigit(static_cast<unsigned char>(str_[pos_])) || (str_[pos_] == '-' && pos_ + 1 < str_.size() && std::isdigit(static_cast<unsigned char>(str_[pos_ + 1])))) {
-            size_t start = pos_; if (str_[pos_] == '-') ++pos_; while (pos_ < str_.size() && std::isdigit(static_cast<unsigned char>(str_[pos_]))) ++pos_; if (pos_ < str_.size() && str_[pos_] == '.') { ++pos_; while (pos_ < str_.size() && std::isdigit(static_cast<unsigned char>(str_[pos_]))) ++pos_; }
-            std::string num = str_.substr(start, pos_ - start); try { return std::stod(num); } catch (...) { throw ExprError("Invalid number literal", str_, start); }
+    }
+
+    void node(const Node& n) {
+        switch (n.type) {
+            case Node::TEXT: text(n.text); break;
+            case Node::VAR: echo(n); break;
+            case Node::IF: case Node::UNLESS: conditional(n); break;
+            case Node::FOREACH: loop(n); break;
+            case Node::CACHE: cache(n); break;
+            // resolved by the Linker before lowering
+            case Node::EXTENDS: case Node::SECTION: case Node::YIELD: case Node::INCLUDE:
+            case Node::COMPONENT: case Node::SLOT: break;
         }
-        throw ExprError("Unexpected token in expression", str_, pos_);
     }
 
-    nlohmann::json compare_values(const nlohmann::json& left, const std::string& op, const nlohmann::json& right) {
-        if (left.is_number() && right.is_number()) {
-            double a = left.get<double>(); double b = right.get<double>();
-            if (op == "==") return a == b; if (op == "!=") return a != b; if (op == ">") return a > b; if (op == "<") return a < b; if (op == ">=") return a >= b; if (op == "<=") return a <= b;
+    void echo(const Node& n) {
+        auto expr = expression(n.expr);
+        if (!expr) return;
+        auto first = static_cast<std::uint32_t>(program_.filters.size());
+        for (const auto& f : n.filters) {
+            FilterCall call;
+            if (f.name == "escape") call.id = FilterId::Escape;
+            else if (f.name == "upper") call.id = FilterId::Upper;
+            else if (f.name == "lower") call.id = FilterId::Lower;
+            else if (f.name == "trim") call.id = FilterId::Trim;
+            else if (f.name == "truncate") call.id = FilterId::Truncate;
+            else if (f.name == "default") call.id = FilterId::Default;
+            else if (f.name == "format") call.id = FilterId::Format;
+            else continue; // unknown filters are ignored
+            call.arg = add_string(program_, f.arg);
+            call.arg_len = static_cast<std::uint32_t>(f.arg.size());
+            call.arg_expr = kNoExpr;
+            if (!f.arg.empty() && (call.id == FilterId::Truncate || call.id == FilterId::Default)) {
+                try { call.arg_expr = ExprCompiler(program_, f.arg).compile(); } catch (const ExprError&) {}
+            }
+            program_.filters.push_back(call);
+        }
+        auto count = static_cast<std::uint32_t>(program_.filters.size()) - first;
+        const auto& e = program_.exprs[*expr];
+        if (count == 0 && is_literal(e)) {
+            // Constant output becomes plain text, unless autoescape could still change it
+            std::string out;
+            execute_echo_literal(e, out);
+            if (n.raw || str::find_html_special(out) == std::string::npos) {
+                text(out);
+                return;
+            }
+        }
+        emit(n.raw ? Op::EchoRaw : Op::Echo, *expr, first, count);
+    }
+
+    void execute_echo_literal(const Expr& e, std::string& out) const {
+        switch (e.kind) {
+            case ExprKind::Bool: out += e.boolean ? "true" : "false"; break;
+            case ExprKind::Number: append_double(out, e.number); break;
+            case ExprKind::String: out += program_.str(e.str, e.len); break;
+            default: break;
+        }
+    }
+
+    void conditional(const Node& n) {
+        auto expr = expression(n.expr);
+        if (!expr) return;
+        bool unless = n.type == Node::UNLESS;
+        const auto& e = program_.exprs[*expr];
+        if (is_literal(e)) {
+            // Constant condition: keep or drop the block at compile time
+            if (Evaluator(program_, empty_context()).test(*expr) != unless) nodes(n.children);
+            return;
+        }
+        auto jump = here();
+        emit(unless ? Op::JumpIfTrue : Op::JumpIfFalse, *expr);
+        nodes(n.children);
+        program_.code[jump].b = here();
+    }
+
+    void loop(const Node& n) {
+        // The list is a plain path; compile it like any other expression
+        auto list = expression(n.list_name);
+        if (!list) return;
+        Segment item;
+        item.str = add_string(program_, n.item_name);
+        item.len = static_cast<std::uint32_t>(n.item_name.size());
+        program_.segments.push_back(item);
+        auto symbol = static_cast<std::uint32_t>(program_.segments.size() - 1);
+
+        auto begin = here();
+        emit(Op::LoopBegin, *list, 0, symbol);
+        nodes(n.children);
+        emit(Op::LoopEnd, 0, begin + 1);
+        program_.code[begin].b = here();
+    }
+
+    // A key or ttl that does not compile leaves its error text and renders the block uncached
+    void cache(const Node& n) {
+        auto key = expression(n.expr);
+        auto ttl = n.text.empty() ? std::optional<std::uint32_t>(kNoExpr) : expression(n.text);
+        if (!key || !ttl) {
+            nodes(n.children);
+            return;
+        }
+        auto begin = here();
+        emit(Op::CacheBegin, *key, 0, *ttl);
+        nodes(n.children);
+        emit(Op::CacheEnd);
+        program_.code[begin].b = here();
+    }
+};
+
+} // namespace
+
+// Filters work in place on the echoed text
+using FilterFn = void (*)(std::string& value, const FilterCall& call, Interpreter& interpreter);
+
+// {{ }} output is HTML-escaped (BladeOptions::autoescape); read once per render
+static std::atomic<bool> AUTOESCAPE_ENABLED{false};
+
+class Interpreter {
+public:
+    Interpreter(const ProgramView& program, const nlohmann::json& context, std::string& out)
+        : program_(program), eval_(program, context), out_(out) {}
+
+    // A fragment still being recorded was not stored; let the next render refresh it
+    ~Interpreter() {
+        for (const auto& fragment : fragments_) {
+            if (fragment.store) FragmentCache::instance().release(fragment.key);
+        }
+    }
+
+    Interpreter(const Interpreter&) = delete;
+    Interpreter& operator=(const Interpreter&) = delete;
+
+    // Flush the output to `sink` every `chunk_size` bytes instead of accumulating it
+    void stream_to(const ChunkSink& sink, std::size_t chunk_size) {
+        sink_ = &sink;
+        chunk_size_ = std::max<std::size_t>(chunk_size, 1);
+    }
+
+    void run() {
+        const auto size = program_.code.size();
+        while (pc_ < size) {
+            try {
+                dispatch();
+            } catch (const ExprError& e) {
+                out_ += error_text(e);
+                abandon_fragments();
+                recover();
+            } catch (const std::exception& e) {
+                out_ += error_text(e);
+                abandon_fragments();
+                recover();
+            }
+        }
+        if (sink_ && !out_.empty()) flush();
+    }
+
+    // Ahead-of-time compiled templates call these through Frame for what they do not lower
+    // themselves; each does what the matching instruction does, with the same recovery
+    void echo(std::uint32_t expr, std::uint32_t first_filter, std::uint32_t filters, bool raw) {
+        guarded([&] { echo(Instr{raw ? Op::EchoRaw : Op::Echo, expr, first_filter, filters}); });
+        flush_full();
+    }
+
+    // JumpIfFalse (`when` false) / JumpIfTrue (`when` true): whether to skip; an error skips
+    bool skip(std::uint32_t expr, bool when) {
+        bool jump = true;
+        guarded([&] { jump = eval_.test(expr) == when; });
+        return jump;
+    }
+
+    bool loop_begin(std::uint32_t expr, std::uint32_t symbol) {
+        bool entered = false;
+        guarded([&] { entered = enter_loop(expr, symbol); });
+        return entered;
+    }
+
+    bool loop_next() { return next_iteration(); }
+
+    // CacheBegin: true when the stored fragment was appended; an error renders the block uncached
+    bool cache_begin(std::uint32_t key, std::uint32_t ttl) {
+        bool served = false;
+        guarded([&] { served = begin_fragment(key, ttl); });
+        flush_full();
+        return served;
+    }
+
+    void cache_end() {
+        end_fragment();
+        flush_full();
+    }
+
+    void finish() {
+        if (sink_ && !out_.empty()) flush();
+    }
+
+    // Compiled views write to the output themselves and report each write here
+    std::string& output() { return out_; }
+    void written() { flush_full(); }
+    // Output size at which written() has anything to do
+    std::size_t flush_threshold() const { return sink_ ? chunk_size_ : static_cast<std::size_t>(-1); }
+    bool autoescape() const { return autoescape_; }
+    const nlohmann::json* loop_item() {
+        const auto& loop = eval_.loops().back();
+        return &(*loop.list)[loop.index];
+    }
+
+    const ProgramView& program() const { return program_; }
+    const Evaluator& evaluator() const { return eval_; }
+    std::string& spare() { return spare_; }
+
+private:
+    void dispatch() {
+        const auto& code = program_.code;
+        auto pc = pc_;
+        while (pc < code.size()) {
+            pc_ = pc;   // the instruction recover() skips if this one throws
+            const auto& in = code[pc];
+            switch (in.op) {
+                case Op::Text:
+                    out_.append(program_.pool.data() + in.a, in.b);
+                    flush_full();
+                    ++pc;
+                    break;
+                case Op::Echo: case Op::EchoRaw:
+                    echo(in);
+                    flush_full();
+                    ++pc;
+                    break;
+                case Op::JumpIfFalse:
+                    pc = eval_.test(in.a) ? pc + 1 : in.b;
+                    break;
+                case Op::JumpIfTrue:
+                    pc = eval_.test(in.a) ? in.b : pc + 1;
+                    break;
+                case Op::Jump:
+                    pc = in.b;
+                    break;
+                case Op::LoopBegin:
+                    pc = enter_loop(in.a, in.c) ? pc + 1 : in.b;
+                    break;
+                case Op::LoopEnd:
+                    pc = next_iteration() ? in.b : pc + 1;
+                    break;
+                case Op::CacheBegin:
+                    pc = begin_fragment(in.a, in.c) ? in.b : pc + 1;
+                    flush_full();
+                    break;
+                case Op::CacheEnd:
+                    end_fragment();
+                    flush_full();
+                    ++pc;
+                    break;
+            }
+        }
+        pc_ = pc;
+    }
+
+    void flush() {
+        (*sink_)(out_);
+        out_.clear();
+    }
+
+    // Output being recorded for @cache stays in the buffer until its block ends
+    void flush_full() {
+        if (sink_ && fragments_.empty() && out_.size() >= chunk_size_) flush();
+    }
+
+    // Serve the stored fragment, or start recording the block when this render has to produce it
+    bool begin_fragment(std::uint32_t key, std::uint32_t ttl) {
+        // pushed first: if the key or ttl throws, the block renders and its CacheEnd pops this
+        auto& fragment = fragments_.emplace_back();
+        append_echo(fragment.key, eval_.eval(key));
+        if (ttl != kNoExpr) {
+            auto seconds = eval_.eval(ttl);
+            if (!seconds.is_number() || !(seconds.as_double() > 0)) return false;   // render uncached
+            fragment.ttl = std::chrono::milliseconds(std::llround(seconds.as_double() * 1000));
+        }
+        auto found = FragmentCache::instance().lookup(fragment.key);
+        if (found.html) {
+            fragments_.pop_back();
+            out_ += *found.html;
+            return true;
+        }
+        fragment.store = true;
+        fragment.start = out_.size();
+        return false;
+    }
+
+    void end_fragment() {
+        if (fragments_.empty()) return;
+        auto fragment = std::move(fragments_.back());
+        fragments_.pop_back();
+        if (fragment.store) FragmentCache::instance().store(fragment.key, out_.substr(fragment.start), fragment.ttl);
+    }
+
+    // Error text now sits in every open block's output, so none of them may be stored; the next
+    // render refreshes them
+    void abandon_fragments() {
+        for (auto& fragment : fragments_) {
+            if (fragment.store) FragmentCache::instance().release(fragment.key);
+            fragment.store = false;
+        }
+    }
+
+    // Push a frame for a non-empty array; anything else skips the loop body
+    bool enter_loop(std::uint32_t expr, std::uint32_t symbol) {
+        auto list = eval_.eval(expr);
+        if (list.kind != Value::Kind::Json || !list.json->is_array() || list.json->empty()) return false;
+        const auto& item = program_.segments[symbol];
+        eval_.loops().push_back({list.json, 0, program_.str(item.str, item.len)});
+        return true;
+    }
+
+    bool next_iteration() {
+        auto& loop = eval_.loops().back();
+        if (++loop.index < loop.list->size()) return true;
+        eval_.loops().pop_back();
+        return false;
+    }
+
+    template <typename F>
+    void guarded(F&& f) {
+        try {
+            f();
+        } catch (const ExprError& e) {
+            out_ += error_text(e);
+            abandon_fragments();
+        } catch (const std::exception& e) {
+            out_ += error_text(e);
+            abandon_fragments();
+        }
+    }
+
+    // Continue after the instruction at pc_ threw: skip the failed echo or block
+    void recover() {
+        const auto& in = program_.code[pc_];
+        switch (in.op) {
+            case Op::JumpIfFalse: case Op::JumpIfTrue: case Op::LoopBegin: pc_ = in.b; break;
+            case Op::LoopEnd:
+                if (!eval_.loops().empty()) eval_.loops().pop_back();
+                ++pc_;
+                break;
+            default: ++pc_; break;
+        }
+    }
+
+    void echo(const Instr& in);
+
+    ProgramView program_;
+    Evaluator eval_;
+    std::string& out_;
+    std::string scratch_;
+    std::string spare_;
+    std::size_t pc_ = 0;
+    const ChunkSink* sink_ = nullptr;
+    std::size_t chunk_size_ = 0;
+    bool autoescape_ = AUTOESCAPE_ENABLED.load(std::memory_order_relaxed);
+
+    struct Fragment {
+        std::string key;
+        std::size_t start = 0;                 // where the recorded output begins in out_
+        std::chrono::milliseconds ttl{0};
+        bool store = false;                    // false: rendering through (uncached or after an error)
+    };
+    std::vector<Fragment> fragments_;          // open @cache blocks, innermost last
+};
+
+namespace {
+
+// Text with nothing to escape is left untouched
+void filter_escape(std::string& value, const FilterCall&, Interpreter& in) {
+    if (str::find_html_special(value) == std::string::npos) return;
+    auto& escaped = in.spare();
+    escaped.clear();
+    str::append_html_escaped(escaped, value);
+    value.swap(escaped);
+}
+
+void filter_upper(std::string& value, const FilterCall&, Interpreter&) {
+    str::ascii_upper(value);
+}
+
+void filter_lower(std::string& value, const FilterCall&, Interpreter&) {
+    str::ascii_lower(value);
+}
+
+void filter_trim(std::string& value, const FilterCall&, Interpreter&) {
+    str::trim_in_place(value);
+}
+
+void filter_truncate(std::string& value, const FilterCall& call, Interpreter& in) {
+    long len = 0;
+    try {
+        if (call.arg_expr != kNoExpr) {
+            auto v = in.evaluator().eval(call.arg_expr);
+            len = v.is_number() ? static_cast<long>(v.as_double())
+                                : std::stol(std::string(in.program().str(call.arg, call.arg_len)));
         }
-        if (left.is_boolean() && right.is_boolean()) {
-            bool a = left.get<bool>(); bool b = right.get<bool>(); if (op == "==") return a == b; if (op == "!=") return a != b; return false;
+    } catch (...) {
+        len = 0;
+    }
+    if (len > 0 && static_cast<long>(value.size()) > len) value.resize(static_cast<std::size_t>(len));
+}
+
+void filter_default(std::string& value, const FilterCall& call, Interpreter& in) {
+    if (!value.empty() || call.arg_len == 0) return;
+    auto raw = in.program().str(call.arg, call.arg_len);
+    if (call.arg_expr == kNoExpr) { value.assign(raw); return; }
+    try {
+        auto v = in.evaluator().eval(call.arg_expr);
+        if (v.is_string() || v.is_number() || v.kind == Value::Kind::Bool) append_echo(value, v);
+    } catch (...) {
+        value.assign(raw);
+    }
+}
+
+void filter_format(std::string& value, const FilterCall& call, Interpreter& in) {
+    auto fmt = in.program().str(call.arg, call.arg_len);
+    if (fmt.empty()) return;
+    auto p = fmt.find("{}");
+    std::size_t width = 2;
+    if (p == std::string_view::npos) { p = fmt.find("{0}"); width = 3; }
+    if (p == std::string_view::npos) return;
+    std::string out;
+    out.reserve(fmt.size() + value.size());
+    out.append(fmt.substr(0, p)).append(value).append(fmt.substr(p + width));
+    value.swap(out);
+}
+
+// Indexed by FilterId
+constexpr FilterFn kFilters[] = {filter_escape, filter_upper, filter_lower, filter_trim,
+                                 filter_truncate, filter_default, filter_format};
+
+} // namespace
+
+void Interpreter::echo(const Instr& in) {
+    // a trailing `| escape` has already done what autoescape would
+    bool escape = autoescape_ && in.op == Op::Echo &&
+                  (in.c == 0 || program_.filters[in.b + in.c - 1].id != FilterId::Escape);
+    auto v = eval_.eval(in.a);
+    if (in.c == 0) {
+        // strings are escaped straight into the output; numbers, booleans and null never need it
+        if (escape && v.is_string()) str::append_html_escaped(out_, v.text());
+        else if (escape && v.kind == Value::Kind::Json) str::append_html_escaped(out_, v.json->dump());
+        else append_echo(out_, v);
+        return;
+    }
+    scratch_.clear();
+    append_echo(scratch_, v);
+    for (std::uint32_t i = 0; i < in.c; ++i) {
+        const auto& call = program_.filters[in.b + i];
+        kFilters[static_cast<std::size_t>(call.id)](scratch_, call, *this);
+    }
+    if (escape) str::append_html_escaped(out_, scratch_);
+    else out_ += scratch_;
+}
+
+static Program compile_nodes(const std::vector<std::shared_ptr<Node>>& nodes) {
+    Program program;
+    ProgramBuilder(program).build(nodes);
+    return program;
+}
+
+
+void execute(const ProgramView& program, const nlohmann::json& context, std::string& out) {
+    Interpreter(program, context, out).run();
+}
+
+void execute(const ProgramView& program, const nlohmann::json& context, std::string& buffer,
+             const ChunkSink& sink, std::size_t chunk_size) {
+    Interpreter interpreter(program, context, buffer);
+    interpreter.stream_to(sink, chunk_size);
+    interpreter.run();
+}
+
+Frame::Frame(Interpreter& interpreter)
+    : interpreter_(interpreter), out_(interpreter.output()), root_(&interpreter.evaluator().root()),
+      flush_at_(interpreter.flush_threshold()), autoescape_(interpreter.autoescape()) {}
+
+void Frame::flush() { interpreter_.written(); }
+
+// Null, booleans and numbers never need escaping; arrays and objects are printed (and escaped)
+// by the interpreter, which also turns a failed dump into error text
+void Frame::echo_other(const nlohmann::json* value, std::uint32_t expr, bool raw) {
+    if (value && value->is_structured()) {
+        interpreter_.echo(expr, 0, 0, raw);
+        return;
+    }
+    if (value) append_echo(out_, Value::of(*value));
+    written();
+}
+
+void Frame::echo(std::uint32_t expr, std::uint32_t first_filter, std::uint32_t filters) {
+    interpreter_.echo(expr, first_filter, filters, false);
+}
+
+void Frame::echo_raw(std::uint32_t expr, std::uint32_t first_filter, std::uint32_t filters) {
+    interpreter_.echo(expr, first_filter, filters, true);
+}
+
+bool Frame::skip_unless(std::uint32_t expr) { return interpreter_.skip(expr, false); }
+bool Frame::skip_if(std::uint32_t expr) { return interpreter_.skip(expr, true); }
+bool Frame::loop_begin(std::uint32_t expr, std::uint32_t symbol) {
+    if (!interpreter_.loop_begin(expr, symbol)) return false;
+    item_ = interpreter_.loop_item();
+    return true;
+}
+
+bool Frame::loop_next() {
+    if (!interpreter_.loop_next()) return false;
+    item_ = interpreter_.loop_item();
+    return true;
+}
+bool Frame::cache_begin(std::uint32_t key, std::uint32_t ttl) { return interpreter_.cache_begin(key, ttl); }
+void Frame::cache_end() { interpreter_.cache_end(); }
+
+// --- binary compiled-template format ---
+
+namespace {
+
+struct FileHeader {
+    char magic[4] = {'B', 'Z', 'V', 'C'};
+    std::uint32_t version = kFormatVersion;
+    std::uint32_t byte_order = 0x01020304;
+    std::uint32_t layout = 0;
+    std::uint64_t counts[6] = {};      // code, exprs, segments, filters, pool bytes, manifest bytes
+};
+
+constexpr std::uint32_t layout_tag() {
+    return static_cast<std::uint32_t>(sizeof(Instr) << 24 | sizeof(Expr) << 16 | sizeof(Segment) << 8 | sizeof(FilterCall));
+}
+
+constexpr std::uint32_t kTopLevel = 0xffffffffu;
+
+constexpr std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+
+template <typename T>
+bool take(std::string_view bytes, std::size_t& offset, std::uint64_t count, std::span<const T>& table) {
+    // Padding after the previous table may already run past a truncated image
+    if (offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T)) return false;
+    table = {reinterpret_cast<const T*>(bytes.data() + offset), static_cast<std::size_t>(count)};
+    offset = align8(offset + count * sizeof(T));
+    return true;
+}
+
+bool in_pool(const ProgramView& p, std::uint32_t offset, std::uint32_t length) {
+    return offset <= p.pool.size() && length <= p.pool.size() - offset;
+}
+
+bool valid_expr(const ProgramView& p, std::uint32_t index) {
+    const auto& e = p.exprs[index];
+    if (!in_pool(p, e.source, e.source_len)) return false;
+    switch (e.kind) {
+        case ExprKind::Null: case ExprKind::Bool: case ExprKind::Number: return true;
+        case ExprKind::String: return in_pool(p, e.str, e.len);
+        case ExprKind::Path: return e.len > 0 && e.str <= p.segments.size() && e.len <= p.segments.size() - e.str;
+        case ExprKind::LoopVar: return e.str <= static_cast<std::uint32_t>(LoopField::Depth);
+        // operands always precede their parent, which also rules out cycles
+        case ExprKind::Not: case ExprKind::Negate: return e.lhs < index;
+        case ExprKind::And: case ExprKind::Or: case ExprKind::Compare: case ExprKind::Arith:
+            return e.lhs < index && e.rhs < index && e.op <= BinOp::Mod;
+    }
+    return false;
+}
+
+// Jumps may not cross loop or @cache boundaries and every LoopEnd / CacheEnd must close the
+// innermost LoopBegin / CacheBegin, so the interpreter's stacks can never underflow
+bool valid_code(const ProgramView& p) {
+    const auto size = static_cast<std::uint32_t>(p.code.size());
+    std::vector<std::uint32_t> owner(size + 1, kTopLevel);   // innermost enclosing LoopBegin / CacheBegin
+    std::vector<std::uint32_t> open;
+    for (std::uint32_t pc = 0; pc < size; ++pc) {
+        const auto& in = p.code[pc];
+        owner[pc] = open.empty() ? kTopLevel : open.back();
+        switch (in.op) {
+            case Op::Text: if (!in_pool(p, in.a, in.b)) return false; break;
+            case Op::Echo: case Op::EchoRaw:
+                if (in.a >= p.exprs.size() || in.b > p.filters.size() || in.c > p.filters.size() - in.b) return false;
+                break;
+            case Op::JumpIfFalse: case Op::JumpIfTrue:
+                if (in.a >= p.exprs.size()) return false;
+                [[fallthrough]];
+            case Op::Jump: if (in.b <= pc || in.b > size) return false; break;
+            case Op::LoopBegin:
+                if (in.a >= p.exprs.size() || in.c >= p.segments.size() || in.b <= pc + 1 || in.b > size) return false;
+                open.push_back(pc);
+                break;
+            case Op::LoopEnd:
+                if (open.empty() || p.code[open.back()].op != Op::LoopBegin || in.b != open.back() + 1 ||
+                    p.code[open.back()].b != pc + 1) return false;
+                open.pop_back();
+                break;
+            case Op::CacheBegin:
+                if (in.a >= p.exprs.size() || (in.c != kNoExpr && in.c >= p.exprs.size()) || in.b <= pc + 1 || in.b > size) return false;
+                open.push_back(pc);
+                break;
+            case Op::CacheEnd:
+                if (open.empty() || p.code[open.back()].op != Op::CacheBegin || p.code[open.back()].b != pc + 1) return false;
+                open.pop_back();
+                break;
+            default: return false;
+        }
+    }
+    if (!open.empty()) return false;
+    for (std::uint32_t pc = 0; pc < size; ++pc) {
+        const auto& in = p.code[pc];
+        if (in.op == Op::JumpIfFalse || in.op == Op::JumpIfTrue || in.op == Op::Jump) {
+            if (owner[in.b] != owner[pc]) return false;
+        }
+    }
+    return true;
+}
+
+bool valid(const ProgramView& p) {
+    for (const auto& seg : p.segments) if (!in_pool(p, seg.str, seg.len)) return false;
+    for (const auto& call : p.filters) {
+        if (call.id > FilterId::Format || !in_pool(p, call.arg, call.arg_len)) return false;
+        if (call.arg_expr != kNoExpr && call.arg_expr >= p.exprs.size()) return false;
+    }
+    for (std::uint32_t i = 0; i < p.exprs.size(); ++i) if (!valid_expr(p, i)) return false;
+    return valid_code(p);
+}
+
+} // namespace
+
+std::string serialize(const Program& program, std::string_view dependencies) {
+    FileHeader header;
+    header.layout = layout_tag();
+    header.counts[0] = program.code.size();
+    header.counts[1] = program.exprs.size();
+    header.counts[2] = program.segments.size();
+    header.counts[3] = program.filters.size();
+    header.counts[4] = program.pool.size();
+    header.counts[5] = dependencies.size();
+
+    std::string out;
+    auto put = [&out](const void* data, std::size_t size) {
+        out.append(static_cast<const char*>(data), size);
+        out.resize(align8(out.size()), '\0');
+    };
+    // Rows are rebuilt member by member over zeroed memory, so padding bytes are zero and the
+    // same program always serializes to the same image
+    auto put_rows = [&put](const auto& rows, auto copy) {
+        using Row = typename std::decay_t<decltype(rows)>::value_type;
+        std::vector<Row> clean(rows.size());
+        std::memset(static_cast<void*>(clean.data()), 0, clean.size() * sizeof(Row));
+        for (std::size_t i = 0; i < rows.size(); ++i) copy(clean[i], rows[i]);
+        put(clean.data(), clean.size() * sizeof(Row));
+    };
+    put(&header, sizeof(header));
+    put_rows(program.code, [](Instr& to, const Instr& from) { to.op = from.op; to.a = from.a; to.b = from.b; to.c = from.c; });
+    put_rows(program.exprs, [](Expr& to, const Expr& from) {
+        to.kind = from.kind; to.op = from.op; to.boolean = from.boolean; to.lhs = from.lhs; to.rhs = from.rhs;
+        to.number = from.number; to.str = from.str; to.len = from.len; to.source = from.source;
+        to.source_len = from.source_len; to.pos = from.pos;
+    });
+    put(program.segments.data(), program.segments.size() * sizeof(Segment));
+    put_rows(program.filters, [](FilterCall& to, const FilterCall& from) {
+        to.id = from.id; to.arg_expr = from.arg_expr; to.arg = from.arg; to.arg_len = from.arg_len;
+    });
+    put(program.pool.data(), program.pool.size());
+    put(dependencies.data(), dependencies.size());
+    return out;
+}
+
+std::optional<ProgramView> load(std::string_view bytes, std::string_view* dependencies) {
+    FileHeader header;
+    if (bytes.size() < sizeof(header) || reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(Expr) != 0) return std::nullopt;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, FileHeader{}.magic, sizeof(header.magic)) != 0 || header.version != kFormatVersion ||
+        header.byte_order != FileHeader{}.byte_order || header.layout != layout_tag()) {
+        return std::nullopt;
+    }
+    for (auto count : header.counts) if (count > 0xffffffffu) return std::nullopt;
+
+    ProgramView view;
+    std::size_t offset = align8(sizeof(header));
+    std::span<const char> pool, manifest;
+    if (!take(bytes, offset, header.counts[0], view.code) || !take(bytes, offset, header.counts[1], view.exprs) ||
+        !take(bytes, offset, header.counts[2], view.segments) || !take(bytes, offset, header.counts[3], view.filters) ||
+        !take(bytes, offset, header.counts[4], pool) || !take(bytes, offset, header.counts[5], manifest)) {
+        return std::nullopt;
+    }
+    view.pool = std::string_view(pool.data(), pool.size());
+    if (!valid(view)) return std::nullopt;
+    if (dependencies) *dependencies = std::string_view(manifest.data(), manifest.size());
+    return view;
+}
+
+bool save(const Program& program, const std::filesystem::path& path, std::string_view dependencies) {
+    // concurrent writers each use their own temporary; rename() makes the last one win whole
+    static std::atomic<std::uint64_t> sequence{0};
+    auto tmp = path;
+    tmp += ".tmp" + std::to_string(::getpid()) + "." + std::to_string(sequence.fetch_add(1));
+    {
+        std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+        if (!ofs) return false;
+        auto bytes = serialize(program, dependencies);
+        ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!ofs) {
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            return false;
         }
-        std::string a = left.is_string() ? left.get<std::string>() : left.dump();
-        std::string b = right.is_string() ? right.get<std::string>() : right.dump();
-        if (op == "==") return a == b; if (op == "!=") return a != b; if (op == ">") return a > b; if (op == "<") return a < b; if (op == ">=") return a >= b; if (op == "<=") return a <= b; return false;
     }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
+}
 
-    nlohmann::json arithmetic_op(const nlohmann::json& left, const nlohmann::json& right, char op) {
-        if (left.is_number() && right.is_number()) {
-            double a = left.get<double>(); double b = right.get<double>();
-            if (op == '+') return a + b; if (op == '-') return a - b; if (op == '*') return a * b; if (op == '/') { if (b == 0) throw ExprError("Division by zero", str_, pos_); return a / b; } if (op == '%') { if (b == 0) throw ExprError("Division by zero for modulus", str_, pos_); return std::fmod(a, b); }
-        }
-        if (op == '+') { std::string a = left.is_string() ? left.get<std::string>() : left.dump(); std::string b = right.is_string() ? right.get<std::string>() : right.dump(); return a + b; }
-        throw ExprError("Arithmetic operation on non-numeric operands", str_, pos_);
+std::shared_ptr<const MappedProgram> MappedProgram::open(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
     }
-};
+    auto size = static_cast<std::size_t>(st.st_size);
+    void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return nullptr;
 
-// --- Template AST and compilation caching ---
-struct FilterSpec { std::string name; std::string arg; };
-struct Node {
-    enum Type { TEXT, VAR, IF, UNLESS, FOREACH } type;
-    std::string text; // for TEXT
-    std::string expr; // for VAR or IF condition
-    std::vector<FilterSpec> filters; // for VAR
-    std::vector<std::shared_ptr<Node>> children; // for blocks
-    // foreach specifics
-    std::string list_name;
-    std::string item_name;
-};
+    std::shared_ptr<MappedProgram> mapped(new MappedProgram(base, size));
+    auto view = load(std::string_view(static_cast<const char*>(base), size), &mapped->dependencies_);
+    if (!view) return nullptr;
+    mapped->view_ = *view;
+    return mapped;
+}
 
-// forward declaration of parse_nodes so compilation unit can reference it earlier
-static std::vector<std::shared_ptr<Node>> parse_nodes(const std::string& s, size_t start, const std::string& end_tag="");
+MappedProgram::~MappedProgram() {
+    if (base_) ::munmap(base_, size_);
+}
+
+} // namespace blade
 
 // We'll need a fast content hash for cache keys (FNV-1a)
 static std::string sha1_hex(const std::string& s) {
@@ -238,100 +1381,148 @@ static std::string sha1_hex(const std::string& s) {
     return out;
 }
 
-// New cache key uses SHA1 string instead of numeric FNV
-struct FileCacheKey {
+// What a template file looked like when it was compiled; any difference means it changed
+struct FileSignature {
+    dev_t device = 0;
+    ino_t inode = 0;
+    off_t size = 0;
+    std::int64_t mtime_ns = 0;
+    bool operator==(const FileSignature&) const = default;
+};
+
+static std::optional<FileSignature> stat_signature(const std::filesystem::path& path) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) return std::nullopt;
+    FileSignature sig;
+    sig.device = st.st_dev;
+    sig.inode = st.st_ino;
+    sig.size = st.st_size;
+    sig.mtime_ns = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return sig;
+}
+
+// A partial linked into a template (@extends / @include / @component) as it was when linked
+struct Dependency {
     std::filesystem::path path;
-    std::string content_hash; // hex sha1
+    FileSignature signature;
+    std::string content_hash;
 };
-static inline bool operator==(const FileCacheKey& a, const FileCacheKey& b) { return a.path == b.path && a.content_hash == b.content_hash; }
-struct FileCacheKeyHash { std::size_t operator()(FileCacheKey const& k) const noexcept { return std::hash<std::string>{}(k.path.string()) ^ (std::hash<std::string>{}(k.content_hash) << 1); } };
 
-// LRU cache structures (thread-safe)
+static bool dependencies_unchanged(const std::vector<Dependency>& dependencies) {
+    for (const auto& dependency : dependencies) {
+        auto current = stat_signature(dependency.path);
+        if (!current || *current != dependency.signature) return false;
+    }
+    return true;
+}
+
+// Cached programs are shared as views; the owner is either a Program compiled in this
+// process or a MappedProgram, kept alive by the aliasing shared_ptr
+using SharedProgram = std::shared_ptr<const blade::ProgramView>;
+
+static SharedProgram share(blade::Program program) {
+    struct Owned { blade::Program program; blade::ProgramView view; };
+    auto owned = std::make_shared<Owned>();
+    owned->program = std::move(program);
+    owned->view = owned->program;
+    return SharedProgram(owned, &owned->view);
+}
+
+static SharedProgram share(std::shared_ptr<const blade::MappedProgram> mapped) {
+    const auto* view = &mapped->view();
+    return SharedProgram(std::move(mapped), view);
+}
+
+// LRU cache of compiled programs keyed by template path (thread-safe)
 static std::mutex cache_mutex;
-static std::list<FileCacheKey> lru_list; // front = most recently used
-// Define CacheEntry used by the cache map
+static std::list<std::string> lru_list; // front = most recently used
 struct CacheEntry {
-    std::shared_ptr<Node> ast;
+    SharedProgram program;
     std::chrono::steady_clock::time_point created;
+    FileSignature signature;
+    std::chrono::steady_clock::time_point checked;   // last time the signature was compared
+    std::vector<Dependency> dependencies;             // re-validated together with the template
 };
-static std::unordered_map<FileCacheKey, std::pair<CacheEntry, std::list<FileCacheKey>::iterator>, FileCacheKeyHash> file_content_cache;
+static std::unordered_map<std::string, std::pair<CacheEntry, std::list<std::string>::iterator>> file_content_cache;
 static size_t CACHE_MAX_ITEMS = 128;
 static std::chrono::seconds CACHE_TTL = std::chrono::seconds(300); // default 5 minutes
+static std::chrono::milliseconds CHECK_INTERVAL = std::chrono::milliseconds(1000);
+static std::atomic<bool> VIEWS_IMMUTABLE{false};
+static std::atomic<bool> COMPILED_VIEWS_ENABLED{true};
 static bool INLINE_CPP_ENABLED = false; // default, can be set from app config
+static std::filesystem::path VIEWS_PATH = "resources/views";   // guarded by cache_mutex
+
+using NodeList = std::vector<std::shared_ptr<Node>>;
+
+// Parsed partials, cached independently of the templates that link them and re-validated with
+// stat() whenever one is linked again; linking copies only the nodes it rewrites
+struct PartialEntry {
+    FileSignature signature;
+    std::string content_hash;
+    std::shared_ptr<const NodeList> nodes;
+};
+static std::mutex partial_mutex;
+static std::unordered_map<std::string, PartialEntry> partial_cache;
+
+
+static std::filesystem::path views_path() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return VIEWS_PATH;
+}
 
 // Add basic cache stats
-struct CacheStats { size_t hits = 0; size_t misses = 0; size_t entries = 0; };
+struct CacheStats { size_t hits = 0; size_t misses = 0; size_t entries = 0; size_t checks = 0; size_t reloads = 0; };
 static CacheStats cache_stats_data;
 
-// helper: ensure cache directory exists
-static std::filesystem::path view_cache_dir() {
-    std::filesystem::path p = "storage/framework/views";
+// Cache directory, created on first use rather than on every lookup
+static const std::filesystem::path& view_cache_dir() {
+    static const std::filesystem::path dir = [] {
+        std::filesystem::path p = "storage/framework/views";
+        std::error_code ec;
+        std::filesystem::create_directories(p, ec);
+        return p;
+    }();
+    return dir;
+}
+
+// Prefix of the image names for a views root: @extends / @include resolve against it, so the
+// same source under two roots (two apps sharing a cache dir) compiles to different programs
+static std::string views_root_key(const std::filesystem::path& root) {
     std::error_code ec;
-    std::filesystem::create_directories(p, ec);
-    return p;
-}
-
-// Serialize AST (Node) to JSON for disk cache
-static nlohmann::json node_to_json(const std::shared_ptr<Node>& node) {
-    nlohmann::json j;
-    j["type"] = static_cast<int>(node->type);
-    j["text"] = node->text;
-    j["expr"] = node->expr;
-    // filters
-    j["filters"] = nlohmann::json::array();
-    for (const auto& f : node->filters) {
-        nlohmann::json fj;
-        fj["name"] = f.name;
-        fj["arg"] = f.arg;
-        j["filters"].push_back(fj);
-    }
-    // children
-    j["children"] = nlohmann::json::array();
-    for (const auto& c : node->children) j["children"].push_back(node_to_json(c));
-    j["list_name"] = node->list_name;
-    j["item_name"] = node->item_name;
-    return j;
-}
-
-static std::shared_ptr<Node> json_to_node(const nlohmann::json& j) {
-    auto n = std::make_shared<Node>();
-    n->type = static_cast<Node::Type>(j.value("type", 0));
-    n->text = j.value("text", std::string{});
-    n->expr = j.value("expr", std::string{});
-    if (j.contains("filters") && j["filters"].is_array()) {
-        for (const auto& fj : j["filters"]) {
-            FilterSpec f{fj.value("name", std::string{}), fj.value("arg", std::string{})};
-            n->filters.push_back(f);
-        }
-    }
-    if (j.contains("children") && j["children"].is_array()) {
-        for (const auto& cj : j["children"]) n->children.push_back(json_to_node(cj));
-    }
-    n->list_name = j.value("list_name", std::string{});
-    n->item_name = j.value("item_name", std::string{});
-    return n;
+    auto absolute = std::filesystem::absolute(root, ec);
+    return sha1_hex((ec ? root : absolute).lexically_normal().string()).substr(0, 16);
+}
+static std::string VIEWS_ROOT_KEY = views_root_key(VIEWS_PATH);   // guarded by cache_mutex
+
+// Precompiled programs in storage/framework/views are named by views root and content hash
+static std::filesystem::path compiled_path(const std::string& content_hash) {
+    std::string root_key;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        root_key = VIEWS_ROOT_KEY;
+    }
+    return view_cache_dir() / (root_key + "-" + content_hash + ".bzv");
 }
 
 // LRU cache put/get
-static void cache_put_file(const FileCacheKey& key, std::shared_ptr<Node> ast) {
+static void cache_put_file(const std::string& key, SharedProgram program, const FileSignature& signature,
+                           std::vector<Dependency> dependencies) {
     std::lock_guard<std::mutex> lock(cache_mutex);
+    auto now = std::chrono::steady_clock::now();
     auto it = file_content_cache.find(key);
     if (it != file_content_cache.end()) {
         // update entry and move to front
-        it->second.first.ast = ast;
-        it->second.first.created = std::chrono::steady_clock::now();
+        it->second.first = CacheEntry{program, now, signature, now, std::move(dependencies)};
         lru_list.erase(it->second.second);
         lru_list.push_front(key);
         it->second.second = lru_list.begin();
     } else {
         // insert
         lru_list.push_front(key);
-        CacheEntry entry{ast, std::chrono::steady_clock::now()};
-        file_content_cache.emplace(key, std::make_pair(entry, lru_list.begin()));
+        file_content_cache.emplace(key, std::make_pair(CacheEntry{program, now, signature, now, std::move(dependencies)}, lru_list.begin()));
         // evict if over capacity
         while (file_content_cache.size() > CACHE_MAX_ITEMS) {
-            auto last = lru_list.back();
-            auto fit = file_content_cache.find(last);
+            auto fit = file_content_cache.find(lru_list.back());
             if (fit != file_content_cache.end()) file_content_cache.erase(fit);
             lru_list.pop_back();
         }
@@ -339,61 +1530,77 @@ static void cache_put_file(const FileCacheKey& key, std::shared_ptr<Node> ast) {
     cache_stats_data.entries = file_content_cache.size();
 }
 
-static std::shared_ptr<Node> cache_get_file(const FileCacheKey& key) {
-    std::lock_guard<std::mutex> lock(cache_mutex);
-    auto it = file_content_cache.find(key);
-    if (it == file_content_cache.end()) { cache_stats_data.misses++; return nullptr; }
-    // check TTL
-    auto now = std::chrono::steady_clock::now();
-    if (now - it->second.first.created > CACHE_TTL) {
-        // expired
-        lru_list.erase(it->second.second);
-        file_content_cache.erase(it);
-        cache_stats_data.entries = file_content_cache.size();
-        cache_stats_data.misses++;
-        return nullptr;
-    }
-    // move to front
+static void cache_drop(std::unordered_map<std::string, std::pair<CacheEntry, std::list<std::string>::iterator>>::iterator it) {
     lru_list.erase(it->second.second);
-    lru_list.push_front(key);
-    it->second.second = lru_list.begin();
-    cache_stats_data.hits++;
-    return it->second.first.ast;
+    file_content_cache.erase(it);
+    cache_stats_data.entries = file_content_cache.size();
 }
 
-// Disk cache helpers: write/read compiled AST JSON
-static void write_ast_to_disk(const FileCacheKey& key, const std::shared_ptr<Node>& ast) {
-    try {
-        auto dir = view_cache_dir();
-        std::string fname = key.content_hash + ".json";
-        std::filesystem::path p = dir / fname;
-        nlohmann::json j = node_to_json(ast);
-        std::ofstream ofs(p);
-        if (ofs) ofs << j.dump();
-    } catch (...) {}
-}
+// A hit needs no file I/O unless the entry is due for a check: then one stat() per file (the
+// template and each partial it links) decides whether it changed. Immutable views are never
+// re-checked.
+static SharedProgram cache_get_file(const std::filesystem::path& path) {
+    const std::string& key = path.native();
+    SharedProgram program;
+    FileSignature signature;
+    std::vector<Dependency> dependencies;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = file_content_cache.find(key);
+        if (it == file_content_cache.end()) { cache_stats_data.misses++; return nullptr; }
+        auto now = std::chrono::steady_clock::now();
+        auto& entry = it->second.first;
+        if (now - entry.created > CACHE_TTL) {
+            cache_drop(it);
+            cache_stats_data.misses++;
+            return nullptr;
+        }
+        // move to front
+        lru_list.splice(lru_list.begin(), lru_list, it->second.second);
+        if (VIEWS_IMMUTABLE || now - entry.checked < CHECK_INTERVAL) {
+            cache_stats_data.hits++;
+            return entry.program;
+        }
+        program = entry.program;
+        signature = entry.signature;
+        dependencies = entry.dependencies;
+    }
 
-static std::shared_ptr<Node> read_ast_from_disk(const FileCacheKey& key) {
-    try {
-        auto dir = view_cache_dir();
-        std::string fname = key.content_hash + ".json";
-        std::filesystem::path p = dir / fname;
-        if (!std::filesystem::exists(p)) return nullptr;
-        std::ifstream ifs(p);
-        if (!ifs) return nullptr;
-        nlohmann::json j; ifs >> j;
-        return json_to_node(j);
-    } catch (...) { return nullptr; }
+    // stat() outside the lock; other threads keep rendering the cached program meanwhile
+    auto current = stat_signature(path);
+    bool unchanged = current && *current == signature && dependencies_unchanged(dependencies);
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache_stats_data.checks++;
+    auto it = file_content_cache.find(key);
+    if (unchanged) {
+        if (it != file_content_cache.end() && it->second.first.program == program) {
+            it->second.first.checked = std::chrono::steady_clock::now();
+        }
+        cache_stats_data.hits++;
+        return program;
+    }
+    if (it != file_content_cache.end() && it->second.first.program == program) cache_drop(it);
+    cache_stats_data.reloads++;
+    cache_stats_data.misses++;
+    return nullptr;
 }
 
 // Clear cache API
 void Blade::clear_cache() {
     std::lock_guard<std::mutex> lock(cache_mutex);
     file_content_cache.clear(); lru_list.clear(); cache_stats_data = CacheStats{};
-    // also clear disk cache files
+    {
+        std::lock_guard<std::mutex> partial_lock(partial_mutex);
+        partial_cache.clear();
+    }
+    FragmentCache::instance().clear();
+    // also clear compiled files on disk (and JSON ASTs left by older builds), not .gitkeep
     try {
         auto dir = view_cache_dir();
-        for (auto &entry : std::filesystem::directory_iterator(dir)) std::filesystem::remove(entry.path());
+        for (auto &entry : std::filesystem::directory_iterator(dir)) {
+            auto ext = entry.path().extension();
+            if (ext == ".bzv" || ext == ".json") std::filesystem::remove(entry.path());
+        }
     } catch (...) {}
 }
 
@@ -405,6 +1612,11 @@ nlohmann::json Blade::cache_stats() {
     out["entries"] = file_content_cache.size();
     out["max_items"] = CACHE_MAX_ITEMS;
     out["ttl_seconds"] = CACHE_TTL.count();
+    out["checks"] = cache_stats_data.checks;
+    out["reloads"] = cache_stats_data.reloads;
+    out["check_interval_ms"] = CHECK_INTERVAL.count();
+    out["immutable"] = VIEWS_IMMUTABLE.load();
+    out["fragments"] = FragmentCache::instance().stats();
     return out;
 }
 
@@ -510,221 +1722,342 @@ static std::string tiny_breeze_interpreter(const std::string& code, const nlohma
     return output;
 }
 
-// Updated compile_template_from_file to use content-hash key and inline C++ processing with disk cache
-static std::shared_ptr<Node> compile_template_from_file(const std::filesystem::path& path) {
-    try {
-        auto content_opt = read_file_to_string(path);
-        if (!content_opt) return nullptr;
-        auto content = *content_opt;
-        std::string chash = sha1_hex(content);
-        FileCacheKey key{path, chash};
-        // check in-memory cache
-        if (auto ast = cache_get_file(key); ast) return ast;
-        // check on-disk cache
-        if (auto disk_ast = read_ast_from_disk(key); disk_ast) {
-            // If the template contains an inline C++ block and inline compilation is enabled,
-            // do not return a cached raw-text AST that simply contains the source (it may be stale);
-            // instead continue to attempt inline compilation so the fallback interpreter can be used.
-            bool contains_cpp = (content.find("@cpp{") != std::string::npos);
-            bool disk_contains_cpp_marker = false;
-            if (disk_ast->type == Node::TEXT && disk_ast->text.find("@cpp{") != std::string::npos) disk_contains_cpp_marker = true;
-            if (INLINE_CPP_ENABLED && contains_cpp && disk_contains_cpp_marker) {
-                // skip using the disk cache so we can attempt compile/fallback
-            } else {
-                cache_put_file(key, disk_ast);
-                return disk_ast;
-            }
+// --- @extends / @section / @yield / @include / @component ---
+
+static std::string error_node_text(const std::string& message) {
+    return "[Template Error: msg=" + message + "]";
+}
+
+// Resolves view names and splices layouts, partials and components into one node tree, which
+// is then lowered to a single program. Every file pulled in is recorded as a dependency.
+class Linker {
+public:
+    explicit Linker(std::filesystem::path views_path) : views_path_(std::move(views_path)) {}
+
+    NodeList link(const NodeList& nodes) { return document(nodes, {}, 0); }
+
+    std::vector<Dependency>& dependencies() { return dependencies_; }
+
+private:
+    using Sections = std::unordered_map<std::string, NodeList>;
+    static constexpr int kMaxDepth = 16;
+
+    std::filesystem::path views_path_;
+    std::vector<Dependency> dependencies_;
+
+    static std::shared_ptr<Node> text_node(std::string text) {
+        auto n = std::make_shared<Node>(); n->type = Node::TEXT; n->text = std::move(text);
+        return n;
+    }
+
+    // A template that @extends a layout contributes only its sections; the layout is rendered
+    // with them, and sections from further down the chain take precedence
+    NodeList document(const NodeList& nodes, Sections sections, int depth) {
+        if (depth > kMaxDepth) return {text_node(error_node_text("Views nested too deeply (recursive @extends or @include?)"))};
+        auto extends = std::find_if(nodes.begin(), nodes.end(), [](const auto& n) { return n->type == Node::EXTENDS; });
+        if (extends == nodes.end()) return expand(nodes, sections, nullptr, depth);
+
+        Sections inherited = sections;
+        for (const auto& n : nodes) {
+            if (n->type != Node::SECTION || sections.count(n->name)) continue;
+            sections[n->name] = n->expr.empty() ? expand(n->children, inherited, nullptr, depth) : NodeList{echo_node(n->expr)};
         }
-        // detect inline cpp (only if enabled)
-        size_t open_pos=0, close_pos=0;
-        std::string cpp_code;
-        if (INLINE_CPP_ENABLED && extract_inline_cpp_block(content, open_pos, close_pos, cpp_code)) {
-            if (auto out = compile_and_run_cpp(cpp_code); out) {
-                auto root = std::make_shared<Node>(); root->type = Node::TEXT; root->text = *out; cache_put_file(key, root); write_ast_to_disk(key, root); return root;
-            } else {
-                // compilation failed: run tiny interpreter on the suffix after the closing '}' to produce fallback output
-                std::string suffix = content.substr(close_pos + 1);
-                std::string fallback = tiny_breeze_interpreter(suffix, nlohmann::json::object());
-                auto root = std::make_shared<Node>(); root->type = Node::TEXT; root->text = fallback; cache_put_file(key, root); write_ast_to_disk(key, root); return root;
+        auto layout = load((*extends)->name);
+        if (!layout) return {text_node(not_found((*extends)->name))};
+        return document(*layout, std::move(sections), depth + 1);
+    }
+
+    NodeList expand(const NodeList& nodes, const Sections& sections, const Sections* slots, int depth) {
+        NodeList out;
+        out.reserve(nodes.size());
+        for (const auto& n : nodes) {
+            switch (n->type) {
+                case Node::TEXT: out.push_back(n); break;
+                case Node::VAR: {
+                    // {{ $slot }} / {{ $title }} inside a component are replaced by the caller's slot
+                    if (slots && n->filters.empty()) {
+                        auto name = n->expr.starts_with('$') ? n->expr.substr(1) : n->expr;
+                        if (auto it = slots->find(name); it != slots->end()) {
+                            out.insert(out.end(), it->second.begin(), it->second.end());
+                            break;
+                        }
+                    }
+                    out.push_back(n);
+                    break;
+                }
+                case Node::IF: case Node::UNLESS: case Node::FOREACH: case Node::CACHE: {
+                    auto copy = std::make_shared<Node>(*n);
+                    copy->children = expand(n->children, sections, slots, depth);
+                    out.push_back(std::move(copy));
+                    break;
+                }
+                case Node::YIELD: {
+                    if (auto it = sections.find(n->name); it != sections.end()) {
+                        out.insert(out.end(), it->second.begin(), it->second.end());
+                    } else if (!n->expr.empty()) {
+                        out.push_back(echo_node(n->expr));
+                    }
+                    break;
+                }
+                case Node::INCLUDE: {
+                    auto partial = depth < kMaxDepth ? load(n->name) : nullptr;
+                    if (depth >= kMaxDepth) out.push_back(text_node(error_node_text("Views nested too deeply (recursive @extends or @include?)")));
+                    else if (!partial) out.push_back(text_node(not_found(n->name)));
+                    else append(out, document(*partial, sections, depth + 1));
+                    break;
+                }
+                case Node::COMPONENT: {
+                    if (depth >= kMaxDepth) {
+                        out.push_back(text_node(error_node_text("Views nested too deeply (recursive @component?)")));
+                        break;
+                    }
+                    // Slots are expanded where they are written, so they see the caller's loop variables
+                    Sections component_slots;
+                    NodeList body;
+                    for (const auto& child : n->children) {
+                        if (child->type == Node::SLOT) component_slots[child->name] = expand(child->children, sections, slots, depth);
+                        else body.push_back(child);
+                    }
+                    component_slots["slot"] = expand(body, sections, slots, depth);
+                    auto component = load(n->name);
+                    if (!component) out.push_back(text_node(not_found(n->name)));
+                    else append(out, expand(*component, sections, &component_slots, depth + 1));
+                    break;
+                }
+                // definitions only: consumed by document() / COMPONENT above
+                case Node::EXTENDS: case Node::SECTION: case Node::SLOT: break;
             }
         }
-        // parse and cache AST
-        auto ast = std::make_shared<Node>(); ast->type = Node::TEXT; ast->children = parse_nodes(content, 0);
-        cache_put_file(key, ast);
-        write_ast_to_disk(key, ast);
-        return ast;
-    } catch (...) {
-        return nullptr;
+        return out;
     }
-}
 
-// Updated compile_template that takes file content and caches by content hash
-static std::shared_ptr<Node> compile_template_from_content(const std::string& tpl) {
-    // small in-memory content cache keyed by hash
-    static std::mutex content_cache_mutex;
-    static std::unordered_map<std::size_t, std::shared_ptr<Node>> content_cache;
-    std::size_t h = std::hash<std::string>{}(tpl);
-    {
-        std::lock_guard<std::mutex> lock(content_cache_mutex);
-        auto it = content_cache.find(h);
-        if (it != content_cache.end()) return it->second;
+    static void append(NodeList& out, const NodeList& more) { out.insert(out.end(), more.begin(), more.end()); }
+
+    // @section('title', expr) and @yield('title', default) values are ordinary expressions
+    static std::shared_ptr<Node> echo_node(const std::string& expr) {
+        auto n = std::make_shared<Node>(); n->type = Node::VAR; n->expr = expr;
+        return n;
     }
-    auto root = std::make_shared<Node>(); root->type = Node::TEXT; root->children = parse_nodes(tpl, 0);
-    {
-        std::lock_guard<std::mutex> lock(content_cache_mutex);
-        content_cache.emplace(h, root);
+
+    static std::string not_found(const std::string& name) { return error_node_text("View [" + name + "] not found"); }
+
+    std::optional<std::filesystem::path> resolve(const std::string& name) const {
+        std::string relative = name;
+        std::replace(relative.begin(), relative.end(), '.', '/');
+        for (const auto& ext : View::extensions()) {
+            auto candidate = views_path_ / (relative + ext);
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(candidate, ec)) return candidate;
+        }
+        return std::nullopt;
     }
-    return root;
-}
 
-// --- rendering ---
-static std::string apply_filters(const std::string& input, const std::vector<FilterSpec>& filters, const nlohmann::json& ctx) {
-    std::string out = input;
-    for (const auto& f : filters) {
-        if (f.name == "escape") out = html_escape(out);
-        else if (f.name == "upper") out = to_upper(out);
-        else if (f.name == "lower") out = to_lower(out);
-        else if (f.name == "trim") out = trim(out);
-        else if (f.name == "truncate") {
-            // arg is length or expression
-            int len = 0;
-            if (!f.arg.empty()) {
-                try { ExprParser p(f.arg, ctx); auto v = p.eval(); if (v.is_number()) len = static_cast<int>(v.get<double>()); else len = std::stoi(f.arg); } catch (...) { len = 0; }
-            }
-            if (len > 0 && (int)out.size() > len) out = out.substr(0, len);
-        }
-        else if (f.name == "default") {
-            // arg is expression or literal
-            if (out.empty()) {
-                if (!f.arg.empty()) {
-                    try { ExprParser p(f.arg, ctx); auto v = p.eval(); if (v.is_string()) out = v.get<std::string>(); else if (v.is_number()) out = v.dump(); else if (v.is_boolean()) out = v.get<bool>() ? "true" : "false"; else out = ""; }
-                    catch (...) { out = f.arg; }
-                }
+    // Parsed nodes of view `name`, from the partial cache when the file is unchanged; nullptr if
+    // there is no such view
+    std::shared_ptr<const NodeList> load(const std::string& name) {
+        auto path = resolve(name);
+        if (!path) return nullptr;
+        auto signature = stat_signature(*path);
+        if (!signature) return nullptr;
+        std::shared_ptr<const NodeList> nodes;
+        std::string content_hash;
+        {
+            std::lock_guard<std::mutex> lock(partial_mutex);
+            auto it = partial_cache.find(path->native());
+            if (it != partial_cache.end() && it->second.signature == *signature) {
+                nodes = it->second.nodes;
+                content_hash = it->second.content_hash;
             }
         }
-        else if (f.name == "format") {
-            // simple replacement: replace first '{}' with out, or use {0}
-            std::string fmt = f.arg;
-            if (fmt.empty()) continue;
-            size_t p = fmt.find("{}");
-            if (p != std::string::npos) {
-                std::string res = fmt.substr(0,p) + out + fmt.substr(p+2);
-                out = res;
-            } else {
-                // replace {0}
-                size_t q = fmt.find("{0}");
-                if (q != std::string::npos) {
-                    std::string res = fmt.substr(0,q) + out + fmt.substr(q+3);
-                    out = res;
-                }
-            }
+        if (!nodes) {
+            auto content = read_file_to_string(*path);
+            if (!content) return nullptr;
+            content_hash = sha1_hex(*content);
+            nodes = std::make_shared<const NodeList>(parse_nodes(*content));
+            std::lock_guard<std::mutex> lock(partial_mutex);
+            partial_cache[path->native()] = PartialEntry{*signature, content_hash, nodes};
         }
-        else {
-            // unknown filter: ignore
+        bool recorded = std::any_of(dependencies_.begin(), dependencies_.end(), [&](const auto& d) { return d.path == *path; });
+        if (!recorded) dependencies_.push_back({*path, *signature, content_hash});
+        return nodes;
+    }
+};
+
+// Compile template source, running the opt-in @cpp{ } block when inline C++ is enabled
+static blade::Program compile_source(const std::string& content, std::vector<Dependency>& dependencies) {
+    size_t open_pos=0, close_pos=0;
+    std::string cpp_code;
+    if (INLINE_CPP_ENABLED && extract_inline_cpp_block(content, open_pos, close_pos, cpp_code)) {
+        std::string text;
+        if (auto out = compile_and_run_cpp(cpp_code); out) {
+            text = *out;
+        } else {
+            // compilation failed: run tiny interpreter on the suffix after the closing '}' to produce fallback output
+            text = tiny_breeze_interpreter(content.substr(close_pos + 1), nlohmann::json::object());
         }
+        blade::Program program;
+        if (!text.empty()) program.code.push_back({blade::Op::Text, 0, static_cast<std::uint32_t>(text.size()), 0});
+        program.pool = std::move(text);
+        return program;
     }
+    Linker linker(views_path());
+    auto program = blade::compile_nodes(linker.link(parse_nodes(content)));
+    dependencies = std::move(linker.dependencies());
+    return program;
+}
+
+// "<sha1> <path>" per linked partial, stored in the precompiled file
+static std::string dependency_manifest(const std::vector<Dependency>& dependencies) {
+    std::string out;
+    for (const auto& d : dependencies) out += d.content_hash + " " + d.path.string() + "\n";
     return out;
 }
 
-static std::string render_nodes(const std::vector<std::shared_ptr<Node>>& nodes, const nlohmann::json& ctx);
+// A precompiled program is only reused if every partial it linked still has the same content
+static std::optional<std::vector<Dependency>> verify_manifest(std::string_view manifest) {
+    std::vector<Dependency> dependencies;
+    while (!manifest.empty()) {
+        auto eol = manifest.find('\n');
+        auto line = manifest.substr(0, eol);
+        manifest.remove_prefix(eol == std::string_view::npos ? manifest.size() : eol + 1);
+        auto space = line.find(' ');
+        if (space == std::string_view::npos) return std::nullopt;
+        Dependency d;
+        d.content_hash = std::string(line.substr(0, space));
+        d.path = std::string(line.substr(space + 1));
+        auto signature = stat_signature(d.path);
+        auto content = signature ? read_file_to_string(d.path) : std::nullopt;
+        if (!content || sha1_hex(*content) != d.content_hash) return std::nullopt;
+        d.signature = *signature;
+        dependencies.push_back(std::move(d));
+    }
+    return dependencies;
+}
+
+static SharedProgram cache_program(const std::filesystem::path& path, const FileSignature& signature, SharedProgram program,
+                                   std::vector<Dependency> dependencies) {
+    cache_put_file(path.native(), program, signature, std::move(dependencies));
+    return program;
+}
 
-static std::string render_node(const std::shared_ptr<Node>& node, const nlohmann::json& ctx) {
+// Memory cache by path (validated with stat), then the precompiled file for the content hash
+// (mapped, not decoded), then compile and write that file for the next process
+static SharedProgram compile_template_from_file(const std::filesystem::path& path) {
     try {
-        switch (node->type) {
-            case Node::TEXT: return node->text;
-            case Node::VAR: {
-                ExprParser p(node->expr, ctx);
-                nlohmann::json v = p.eval();
-                std::string out;
-                if (v.is_string()) out = v.get<std::string>();
-                else if (v.is_number()) out = v.dump();
-                else if (v.is_boolean()) out = v.get<bool>() ? "true" : "false";
-                else if (v.is_null()) out = ""; else out = v.dump();
-                out = apply_filters(out, node->filters, ctx);
-                return out;
-            }
-            case Node::IF: {
-                ExprParser p(node->expr, ctx);
-                bool cond = p.eval_bool();
-                if (cond) return render_nodes(node->children, ctx);
-                return std::string{};
-            }
-            case Node::UNLESS: {
-                ExprParser p(node->expr, ctx);
-                bool cond = p.eval_bool();
-                if (!cond) return render_nodes(node->children, ctx);
-                return std::string{};
-            }
-            case Node::FOREACH: {
-                // lookup list
-                if (auto p = get_json_ptr(node->list_name, ctx); p && p->is_array()) {
-                    std::string out;
-                    for (const auto& item : *p) {
-                        nlohmann::json local = ctx;
-                        local[node->item_name] = item;
-                        out += render_nodes(node->children, local);
-                    }
-                    return out;
-                }
-                return std::string{};
-            }
+        if (auto program = cache_get_file(path); program) return program;
+        // stat before reading: an edit racing with the read leaves a signature that no longer matches
+        auto signature = stat_signature(path);
+        if (!signature) return nullptr;
+        auto content = read_file_to_string(path);
+        if (!content) return nullptr;
+        auto compiled = compiled_path(sha1_hex(*content));
+        if (auto mapped = blade::MappedProgram::open(compiled); mapped) {
+            // compiled while inline C++ was disabled: the program still holds the raw @cpp{ block
+            bool raw_cpp = INLINE_CPP_ENABLED && content->find("@cpp{") != std::string::npos &&
+                           mapped->view().pool.find("@cpp{") != std::string_view::npos;
+            auto dependencies = raw_cpp ? std::nullopt : verify_manifest(mapped->dependencies());
+            if (dependencies) return cache_program(path, *signature, share(std::move(mapped)), std::move(*dependencies));
         }
-    } catch (const ExprError& e) {
-        std::ostringstream oss; oss << "[Template Error: expr=\"" << e.expr << "\" pos=" << e.pos << " msg=" << e.what() << "]"; return oss.str();
-    } catch (const std::exception& ex) {
-        std::ostringstream oss; oss << "[Template Error: msg=" << ex.what() << "]"; return oss.str();
+        std::vector<Dependency> dependencies;
+        auto program = compile_source(*content, dependencies);
+        blade::save(program, compiled, dependency_manifest(dependencies));
+        return cache_program(path, *signature, share(std::move(program)), std::move(dependencies));
+    } catch (...) {
+        return nullptr;
     }
-    return std::string{};
 }
 
-static std::string render_nodes(const std::vector<std::shared_ptr<Node>>& nodes, const nlohmann::json& ctx) {
+bool Blade::precompile(const std::filesystem::path& file_path) {
+    try {
+        auto content = read_file_to_string(file_path);
+        if (!content) return false;
+        std::vector<Dependency> dependencies;
+        auto program = compile_source(*content, dependencies);
+        return blade::save(program, compiled_path(sha1_hex(*content)), dependency_manifest(dependencies));
+    } catch (...) {
+        return false;
+    }
+}
+
+// Programs for inline template strings, keyed by the template text itself
+struct ContentKeyHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+// and re-linked when a partial it pulls in has changed
+struct ContentEntry {
+    SharedProgram program;
+    std::vector<Dependency> dependencies;
+};
+
+static SharedProgram compile_template_from_content(std::string_view tpl) {
+    static std::mutex content_cache_mutex;
+    static std::unordered_map<std::string, ContentEntry, ContentKeyHash, std::equal_to<>> content_cache;
+    {
+        std::lock_guard<std::mutex> lock(content_cache_mutex);
+        auto it = content_cache.find(tpl);
+        if (it != content_cache.end() && dependencies_unchanged(it->second.dependencies)) return it->second.program;
+    }
+    Linker linker(views_path());
+    auto program = share(blade::compile_nodes(linker.link(parse_nodes(tpl))));
+    {
+        std::lock_guard<std::mutex> lock(content_cache_mutex);
+        content_cache.insert_or_assign(std::string(tpl), ContentEntry{program, std::move(linker.dependencies())});
+    }
+    return program;
+}
+
+std::string Blade::render(std::string_view tpl, const nlohmann::json& context) const {
     std::string out;
-    for (const auto& n : nodes) out += render_node(n, ctx);
+    render_to(out, tpl, context);
     return out;
 }
 
-// Update Blade::render to use compile_template_from_content
-std::string Blade::render(std::string_view tpl, const nlohmann::json& context) const {
-    std::string content{tpl};
-    auto root = compile_template_from_content(content);
-    try {
-        return render_nodes(root->children, context);
-    } catch (const ExprError& e) {
-        std::ostringstream oss; oss << "[Template Error: expr=\"" << e.expr << "\" pos=" << e.pos << " msg=" << e.what() << "]"; return oss.str();
-    } catch (const std::exception& ex) {
-        std::ostringstream oss; oss << "[Template Error: msg=" << ex.what() << "]"; return oss.str();
-    }
+void Blade::render_to(std::string& out, std::string_view tpl, const nlohmann::json& context) const {
+    auto program = compile_template_from_content(tpl);
+    blade::execute(*program, context, out);
+}
+
+// Span detail for a view: the file name, viewed in place inside the stored path
+static std::string_view file_name_view(const std::filesystem::path& file_path) {
+    std::string_view native = file_path.native();
+    auto slash = native.find_last_of('/');
+    return slash == std::string_view::npos ? native : native.substr(slash + 1);
 }
 
 // Implement render_from_file using file-based cache
 std::string Blade::render_from_file(const std::filesystem::path& file_path, const nlohmann::json& context) const {
-    auto ast = compile_template_from_file(file_path);
-    if (!ast) return "View not found: " + file_path.string();
-    try {
-        return render_nodes(ast->children, context);
-    } catch (const ExprError& e) {
-        std::ostringstream oss; oss << "[Template Error: expr=\"" << e.expr << "\" pos=" << e.pos << " msg=" << e.what() << "]"; return oss.str();
-    } catch (const std::exception& ex) {
-        std::ostringstream oss; oss << "[Template Error: msg=" << ex.what() << "]"; return oss.str();
+    std::string out;
+    render_from_file_to(out, file_path, context);
+    return out;
+}
+
+void Blade::render_from_file_to(std::string& out, const std::filesystem::path& file_path, const nlohmann::json& context) const {
+    breeze::support::Span span("view", file_name_view(file_path));
+    auto program = compile_template_from_file(file_path);
+    if (!program) {
+        out += "View not found: " + file_path.string();
+        return;
     }
+    blade::execute(*program, context, out);
 }
 
-// Adjust cache parameters and inline flag from application config at runtime (called when rendering from file)
-static void load_cache_config_from_app() {
-    try {
-        if (breeze::core::Application::has_instance()) {
-            auto& app = breeze::core::Application::instance();
-            CACHE_MAX_ITEMS = std::stoul(app.config().get("view.cache.max_items", std::to_string(CACHE_MAX_ITEMS)));
-            int ttl = std::stoi(app.config().get("view.cache.ttl_seconds", std::to_string(CACHE_TTL.count())));
-            CACHE_TTL = std::chrono::seconds(ttl);
-            std::string inline_flag = app.config().get("view.inline_cpp.enabled", "false");
-            std::transform(inline_flag.begin(), inline_flag.end(), inline_flag.begin(), [](unsigned char c){ return std::tolower(c); });
-            INLINE_CPP_ENABLED = (inline_flag == "1" || inline_flag == "true" || inline_flag == "yes");
-        }
-    } catch (...) {
-        // ignore
+void Blade::stream_from_file(const std::filesystem::path& file_path, const nlohmann::json& context,
+                             const ChunkSink& sink, std::size_t chunk_size) const {
+    breeze::support::Span span("view", file_name_view(file_path));
+    auto program = compile_template_from_file(file_path);
+    if (!program) {
+        sink("View not found: " + file_path.string());
+        return;
     }
-    // env var override
+    std::string buffer;
+    buffer.reserve(chunk_size + 256);
+    blade::execute(*program, context, buffer, sink, chunk_size);
+}
+
+// BREEZE_INLINE_CPP overrides view.inline_cpp.enabled
+static void apply_inline_cpp_env_override() {
     const char* env = std::getenv("BREEZE_INLINE_CPP");
     if (env) {
         std::string e(env);
@@ -734,125 +2067,402 @@ static void load_cache_config_from_app() {
     if (INLINE_CPP_ENABLED) std::cerr << "[Warning] Inline C++ compilation is ENABLED (BREEZE_INLINE_CPP or view.inline_cpp.enabled). Only enable for trusted templates." << std::endl;
 }
 
-// Ensure cache config is loaded before first render_from_file
-static struct CacheConfigLoader { CacheConfigLoader() { load_cache_config_from_app(); } } cache_config_loader_instance;
+// The environment override applies even if the application never calls Blade::configure
+static struct CacheConfigLoader { CacheConfigLoader() { apply_inline_cpp_env_override(); } } cache_config_loader_instance;
+
+bool Blade::immutable() {
+    return VIEWS_IMMUTABLE.load(std::memory_order_relaxed);
+}
+
+void Blade::configure(const BladeOptions& options) {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        CACHE_MAX_ITEMS = std::max<std::size_t>(options.max_items, 1);
+        CACHE_TTL = options.ttl;
+        CHECK_INTERVAL = options.check_interval;
+        VIEWS_IMMUTABLE = options.immutable;
+        COMPILED_VIEWS_ENABLED = options.compiled;
+        INLINE_CPP_ENABLED = options.inline_cpp;
+        VIEWS_PATH = options.views_path;
+        VIEWS_ROOT_KEY = views_root_key(VIEWS_PATH);
+    }
+    view_cache_dir();
+    blade::AUTOESCAPE_ENABLED = options.autoescape;
+    FragmentCache::instance().configure(options.fragment_cache_items);
+    apply_inline_cpp_env_override();
+}
+
+namespace blade {
+
+Program compile(std::string_view source) {
+    return compile(source, views_path());
+}
+
+Program compile(std::string_view source, const std::filesystem::path& views_path,
+                std::vector<std::filesystem::path>* dependencies) {
+    Linker linker(views_path);
+    auto program = compile_nodes(linker.link(parse_nodes(source)));
+    if (dependencies) {
+        for (auto& d : linker.dependencies()) dependencies->push_back(std::move(d.path));
+    }
+    return program;
+}
+
+// Compiled views register from static initializers, so the registry is built on first use
+static std::unordered_map<std::string, CompiledView, ContentKeyHash, std::equal_to<>>& compiled_registry() {
+    static std::unordered_map<std::string, CompiledView, ContentKeyHash, std::equal_to<>> registry;
+    return registry;
+}
+
+bool register_compiled(std::string_view name, std::string_view image, CompiledRender render) {
+    auto program = load(image);
+    if (!program) {
+        std::cerr << "[Warning] Compiled view '" << name << "' was built for another template format; it will be interpreted" << std::endl;
+        return false;
+    }
+    compiled_registry().insert_or_assign(std::string(name), CompiledView{*program, render});
+    return true;
+}
+
+const CompiledView* find_compiled(std::string_view name) {
+    if (!COMPILED_VIEWS_ENABLED.load(std::memory_order_relaxed)) return nullptr;
+    const auto& registry = compiled_registry();
+    auto it = registry.find(name);
+    return it != registry.end() ? &it->second : nullptr;
+}
+
+void execute(const CompiledView& view, const nlohmann::json& context, std::string& out) {
+    Interpreter interpreter(view.program, context, out);
+    Frame frame(interpreter);
+    view.render(frame);
+}
+
+void execute(const CompiledView& view, const nlohmann::json& context, std::string& buffer,
+             const ChunkSink& sink, std::size_t chunk_size) {
+    Interpreter interpreter(view.program, context, buffer);
+    interpreter.stream_to(sink, chunk_size);
+    Frame frame(interpreter);
+    view.render(frame);
+    interpreter.finish();
+}
+
+} // namespace blade
 
-// parse helpers: find next token position among {{, @if(, @unless(, @foreach(, @endif, @endunless, @endforeach
-static size_t find_next_special(const std::string& s, size_t start) {
-    std::vector<size_t> pos;
-    auto add = [&](const std::string& t){ size_t p = s.find(t, start); if (p != std::string::npos) pos.push_back(p); };
-    add("{{"); add("@if("); add("@unless("); add("@foreach("); add("@endif"); add("@endunless"); add("@endforeach");
-    if (pos.empty()) return std::string::npos;
-    return *std::min_element(pos.begin(), pos.end());
+static std::string_view trim_view(std::string_view s) {
+    size_t a = 0, b = s.size();
+    while (a < b && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
+    while (b > a && std::isspace(static_cast<unsigned char>(s[b-1]))) --b;
+    return s.substr(a, b - a);
 }
 
-static std::vector<FilterSpec> parse_filters(const std::string& s) {
+static std::vector<FilterSpec> parse_filters(std::string_view s) {
     std::vector<FilterSpec> out;
-    std::istringstream ss(s);
-    std::string token;
-    while (std::getline(ss, token, '|')) {
-        token = trim(token);
+    while (!s.empty()) {
+        size_t bar = s.find('|');
+        auto token = trim_view(s.substr(0, bar));
+        s.remove_prefix(bar == std::string_view::npos ? s.size() : bar + 1);
         if (token.empty()) continue;
         size_t p = token.find('(');
-        if (p == std::string::npos) { out.push_back({token, ""}); continue; }
+        if (p == std::string_view::npos) { out.push_back({std::string(token), ""}); continue; }
         size_t q = token.rfind(')');
-        std::string name = trim(token.substr(0, p));
-        std::string arg = "";
-        if (q != std::string::npos && q > p) arg = trim(token.substr(p+1, q - (p+1)));
-        out.push_back({name, arg});
+        std::string arg;
+        if (q != std::string_view::npos && q > p) arg = trim_view(token.substr(p + 1, q - (p + 1)));
+        out.push_back({std::string(trim_view(token.substr(0, p))), std::move(arg)});
+    }
+    return out;
+}
+
+// Index of the ')' closing the '(' at `open`, skipping quoted strings and nested parentheses
+static size_t find_close_paren(std::string_view s, size_t open) {
+    int depth = 0;
+    char quote = 0;
+    for (size_t i = open; i < s.size(); ++i) {
+        char c = s[i];
+        if (quote) {
+            if (c == '\\') ++i;
+            else if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')' && --depth == 0) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Directive arguments split at top-level commas: @section('title', 'Home') -> {'title', 'Home'}
+static std::vector<std::string> split_args(std::string_view args) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    int depth = 0;
+    char quote = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+        char c = args[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            out.emplace_back(trim_view(args.substr(start, i - start)));
+            start = i + 1;
+        }
     }
+    auto last = trim_view(args.substr(start));
+    if (!last.empty() || !out.empty()) out.emplace_back(last);
     return out;
 }
 
-static std::vector<std::shared_ptr<Node>> parse_nodes(const std::string& s, size_t start, const std::string& end_tag) {
-    std::vector<std::shared_ptr<Node>> nodes;
-    size_t pos = start;
-    while (pos < s.size()) {
-        size_t next = find_next_special(s, pos);
-        if (next == std::string::npos) {
-            auto n = std::make_shared<Node>(); n->type = Node::TEXT; n->text = s.substr(pos); nodes.push_back(n); break;
-        }
-        if (next > pos) {
-            auto n = std::make_shared<Node>(); n->type = Node::TEXT; n->text = s.substr(pos, next - pos); nodes.push_back(n);
-        }
-        if (!end_tag.empty() && s.compare(next, end_tag.size(), end_tag) == 0) {
-            // consume end_tag and return
-            pos = next + end_tag.size();
-            return nodes;
-        }
-        if (s.compare(next, 2, "{{") == 0) {
-            size_t close = s.find("}}", next+2);
-            if (close == std::string::npos) { auto n = std::make_shared<Node>(); n->type = Node::TEXT; n->text = s.substr(next); nodes.push_back(n); break; }
-            std::string inside = trim(s.substr(next+2, close - (next+2)));
-            size_t p = inside.find('|');
-            std::string expr = inside; std::string filt_str;
-            if (p != std::string::npos) { expr = trim(inside.substr(0,p)); filt_str = inside.substr(p+1); }
-            auto n = std::make_shared<Node>(); n->type = Node::VAR; n->expr = expr; n->filters = parse_filters(filt_str); nodes.push_back(n);
-            pos = close + 2; continue;
-        }
-        if (s.compare(next, 4, "@if(") == 0) {
-            size_t open_par = next + 4;
-            size_t close_par = s.find(')', open_par);
-            if (close_par == std::string::npos) { pos = next + 4; continue; }
-            std::string cond = trim(s.substr(open_par, close_par - open_par));
-            size_t inner_start = close_par + 1;
-            auto children = parse_nodes(s, inner_start, "@endif");
-            auto n = std::make_shared<Node>(); n->type = Node::IF; n->expr = cond; n->children = std::move(children);
-            nodes.push_back(n);
-            // advance pos beyond matching @endif
-            size_t scan = inner_start; int depth = 1;
-            while (scan < s.size() && depth > 0) {
-                size_t a = s.find("@if(", scan);
-                size_t b = s.find("@endif", scan);
-                if (b == std::string::npos) { scan = s.size(); break; }
-                if (a != std::string::npos && a < b) { depth++; scan = a + 4; } else { depth--; scan = b + 6; }
+static std::string unquote(const std::string& arg) {
+    if (arg.size() >= 2 && (arg.front() == '\'' || arg.front() == '"') && arg.back() == arg.front()) return arg.substr(1, arg.size() - 2);
+    return arg;
+}
+
+// `users as user` / `$users as $user`: the path before the first standalone `as` and the name after it
+static void parse_loop_header(std::string_view header, std::string& list_name, std::string& item_name) {
+    auto word = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.'; };
+    for (size_t as = header.find("as"); as != std::string_view::npos; as = header.find("as", as + 1)) {
+        if (as == 0 || as + 2 >= header.size()) continue;
+        if (!std::isspace(static_cast<unsigned char>(header[as - 1])) || !std::isspace(static_cast<unsigned char>(header[as + 2]))) continue;
+        size_t list_end = as;
+        while (list_end > 0 && std::isspace(static_cast<unsigned char>(header[list_end - 1]))) --list_end;
+        size_t list_start = list_end;
+        while (list_start > 0 && word(header[list_start - 1])) --list_start;
+        if (list_start == list_end) continue;
+        if (list_start > 0 && header[list_start - 1] == '$') --list_start;
+        size_t item_start = as + 2;
+        while (item_start < header.size() && std::isspace(static_cast<unsigned char>(header[item_start]))) ++item_start;
+        if (item_start < header.size() && header[item_start] == '$') ++item_start;
+        size_t item_end = item_start;
+        while (item_end < header.size() && word(header[item_end])) ++item_end;
+        if (item_end == item_start) continue;
+        list_name = header.substr(list_start, list_end - list_start);
+        item_name = header.substr(item_start, item_end - item_start);
+        return;
+    }
+}
+
+// Directives that take arguments, and the end tag of those that open a block
+struct DirectiveSpec {
+    std::string_view name;
+    Node::Type type;
+    std::string_view end;   // empty: single directive
+};
+
+constexpr DirectiveSpec kDirectives[] = {
+    {"if", Node::IF, "endif"}, {"unless", Node::UNLESS, "endunless"}, {"foreach", Node::FOREACH, "endforeach"},
+    {"extends", Node::EXTENDS, ""}, {"yield", Node::YIELD, ""}, {"include", Node::INCLUDE, ""},
+    {"section", Node::SECTION, "endsection"},   // a block only without an inline value
+    {"component", Node::COMPONENT, "endcomponent"}, {"slot", Node::SLOT, "endslot"}, {"cache", Node::CACHE, "endcache"},
+};
+
+// Splits a template into text, echoes and directives in one left-to-right pass: it stops only at
+// '{' and '@', and each token is consumed once, so lexing is linear in the template size
+class Lexer {
+public:
+    struct Token {
+        enum Kind { Text, Echo, Directive, End } kind = Text;
+        std::string_view text;            // Text: the text; Echo: inside the braces; End: the tag name
+        bool raw = false;                 // Echo written as {!! !!}
+        const DirectiveSpec* directive = nullptr;
+        std::string_view args;            // Directive: inside the parentheses
+
+        Token() = default;
+        Token(Kind k, std::string_view t = {}) : kind(k), text(t) {}
+    };
+
+    explicit Lexer(std::string_view s) : s_(s) {}
+
+    bool next(Token& token) {
+        if (pending_) {
+            token = *pending_;
+            pending_.reset();
+            return true;
+        }
+        while (pos_ < s_.size()) {
+            size_t at = s_.find_first_of("{@", scan_);
+            if (at == std::string_view::npos) break;
+            scan_ = at + 1;
+            if (s_[at] == '{' ? echo(at, token) : directive(at, token)) return true;
+        }
+        // the rest is text
+        if (pos_ >= s_.size()) return false;
+        token = Token{Token::Text, s_.substr(pos_)};
+        pos_ = scan_ = s_.size();
+        return true;
+    }
+
+private:
+    std::string_view s_;
+    size_t pos_ = 0;    // start of text not yet returned
+    size_t scan_ = 0;   // where to look for the next '{' or '@'
+    std::optional<Token> pending_;   // token found behind text that was returned first
+    // Parentheses matched by the last scan that ran off the end unclosed: for every '(' it passed
+    // outside quotes, the ')' closing it (npos if none). A later '(' behind it reuses the result
+    // instead of rescanning to the end, which would be quadratic in a template with many of them.
+    size_t unclosed_from_ = std::string_view::npos;
+    std::unordered_map<size_t, size_t> unclosed_matches_;
+
+    size_t close_paren(size_t open) {
+        if (unclosed_from_ != std::string_view::npos && open >= unclosed_from_) {
+            if (auto it = unclosed_matches_.find(open); it != unclosed_matches_.end()) return it->second;
+        }
+        size_t close = find_close_paren(s_, open);
+        if (close == std::string_view::npos) index_unclosed(open);
+        return close;
+    }
+
+    // Same walk as find_close_paren, matching every '(' on the way with a stack
+    void index_unclosed(size_t open) {
+        unclosed_from_ = open;
+        unclosed_matches_.clear();
+        std::vector<size_t> stack;
+        char quote = 0;
+        for (size_t i = open; i < s_.size(); ++i) {
+            char c = s_[i];
+            if (quote) {
+                if (c == '\\') ++i;
+                else if (c == quote) quote = 0;
+            } else if (c == '\'' || c == '"') {
+                quote = c;
+            } else if (c == '(') {
+                stack.push_back(i);
+            } else if (c == ')' && !stack.empty()) {
+                unclosed_matches_[stack.back()] = i;
+                stack.pop_back();
+            }
+        }
+        for (size_t left : stack) unclosed_matches_[left] = std::string_view::npos;
+    }
+
+    // Consume [at, end) as `next` (nothing: dropped). Text before `at` is returned first and the
+    // token on the following call; false when there is nothing to return yet.
+    bool emit(size_t at, size_t end, std::optional<Token> next, Token& token) {
+        bool text = at > pos_;
+        if (text) {
+            token = Token{Token::Text, s_.substr(pos_, at - pos_)};
+            pending_ = next;
+        } else if (next) {
+            token = *next;
+        }
+        pos_ = scan_ = end;
+        return text || next;
+    }
+
+    bool echo(size_t at, Token& token) {
+        bool raw = s_.compare(at, 3, "{!!") == 0;
+        if (!raw && s_.compare(at, 2, "{{") != 0) return false;
+        size_t open_len = raw ? 3 : 2;
+        size_t close = s_.find(raw ? "!!}" : "}}", at + open_len);
+        if (close == std::string_view::npos) {
+            // unterminated: everything from here on is text
+            scan_ = s_.size();
+            return false;
+        }
+        Token t{Token::Echo, s_.substr(at + open_len, close - at - open_len)};
+        t.raw = raw;
+        return emit(at, close + open_len, t, token);
+    }
+
+    bool directive(size_t at, Token& token) {
+        size_t name_end = at + 1;
+        while (name_end < s_.size() && std::isalpha(static_cast<unsigned char>(s_[name_end]))) ++name_end;
+        auto name = s_.substr(at + 1, name_end - at - 1);
+        if (name.empty()) return false;
+        for (const auto& spec : kDirectives) {
+            if (name == spec.end) return emit(at, name_end, Token{Token::End, name}, token);
+            if (name != spec.name || name_end >= s_.size() || s_[name_end] != '(') continue;
+            size_t close = close_paren(name_end);
+            if (close == std::string_view::npos) {
+                // no closing ')': drop the "@name(" opener and keep lexing after it
+                return emit(at, name_end + 1, std::nullopt, token);
+            }
+            Token t(Token::Directive);
+            t.directive = &spec;
+            t.args = s_.substr(name_end + 1, close - name_end - 1);
+            return emit(at, close + 1, t, token);
+        }
+        return false;
+    }
+};
+
+// Build the node tree from the token stream. Open blocks live on a stack, so each end tag closes
+// the innermost block it belongs to (closing any unterminated blocks inside it) without rescanning
+static std::vector<std::shared_ptr<Node>> parse_nodes(std::string_view s) {
+    std::vector<std::shared_ptr<Node>> root;
+    struct Open {
+        Node* node;
+        std::string_view end;
+    };
+    std::vector<Open> open;
+    auto children = [&]() -> std::vector<std::shared_ptr<Node>>& { return open.empty() ? root : open.back().node->children; };
+    auto add_text = [&](std::string_view text) {
+        if (text.empty()) return;
+        auto n = std::make_shared<Node>(); n->type = Node::TEXT; n->text = text;
+        children().push_back(std::move(n));
+    };
+
+    Lexer lexer(s);
+    Lexer::Token token;
+    while (lexer.next(token)) {
+        switch (token.kind) {
+            case Lexer::Token::Text: add_text(token.text); break;
+            case Lexer::Token::Echo: {
+                auto inside = trim_view(token.text);
+                size_t bar = inside.find('|');
+                auto n = std::make_shared<Node>(); n->type = Node::VAR; n->raw = token.raw;
+                n->expr = trim_view(inside.substr(0, bar));
+                if (bar != std::string_view::npos) n->filters = parse_filters(inside.substr(bar + 1));
+                children().push_back(std::move(n));
+                break;
             }
-            pos = scan; continue;
-        }
-        if (s.compare(next, 8, "@unless(") == 0) {
-            size_t open_par = next + 8;
-            size_t close_par = s.find(')', open_par);
-            if (close_par == std::string::npos) { pos = next + 8; continue; }
-            std::string cond = trim(s.substr(open_par, close_par - open_par));
-            size_t inner_start = close_par + 1;
-            auto children = parse_nodes(s, inner_start, "@endunless");
-            auto n = std::make_shared<Node>(); n->type = Node::UNLESS; n->expr = cond; n->children = std::move(children);
-            nodes.push_back(n);
-            size_t scan = inner_start; int depth = 1;
-            while (scan < s.size() && depth > 0) {
-                size_t a = s.find("@unless(", scan);
-                size_t b = s.find("@endunless", scan);
-                if (b == std::string::npos) { scan = s.size(); break; }
-                if (a != std::string::npos && a < b) { depth++; scan = a + 8; } else { depth--; scan = b + 10; }
+            case Lexer::Token::End: {
+                auto it = std::find_if(open.rbegin(), open.rend(), [&](const Open& o) { return o.end == token.text; });
+                if (it == open.rend()) {
+                    // an end tag with no open block is plain text
+                    add_text(std::string_view(token.text.data() - 1, token.text.size() + 1));
+                    break;
+                }
+                open.erase(std::next(it).base(), open.end());
+                break;
             }
-            pos = scan; continue;
-        }
-        if (s.compare(next, 9, "@foreach(") == 0) {
-            size_t open_par = next + 9;
-            size_t close_par = s.find(')', open_par);
-            if (close_par == std::string::npos) { pos = next + 9; continue; }
-            std::string inside = trim(s.substr(open_par, close_par - open_par));
-            std::regex rx(R"(([a-zA-Z0-9._]+)\s+as\s+([a-zA-Z0-9._]+))");
-            std::smatch m;
-            std::string list_name, item_name;
-            if (std::regex_search(inside, m, rx)) { list_name = m[1].str(); item_name = m[2].str(); }
-            size_t inner_start = close_par + 1;
-            auto children = parse_nodes(s, inner_start, "@endforeach");
-            auto n = std::make_shared<Node>(); n->type = Node::FOREACH; n->list_name = list_name; n->item_name = item_name; n->children = std::move(children);
-            nodes.push_back(n);
-            size_t scan = inner_start; int depth = 1;
-            while (scan < s.size() && depth > 0) {
-                size_t a = s.find("@foreach(", scan);
-                size_t b = s.find("@endforeach", scan);
-                if (b == std::string::npos) { scan = s.size(); break; }
-                if (a != std::string::npos && a < b) { depth++; scan = a + 9; } else { depth--; scan = b + 10; }
+            case Lexer::Token::Directive: {
+                const auto& spec = *token.directive;
+                auto n = std::make_shared<Node>(); n->type = spec.type;
+                bool block = !spec.end.empty();
+                switch (spec.type) {
+                    case Node::IF: case Node::UNLESS: n->expr = trim_view(token.args); break;
+                    case Node::FOREACH: parse_loop_header(trim_view(token.args), n->list_name, n->item_name); break;
+                    case Node::CACHE: {
+                        // the key is an expression over the view data, not a name
+                        auto args = split_args(token.args);
+                        if (!args.empty()) n->expr = args[0];
+                        if (args.size() > 1) n->text = args[1];
+                        break;
+                    }
+                    default: {
+                        // @extends('layout'), @yield('name'[, default]), @include('view'),
+                        // @section('name'[, value]), @component('view'), @slot('name')
+                        auto args = split_args(token.args);
+                        if (!args.empty()) n->name = unquote(args[0]);
+                        if (args.size() > 1) n->expr = args[1];
+                        if (spec.type == Node::SECTION && args.size() > 1) block = false;
+                        break;
+                    }
+                }
+                auto* raw = n.get();
+                children().push_back(std::move(n));
+                if (block) open.push_back({raw, spec.end});
+                break;
             }
-            pos = scan; continue;
         }
-        // fallback to move one char to avoid infinite loop
-        pos = next + 1;
     }
-    return nodes;
+    return root;
 }
 
 } // namespace breeze::support
@@ -0,0 +1,213 @@
+#include <breeze/support/blade_program.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace breeze::support::blade {
+
+namespace {
+
+// A C++ string literal for `text`, broken after each newline so generated code stays readable.
+// Octal escapes are fixed-width, so a following digit can never extend them.
+std::string literal(std::string_view text, const std::string& continuation) {
+    std::string out = "\"";
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if (c < 0x20 || c == 0x7f) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\%03o", c);
+                    out += buf;
+                } else {
+                    out.push_back(static_cast<char>(c));
+                }
+        }
+        if (c == '\n' && i + 1 < text.size()) out += "\"\n" + continuation + "\"";
+    }
+    out += '"';
+    return out;
+}
+
+// The expression's source on one line, for a trailing comment
+std::string comment(const Program& program, std::uint32_t expr) {
+    const auto& e = program.exprs[expr];
+    std::string text(program.str(e.source, e.source_len));
+    for (auto& c : text) if (c == '\n' || c == '\r') c = ' ';
+    return text;
+}
+
+struct Block {
+    bool loop = false;
+    std::uint32_t end = 0;   // @if / @cache: first instruction after the block; loop: its LoopEnd
+    bool cache = false;
+    std::string_view item;   // loop: the variable name, bound to local `item<depth>`
+    std::size_t depth = 0;
+};
+
+// Nesting depth of the loop `open` would enter next
+std::size_t loop_depth(const std::vector<Block>& open) {
+    return static_cast<std::size_t>(std::count_if(open.begin(), open.end(), [](const Block& b) { return b.loop; }));
+}
+
+// A plain path as a `const nlohmann::json*` expression, one Frame::member() per component;
+// empty for any other expression. As in Evaluator::lookup, the first component names the
+// innermost enclosing @foreach variable it matches, or else a key of the root context.
+std::string path_access(const Program& program, std::uint32_t expr, const std::vector<Block>& open) {
+    const auto& e = program.exprs[expr];
+    if (e.kind != ExprKind::Path) return {};
+    const auto& first = program.segments[e.str];
+    std::string access = "f.root()";
+    std::uint32_t i = 0;
+    for (auto block = open.rbegin(); block != open.rend(); ++block) {
+        if (block->loop && block->item == program.str(first.str, first.len)) {
+            access = "item" + std::to_string(block->depth);
+            i = 1;
+            break;
+        }
+    }
+    for (; i < e.len; ++i) {
+        const auto& seg = program.segments[e.str + i];
+        access = "Frame::member(" + access + ", " + literal(program.str(seg.str, seg.len), "") + ", " +
+                 std::to_string(seg.index) + ")";
+    }
+    return access;
+}
+
+// An @if / @unless test on a plain path or its negation as a C++ condition (true: render the
+// block); empty for any other expression
+std::string path_test(const Program& program, std::uint32_t expr, bool negate, const std::vector<Block>& open) {
+    const auto& e = program.exprs[expr];
+    if (e.kind == ExprKind::Not) {
+        expr = e.lhs;
+        negate = !negate;
+    }
+    auto access = path_access(program, expr, open);
+    if (access.empty()) return {};
+    return (negate ? "!Frame::truthy(" : "Frame::truthy(") + access + ")";
+}
+
+} // namespace
+
+std::string generate_cpp(const Program& program, std::string_view name, std::string_view source_path) {
+    std::string body;
+    std::vector<Block> open;
+    auto indent = [&open] { return std::string(4 * (open.size() + 1), ' '); };
+    auto line = [&body, &indent](const std::string& text) { body += indent() + text + "\n"; };
+    auto enter = [&open](Block block) {
+        if (!open.empty() && block.end > open.back().end) throw std::runtime_error("block crosses its enclosing block");
+        open.push_back(block);
+    };
+    auto close_ifs = [&](std::uint32_t pc) {
+        while (!open.empty() && !open.back().loop && open.back().end == pc) {
+            open.pop_back();
+            line("}");
+        }
+    };
+
+    const auto size = static_cast<std::uint32_t>(program.code.size());
+    for (std::uint32_t pc = 0; pc < size; ++pc) {
+        close_ifs(pc);
+        const auto& in = program.code[pc];
+        switch (in.op) {
+            case Op::Text:
+                line("out.append(" + literal(program.str(in.a, in.b), indent() + "           ") + ", " + std::to_string(in.b) + ");");
+                line("f.written();");
+                break;
+            case Op::Echo:
+            case Op::EchoRaw: {
+                bool raw = in.op == Op::EchoRaw;
+                std::string source = raw ? "  // {!! " + comment(program, in.a) + " !!}" : "  // {{ " + comment(program, in.a) + " }}";
+                // Filters and anything but a plain path run in the interpreter
+                if (auto access = in.c == 0 ? path_access(program, in.a, open) : std::string(); !access.empty()) {
+                    line(std::string(raw ? "f.echo_value_raw(" : "f.echo_value(") + access + ", " + std::to_string(in.a) + ");" + source);
+                } else {
+                    line(std::string(raw ? "f.echo_raw(" : "f.echo(") + std::to_string(in.a) + ", " + std::to_string(in.b) + ", " +
+                         std::to_string(in.c) + ");" + source);
+                }
+                break;
+            }
+            case Op::JumpIfFalse:
+            case Op::JumpIfTrue: {
+                if (in.b <= pc || in.b > size) throw std::runtime_error("jump target out of range");
+                bool unless = in.op == Op::JumpIfTrue;
+                std::string source = std::string("  // @") + (unless ? "unless(" : "if(") + comment(program, in.a) + ")";
+                if (auto test = path_test(program, in.a, unless, open); !test.empty()) {
+                    line("if (" + test + ") {" + source);
+                } else {
+                    line(std::string("if (!f.") + (unless ? "skip_if(" : "skip_unless(") + std::to_string(in.a) + ")) {" + source);
+                }
+                enter({false, in.b});
+                break;
+            }
+            case Op::LoopBegin: {
+                if (in.b <= pc + 1 || in.b > size) throw std::runtime_error("loop end out of range");
+                const auto& item = program.segments.at(in.c);
+                auto name = program.str(item.str, item.len);
+                auto depth = loop_depth(open);
+                line("if (f.loop_begin(" + std::to_string(in.a) + ", " + std::to_string(in.c) + ")) do {  // @foreach(" +
+                     comment(program, in.a) + " as " + std::string(name) + ")");
+                enter({true, in.b - 1, false, name, depth});
+                line("[[maybe_unused]] const nlohmann::json* item" + std::to_string(depth) + " = f.item();");
+                break;
+            }
+            case Op::LoopEnd:
+                if (open.empty() || !open.back().loop || open.back().end != pc) throw std::runtime_error("unbalanced loop");
+                open.pop_back();
+                line("} while (f.loop_next());");
+                break;
+            case Op::CacheBegin: {
+                if (in.b <= pc + 1 || in.b > size) throw std::runtime_error("cache block end out of range");
+                std::string ttl = in.c == kNoExpr ? "breeze::support::blade::kNoExpr" : std::to_string(in.c);
+                std::string ttl_source = in.c == kNoExpr ? "" : ", " + comment(program, in.c);
+                line("if (!f.cache_begin(" + std::to_string(in.a) + ", " + ttl + ")) {  // @cache(" + comment(program, in.a) +
+                     ttl_source + ")");
+                enter({false, in.b, true});
+                break;
+            }
+            case Op::CacheEnd:
+                if (open.empty() || !open.back().cache || open.back().end != pc + 1) throw std::runtime_error("unbalanced @cache");
+                line("f.cache_end();");
+                break;
+            case Op::Jump:
+                throw std::runtime_error("unstructured jump");
+        }
+    }
+    close_ifs(size);
+    if (!open.empty()) throw std::runtime_error("unterminated block");
+
+    auto image = serialize(program);
+    std::string bytes;
+    for (std::size_t i = 0; i < image.size(); ++i) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "0x%02x,", static_cast<unsigned char>(image[i]));
+        bytes += i % 16 == 0 ? "\n    " : " ";
+        bytes += buf;
+    }
+
+    std::string out;
+    out += "// Generated by breeze_viewc";
+    if (!source_path.empty()) out += " from " + std::string(source_path);
+    out += "; do not edit.\n";
+    out += "#include <breeze/support/blade_program.hpp>\n\n";
+    out += "namespace {\n\n";
+    out += "using breeze::support::blade::Frame;\n\n";
+    out += "// The program tables (see blade::serialize); expression and filter operands index into them\n";
+    out += "alignas(8) constexpr unsigned char kProgram[] = {" + bytes + "\n};\n\n";
+    out += "void render([[maybe_unused]] Frame& f) {\n";
+    out += "    [[maybe_unused]] std::string& out = f.out();\n" + body + "}\n\n";
+    out += "[[maybe_unused]] const bool registered = breeze::support::blade::register_compiled(\n";
+    out += "    " + literal(name, "") + ", {reinterpret_cast<const char*>(kProgram), sizeof(kProgram)}, &render);\n\n";
+    out += "} // namespace\n";
+    return out;
+}
+
+} // namespace breeze::support::blade
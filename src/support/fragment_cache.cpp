@@ -0,0 +1,105 @@
+#include <breeze/support/fragment_cache.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace breeze::support {
+
+FragmentCache& FragmentCache::instance() {
+    static FragmentCache cache;
+    return cache;
+}
+
+FragmentCache::Shard& FragmentCache::shard_for(std::string_view key) {
+    return shards_[std::hash<std::string_view>{}(key) % kShards];
+}
+
+FragmentCache::Lookup FragmentCache::lookup(std::string_view key) {
+    auto& shard = shard_for(key);
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        // Nothing to serve yet: every caller renders, and the first store() wins until it expires
+        ++shard.misses;
+        return {nullptr, true};
+    }
+    auto& entry = *it->second;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    if (now < entry.expires) {
+        ++shard.hits;
+        return {entry.html, false};
+    }
+    if (entry.refreshing_since != Clock::time_point::min() && now - entry.refreshing_since < kRefreshTimeout) {
+        ++shard.stale_hits;
+        return {entry.html, false};
+    }
+    entry.refreshing_since = now;
+    ++shard.misses;
+    return {nullptr, true};
+}
+
+void FragmentCache::store(std::string_view key, std::string html, std::chrono::milliseconds ttl) {
+    auto& shard = shard_for(key);
+    auto expires = ttl.count() > 0 ? Clock::now() + ttl : Clock::time_point::max();
+    auto shared = std::make_shared<const std::string>(std::move(html));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        auto& entry = *it->second;
+        entry.html = std::move(shared);
+        entry.expires = expires;
+        entry.refreshing_since = Clock::time_point::min();
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+    shard.lru.push_front(Entry{std::string(key), std::move(shared), expires, Clock::time_point::min()});
+    shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+    while (shard.lru.size() > shard.capacity) {
+        shard.index.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+    }
+}
+
+void FragmentCache::release(std::string_view key) {
+    auto& shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) it->second->refreshing_since = Clock::time_point::min();
+}
+
+void FragmentCache::configure(std::size_t max_items) {
+    auto capacity = std::max<std::size_t>((max_items + kShards - 1) / kShards, 1);
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.capacity = capacity;
+        while (shard.lru.size() > shard.capacity) {
+            shard.index.erase(shard.lru.back().key);
+            shard.lru.pop_back();
+        }
+    }
+}
+
+void FragmentCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.hits = shard.stale_hits = shard.misses = 0;
+    }
+}
+
+nlohmann::json FragmentCache::stats() const {
+    std::uint64_t hits = 0, stale_hits = 0, misses = 0, entries = 0, max_items = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        hits += shard.hits;
+        stale_hits += shard.stale_hits;
+        misses += shard.misses;
+        entries += shard.lru.size();
+        max_items += shard.capacity;
+    }
+    return {{"hits", hits}, {"stale_hits", stale_hits}, {"misses", misses}, {"entries", entries}, {"max_items", max_items}};
+}
+
+} // namespace breeze::support
@@ -0,0 +1,293 @@
+#include <breeze/support/metrics.hpp>
+#include <breeze/support/access_log.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <functional>
+
+namespace breeze::support {
+
+namespace {
+
+// Stripe for the calling thread, assigned round-robin on first use
+std::size_t thread_shard(std::size_t shards) {
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t shard = next.fetch_add(1, std::memory_order_relaxed) % shards;
+    return shard;
+}
+
+// Bucket boundaries exposed to Prometheus, in seconds
+constexpr std::array<double, 15> kExportBounds = {
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30
+};
+
+void append_label_value(std::string& out, std::string_view value) {
+    for (char c : value) {
+        if (c == '\\' || c == '"') out.push_back('\\');
+        if (c == '\n') { out += "\\n"; continue; }
+        out.push_back(c);
+    }
+}
+
+// Methods outside the standard set share one label, so clients cannot mint series at will
+std::string_view method_label(std::string_view method) {
+    for (std::string_view known : {"GET", "HEAD", "POST", "PUT", "PATCH", "DELETE", "OPTIONS", "CONNECT", "TRACE"}) {
+        if (method == known) return known;
+    }
+    return "OTHER";
+}
+
+std::string format_double(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6g", v);
+    return buf;
+}
+
+} // namespace
+
+std::size_t LatencyBuckets::index_for(std::uint64_t us) {
+    if (us < sub_buckets) return static_cast<std::size_t>(us);
+    us = std::min<std::uint64_t>(us, UINT32_MAX);
+    auto exponent = static_cast<std::size_t>(std::bit_width(us) - 1); // floor(log2(us)) >= 4
+    auto sub = static_cast<std::size_t>((us >> (exponent - 4)) & (sub_buckets - 1));
+    return sub_buckets + (exponent - 4) * sub_buckets + sub;
+}
+
+std::uint64_t LatencyBuckets::upper_bound(std::size_t index) {
+    if (index < sub_buckets) return index + 1;
+    auto exponent = (index - sub_buckets) / sub_buckets + 4;
+    auto sub = (index - sub_buckets) % sub_buckets;
+    return static_cast<std::uint64_t>(sub_buckets + 1 + sub) << (exponent - 4);
+}
+
+std::uint64_t HistogramSnapshot::quantile_us(double q) const {
+    if (count == 0) return 0;
+    auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count));
+    if (rank >= count) rank = count - 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > rank) return LatencyBuckets::upper_bound(i);
+    }
+    return LatencyBuckets::upper_bound(buckets.size() - 1);
+}
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Metrics() {
+    std::lock_guard<std::mutex> lock(series_mutex_);
+    overflow_ = insert_series("*", "<overflow>", 0, series_hash("*", "<overflow>", 0));
+}
+
+std::size_t Metrics::series_hash(std::string_view method, std::string_view route, int status) {
+    auto h = std::hash<std::string_view>{}(route);
+    h ^= std::hash<std::string_view>{}(method) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= std::hash<int>{}(status) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+const Metrics::Series* Metrics::find_series(std::string_view method, std::string_view route, int status,
+                                            std::size_t hash) const {
+    for (std::size_t probe = 0; probe < kTableSize; ++probe) {
+        auto* series = table_[(hash + probe) & (kTableSize - 1)].load(std::memory_order_acquire);
+        if (!series) return nullptr;
+        if (series->hash == hash && series->status == status && series->route == route && series->method == method) {
+            return series;
+        }
+    }
+    return nullptr;
+}
+
+Metrics::Series* Metrics::insert_series(std::string_view method, std::string_view route, int status, std::size_t hash) {
+    for (std::size_t probe = 0; probe < kTableSize; ++probe) {
+        auto& slot = table_[(hash + probe) & (kTableSize - 1)];
+        if (slot.load(std::memory_order_relaxed)) continue;
+        auto series = std::make_unique<Series>();
+        series->method = method;
+        series->route = route;
+        series->status = status;
+        series->hash = hash;
+        slot.store(series.get(), std::memory_order_release);
+        series_.push_back(std::move(series));
+        return series_.back().get();
+    }
+    return nullptr;
+}
+
+Metrics::Series& Metrics::series_for(std::string_view method, std::string_view route, int status) {
+    auto hash = series_hash(method, route, status);
+    if (auto* found = find_series(method, route, status, hash)) return const_cast<Series&>(*found);
+
+    std::lock_guard<std::mutex> lock(series_mutex_);
+    // Another thread may have created it while we waited
+    if (auto* found = find_series(method, route, status, hash)) return const_cast<Series&>(*found);
+    // Full: fold into the overflow series rather than growing unbounded. Keeping the table at most
+    // half full also guarantees every probe sequence reaches an empty slot quickly.
+    if (series_.size() >= kMaxSeries) return *overflow_;
+    return *insert_series(method, route, status, hash);
+}
+
+void Metrics::observe_request(std::string_view method, std::string_view route, int status,
+                              std::chrono::microseconds duration, const AllocationCounts* allocations) {
+    auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+    auto& shard = series_for(method_label(method), route, status).shards[thread_shard(kShards)];
+    shard.buckets[LatencyBuckets::index_for(us)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum_us.fetch_add(us, std::memory_order_relaxed);
+    if (allocations) {
+        shard.allocations.fetch_add(allocations->allocations, std::memory_order_relaxed);
+        shard.allocated_bytes.fetch_add(allocations->bytes, std::memory_order_relaxed);
+    }
+}
+
+Metrics::BusyScope::BusyScope(Metrics& metrics) : metrics_(metrics), started_(std::chrono::steady_clock::now()) {
+    metrics_.busy_workers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+Metrics::BusyScope::~BusyScope() {
+    auto busy = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started_);
+    metrics_.busy_us_.fetch_add(static_cast<std::uint64_t>(busy.count()), std::memory_order_relaxed);
+    metrics_.busy_workers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+HistogramSnapshot Metrics::Series::merge() const {
+    HistogramSnapshot snap;
+    for (const auto& shard : shards) {
+        for (std::size_t i = 0; i < LatencyBuckets::count; ++i) {
+            snap.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.count += shard.count.load(std::memory_order_relaxed);
+        snap.sum_us += shard.sum_us.load(std::memory_order_relaxed);
+        snap.allocations += shard.allocations.load(std::memory_order_relaxed);
+        snap.allocated_bytes += shard.allocated_bytes.load(std::memory_order_relaxed);
+    }
+    return snap;
+}
+
+HistogramSnapshot Metrics::snapshot(std::string_view method, std::string_view route, int status) const {
+    if (auto* series = find_series(method, route, status, series_hash(method, route, status))) {
+        return series->merge();
+    }
+    return {};
+}
+
+std::string Metrics::prometheus() const {
+    std::vector<const Series*> all;
+    for (const auto& slot : table_) {
+        if (auto* series = slot.load(std::memory_order_acquire)) all.push_back(series);
+    }
+    std::sort(all.begin(), all.end(), [](const Series* a, const Series* b) {
+        if (a->route != b->route) return a->route < b->route;
+        if (a->method != b->method) return a->method < b->method;
+        return a->status < b->status;
+    });
+
+    std::string out;
+    out.reserve(1024 + all.size() * 1536);
+
+    auto labels = [](const Series& s) {
+        std::string l = "method=\"";
+        append_label_value(l, s.method);
+        l += "\",route=\"";
+        append_label_value(l, s.route);
+        l += "\",status=\"" + std::to_string(s.status) + "\"";
+        return l;
+    };
+
+    out += "# HELP breeze_http_request_duration_seconds Request latency by route and status.\n";
+    out += "# TYPE breeze_http_request_duration_seconds histogram\n";
+    std::vector<HistogramSnapshot> snapshots;
+    snapshots.reserve(all.size());
+    for (const auto* series : all) {
+        const auto& snap = snapshots.emplace_back(series->merge());
+        auto l = labels(*series);
+        std::size_t bucket = 0;
+        std::uint64_t cumulative = 0;
+        for (double bound : kExportBounds) {
+            auto bound_us = static_cast<std::uint64_t>(bound * 1e6);
+            // Fine buckets whose upper bound fits under this boundary
+            while (bucket < LatencyBuckets::count && LatencyBuckets::upper_bound(bucket) <= bound_us) {
+                cumulative += snap.buckets[bucket++];
+            }
+            out += "breeze_http_request_duration_seconds_bucket{" + l + ",le=\"" + format_double(bound) + "\"} " +
+                   std::to_string(cumulative) + "\n";
+        }
+        out += "breeze_http_request_duration_seconds_bucket{" + l + ",le=\"+Inf\"} " + std::to_string(snap.count) + "\n";
+        out += "breeze_http_request_duration_seconds_sum{" + l + "} " + format_double(static_cast<double>(snap.sum_us) / 1e6) + "\n";
+        out += "breeze_http_request_duration_seconds_count{" + l + "} " + std::to_string(snap.count) + "\n";
+    }
+
+    out += "# HELP breeze_http_request_duration_quantile_seconds Latency quantiles from the HDR histogram.\n";
+    out += "# TYPE breeze_http_request_duration_quantile_seconds gauge\n";
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        auto l = labels(*all[i]);
+        for (double q : {0.5, 0.9, 0.99, 0.999}) {
+            out += "breeze_http_request_duration_quantile_seconds{" + l + ",quantile=\"" + format_double(q) + "\"} " +
+                   format_double(static_cast<double>(snapshots[i].quantile_us(q)) / 1e6) + "\n";
+        }
+    }
+
+    if (allocations::available()) {
+        out += "# HELP breeze_http_request_allocations_total Heap allocations made while handling requests.\n";
+        out += "# TYPE breeze_http_request_allocations_total counter\n";
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            out += "breeze_http_request_allocations_total{" + labels(*all[i]) + "} " +
+                   std::to_string(snapshots[i].allocations) + "\n";
+        }
+        out += "# HELP breeze_http_request_allocated_bytes_total Heap bytes requested while handling requests.\n";
+        out += "# TYPE breeze_http_request_allocated_bytes_total counter\n";
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            out += "breeze_http_request_allocated_bytes_total{" + labels(*all[i]) + "} " +
+                   std::to_string(snapshots[i].allocated_bytes) + "\n";
+        }
+    }
+
+    auto uptime_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started_.load(std::memory_order_relaxed)).count();
+    auto metric = [&out](const char* name, const char* type, const char* help, const std::string& value) {
+        out += std::string("# HELP ") + name + " " + help + "\n";
+        out += std::string("# TYPE ") + name + " " + type + "\n";
+        out += std::string(name) + " " + value + "\n";
+    };
+    metric("breeze_http_bytes_received_total", "counter", "Raw request bytes read from clients.",
+           std::to_string(bytes_in_.load(std::memory_order_relaxed)));
+    metric("breeze_http_bytes_sent_total", "counter", "Serialized response bytes sent to clients.",
+           std::to_string(bytes_out_.load(std::memory_order_relaxed)));
+    metric("breeze_http_active_connections", "gauge", "Connections accepted and not yet answered.",
+           std::to_string(active_connections_.load(std::memory_order_relaxed)));
+    metric("breeze_workers_busy", "gauge", "Worker threads currently handling a request.",
+           std::to_string(busy_workers_.load(std::memory_order_relaxed)));
+    metric("breeze_worker_busy_seconds_total", "counter", "Total worker time spent handling requests.",
+           format_double(static_cast<double>(busy_us_.load(std::memory_order_relaxed)) / 1e6));
+    metric("breeze_worker_utilization", "gauge", "Average busy workers since start (busy seconds / uptime).",
+           format_double(uptime_us > 0 ? static_cast<double>(busy_us_.load(std::memory_order_relaxed)) / static_cast<double>(uptime_us) : 0.0));
+
+    auto& log = AccessLog::instance();
+    metric("breeze_access_log_written_total", "counter", "Access log records written.", std::to_string(log.written()));
+    metric("breeze_access_log_dropped_total", "counter", "Access log records dropped because a ring buffer was full.",
+           std::to_string(log.dropped()));
+    return out;
+}
+
+void Metrics::reset() {
+    std::lock_guard<std::mutex> lock(series_mutex_);
+    for (auto& series : series_) {
+        for (auto& shard : series->shards) {
+            for (auto& b : shard.buckets) b.store(0, std::memory_order_relaxed);
+            shard.count.store(0, std::memory_order_relaxed);
+            shard.sum_us.store(0, std::memory_order_relaxed);
+            shard.allocations.store(0, std::memory_order_relaxed);
+            shard.allocated_bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+    bytes_in_.store(0, std::memory_order_relaxed);
+    bytes_out_.store(0, std::memory_order_relaxed);
+    busy_us_.store(0, std::memory_order_relaxed);
+    started_.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
+}
+
+} // namespace breeze::support
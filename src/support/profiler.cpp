@@ -0,0 +1,185 @@
+#include <breeze/support/profiler.hpp>
+#include <breeze/http/router.hpp>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace breeze::support {
+
+namespace {
+
+// Signal handler <-> profiler handshake. The handler registers as a writer before checking
+// `armed`, so stop() can disarm and then wait for in-flight samples to finish.
+std::atomic<int> in_flight{0};
+
+// Frames added by the handler itself and the kernel's signal trampoline
+constexpr int kSkipFrames = 2;
+
+std::string symbolize(void* address) {
+    Dl_info info{};
+    if (dladdr(address, &info) && info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+    char buf[64];
+    if (info.dli_fname) {
+        const char* base = std::strrchr(info.dli_fname, '/');
+        std::snprintf(buf, sizeof(buf), "%s+0x%zx", base ? base + 1 : info.dli_fname,
+                      static_cast<std::size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)));
+    } else {
+        std::snprintf(buf, sizeof(buf), "0x%zx", reinterpret_cast<std::size_t>(address));
+    }
+    return buf;
+}
+
+} // namespace
+
+SamplingProfiler& SamplingProfiler::instance() {
+    static SamplingProfiler profiler;
+    return profiler;
+}
+
+void SamplingProfiler::on_signal(int) {
+    int saved_errno = errno;
+    in_flight.fetch_add(1, std::memory_order_seq_cst);
+    auto& self = instance();
+    if (self.armed_.load(std::memory_order_seq_cst)) {
+        auto index = self.next_.fetch_add(1, std::memory_order_relaxed);
+        if (index < self.samples_.size()) {
+            auto& sample = self.samples_[index];
+            sample.depth = static_cast<std::uint32_t>(backtrace(sample.frames, static_cast<int>(max_frames)));
+            const auto* route = breeze::http::Router::matched_pattern();
+            auto length = route ? std::min(route->size(), max_route) : 0;
+            if (length) std::memcpy(sample.route, route->data(), length);
+            sample.route_length = static_cast<std::uint32_t>(length);
+        }
+    }
+    in_flight.fetch_sub(1, std::memory_order_seq_cst);
+    errno = saved_errno;
+}
+
+bool SamplingProfiler::start(int hz) {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) return false;
+
+    hz_ = std::clamp(hz, 1, 1000);
+    samples_.assign(max_samples, Sample{});
+    next_.store(0, std::memory_order_relaxed);
+
+    // backtrace() loads libgcc lazily on first use, which is not safe inside a signal handler
+    void* warm[1];
+    backtrace(warm, 1);
+
+    // The handler stays installed after stop(): a SIGPROF still pending when the timer is
+    // cleared must not hit the default action, which terminates the process
+    static bool installed = [] {
+        struct sigaction action {};
+        action.sa_handler = &SamplingProfiler::on_signal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        return sigaction(SIGPROF, &action, nullptr) == 0;
+    }();
+    if (!installed) {
+        running_.store(false);
+        return false;
+    }
+
+    armed_.store(true, std::memory_order_seq_cst);
+    started_ = std::chrono::steady_clock::now();
+    itimerval timer{};
+    // tv_usec must stay below one second, so a 1 Hz period goes in tv_sec
+    auto period_us = 1000000 / hz_;
+    timer.it_interval.tv_sec = period_us / 1000000;
+    timer.it_interval.tv_usec = period_us % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        armed_.store(false);
+        running_.store(false);
+        return false;
+    }
+    return true;
+}
+
+Profile SamplingProfiler::stop() {
+    Profile profile;
+    if (!running_.load()) return profile;
+
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    armed_.store(false, std::memory_order_seq_cst);
+    while (in_flight.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+
+    auto taken = next_.load(std::memory_order_relaxed);
+    auto kept = std::min(taken, samples_.size());
+    profile.samples = kept;
+    profile.dropped = taken - kept;
+    profile.hz = hz_;
+    profile.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_);
+    profile.collapsed = aggregate(kept);
+
+    samples_.clear();
+    samples_.shrink_to_fit();
+    running_.store(false);
+    return profile;
+}
+
+Profile SamplingProfiler::collect(std::chrono::milliseconds duration, int hz) {
+    if (!start(hz)) throw std::runtime_error("a profile is already being collected");
+    std::this_thread::sleep_for(duration);
+    return stop();
+}
+
+std::string SamplingProfiler::aggregate(std::size_t count) const {
+    std::unordered_map<void*, std::string> names;
+    auto name_of = [&names](void* address) -> const std::string& {
+        auto it = names.find(address);
+        if (it == names.end()) {
+            auto name = symbolize(address);
+            std::replace(name.begin(), name.end(), ';', ':');  // ';' separates frames
+            it = names.emplace(address, std::move(name)).first;
+        }
+        return it->second;
+    };
+
+    std::map<std::string, std::uint64_t> stacks;
+    std::string key;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& sample = samples_[i];
+        key.assign(sample.route_length ? std::string(sample.route, sample.route_length) : std::string("<unmatched>"));
+        // backtrace() lists innermost first; collapsed stacks go root to leaf
+        for (auto f = static_cast<int>(sample.depth) - 1; f >= kSkipFrames; --f) {
+            key += ';';
+            key += name_of(sample.frames[f]);
+        }
+        ++stacks[key];
+    }
+
+    std::vector<std::pair<std::string, std::uint64_t>> sorted(stacks.begin(), stacks.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::string out;
+    for (const auto& [stack, n] : sorted) {
+        out += stack;
+        out += ' ';
+        out += std::to_string(n);
+        out += '\n';
+    }
+    return out;
+}
+
+} // namespace breeze::support
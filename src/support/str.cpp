@@ -2,9 +2,137 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define BREEZE_STR_SSE2 1
+#endif
+// The AVX2 path falls back to the SSE2 one for its tail, so it needs SSE2 at compile time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(BREEZE_STR_SSE2)
+#include <immintrin.h>
+#define BREEZE_STR_AVX2 1
+#endif
 
 namespace breeze::support::str {
 
+namespace {
+
+constexpr bool is_html_special(unsigned char c)
+{
+    return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+}
+
+const char* find_special_scalar(const char* p, const char* end)
+{
+    while (p < end && !is_html_special(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+    return p;
+}
+
+#ifdef BREEZE_STR_SSE2
+const char* find_special_sse2(const char* p, const char* end)
+{
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i apos = _mm_set1_epi8('\'');
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, lt)),
+                                   _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, gt), _mm_cmpeq_epi8(v, quot)),
+                                                _mm_cmpeq_epi8(v, apos)));
+        if (int mask = _mm_movemask_epi8(hit)) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+    return find_special_scalar(p, end);
+}
+#endif
+
+#ifdef BREEZE_STR_AVX2
+__attribute__((target("avx2"))) const char* find_special_avx2(const char* p, const char* end)
+{
+    const __m256i amp = _mm256_set1_epi8('&');
+    const __m256i lt = _mm256_set1_epi8('<');
+    const __m256i gt = _mm256_set1_epi8('>');
+    const __m256i quot = _mm256_set1_epi8('"');
+    const __m256i apos = _mm256_set1_epi8('\'');
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, amp), _mm256_cmpeq_epi8(v, lt)),
+                                      _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, gt), _mm256_cmpeq_epi8(v, quot)),
+                                                      _mm256_cmpeq_epi8(v, apos)));
+        if (auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hit))) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_special_sse2(p, end);
+}
+#endif
+
+using FindSpecial = const char* (*)(const char*, const char*);
+
+// Chosen once: AVX2 needs a CPU check, SSE2 is part of x86-64
+FindSpecial select_find_special()
+{
+#ifdef BREEZE_STR_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return find_special_avx2;
+    }
+#endif
+#ifdef BREEZE_STR_SSE2
+    return find_special_sse2;
+#else
+    return find_special_scalar;
+#endif
+}
+
+// Function-local so it is ready for callers in other static initializers
+const char* find_special(const char* p, const char* end)
+{
+    static const FindSpecial impl = select_find_special();
+    return impl(p, end);
+}
+
+std::string_view entity(char c)
+{
+    switch (c) {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '"': return "&quot;";
+        default: return "&#39;";
+    }
+}
+
+// Flip the case bit of every byte in [first, first + 26): 'a'..'z' for upper, 'A'..'Z' for lower
+void flip_ascii_range(std::string& s, char first)
+{
+    char* p = s.data();
+    char* end = p + s.size();
+#ifdef BREEZE_STR_SSE2
+    // Shift the range down to -128..-103 so one signed compare finds it
+    const __m128i shift = _mm_set1_epi8(static_cast<char>(0x80 - first));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+    const __m128i bit = _mm_set1_epi8(0x20);
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i in_range = _mm_cmplt_epi8(_mm_add_epi8(v, shift), limit);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_xor_si128(v, _mm_and_si128(in_range, bit)));
+    }
+#endif
+    for (; p < end; ++p) {
+        if (static_cast<unsigned char>(*p - first) < 26) {
+            *p = static_cast<char>(*p ^ 0x20);
+        }
+    }
+}
+
+} // namespace
+
 std::string trim(std::string_view s)
 {
     std::size_t start = 0;
@@ -50,4 +178,50 @@ std::string replace_all(std::string_view s, std::string_view from, std::string_v
     return out;
 }
 
+std::size_t find_html_special(std::string_view s)
+{
+    const char* end = s.data() + s.size();
+    const char* hit = find_special(s.data(), end);
+    return hit == end ? std::string_view::npos : static_cast<std::size_t>(hit - s.data());
+}
+
+void append_html_escaped(std::string& out, std::string_view s)
+{
+    const char* p = s.data();
+    const char* end = p + s.size();
+    while (p < end) {
+        const char* hit = find_special(p, end);
+        out.append(p, hit);
+        if (hit == end) {
+            break;
+        }
+        out += entity(*hit);
+        p = hit + 1;
+    }
+}
+
+void ascii_upper(std::string& s)
+{
+    flip_ascii_range(s, 'a');
+}
+
+void ascii_lower(std::string& s)
+{
+    flip_ascii_range(s, 'A');
+}
+
+void trim_in_place(std::string& s)
+{
+    std::size_t end = s.size();
+    while (end > 0 && std::isspace(static_cast<unsigned char>(s[end - 1]))) {
+        --end;
+    }
+    s.erase(end);
+    std::size_t start = 0;
+    while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) {
+        ++start;
+    }
+    s.erase(0, start);
+}
+
 } // namespace breeze::support::str
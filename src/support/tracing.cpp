@@ -0,0 +1,187 @@
+#include <breeze/support/tracing.hpp>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace breeze::support {
+
+namespace {
+
+// splitmix64 over one process-wide counter, seeded once: connection threads are short-lived,
+// so a per-thread generator would pay for seeding on nearly every request
+std::uint64_t next_random() {
+    static std::atomic<std::uint64_t> state{std::random_device{}() ^
+                                            static_cast<std::uint64_t>(Trace::clock::now().time_since_epoch().count())};
+    std::uint64_t z = state.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+template <std::size_t N>
+void random_hex(std::array<char, N>& out) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (i % 16 == 0) bits = next_random();
+        out[i] = digits[bits & 0xf];
+        bits >>= 4;
+    }
+}
+
+// NUL-terminated copy, truncated to fit
+template <std::size_t N>
+void copy_truncated(char (&out)[N], std::string_view s) {
+    auto n = std::min(s.size(), N - 1);
+    std::memcpy(out, s.data(), n);
+    out[n] = '\0';
+}
+
+bool is_lower_hex(std::string_view s) {
+    return std::all_of(s.begin(), s.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+bool all_zero(std::string_view s) {
+    return std::all_of(s.begin(), s.end(), [](char c) { return c == '0'; });
+}
+
+void append_json_string(std::string& out, std::string_view s) {
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+    out += '"';
+}
+
+std::string format_ms(std::uint64_t us) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(us) / 1000.0);
+    return buf;
+}
+
+} // namespace
+
+Trace::Trace() : started_(clock::now()) {
+    random_hex(trace_id_);
+    random_hex(span_id_);
+}
+
+bool Trace::adopt_parent(std::string_view header) {
+    // version "-" trace-id "-" parent-id "-" flags, e.g. 00-4bf9...4736-00f0...02b7-01
+    if (header.size() < 55 || header[2] != '-' || header[35] != '-' || header[52] != '-') return false;
+    auto version = header.substr(0, 2);
+    auto trace_id = header.substr(3, 32);
+    auto parent_id = header.substr(36, 16);
+    auto flags = header.substr(53, 2);
+    if (!is_lower_hex(version) || version == "ff" || !is_lower_hex(trace_id) || !is_lower_hex(parent_id) ||
+        !is_lower_hex(flags) || all_zero(trace_id) || all_zero(parent_id)) {
+        return false;
+    }
+    // Version 00 is exactly 55 chars; later versions may append fields
+    if (version == "00" && header.size() != 55) return false;
+
+    std::copy(trace_id.begin(), trace_id.end(), trace_id_.begin());
+    std::copy(parent_id.begin(), parent_id.end(), parent_id_.begin());
+    has_parent_ = true;
+    sampled_ = (std::stoi(std::string(flags), nullptr, 16) & 0x01) != 0;
+    return true;
+}
+
+std::string Trace::traceparent() const {
+    std::string out = "00-";
+    out.append(trace_id()).append("-").append(span_id()).append(sampled_ ? "-01" : "-00");
+    return out;
+}
+
+void Trace::describe(std::string_view method, std::string_view path, int status) {
+    copy_truncated(method_, method);
+    copy_truncated(path_, path);
+    status_ = status;
+}
+
+std::string Trace::server_timing() const {
+    // Keep first-seen order; repeated spans (e.g. container) are summed
+    struct Entry { const char* name; std::uint64_t us; unsigned calls; };
+    std::vector<Entry> entries;
+    for (std::size_t i = 0; i < count_; ++i) {
+        const auto& rec = spans_[i];
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&rec](const Entry& e) { return std::strcmp(e.name, rec.name) == 0; });
+        if (it == entries.end()) entries.push_back({rec.name, rec.duration_us, 1});
+        else { it->us += rec.duration_us; ++it->calls; }
+    }
+
+    std::string out;
+    for (const auto& e : entries) {
+        if (!out.empty()) out += ", ";
+        out += e.name;
+        out += ";dur=" + format_ms(e.us);
+        if (e.calls > 1) out += ";desc=\"x" + std::to_string(e.calls) + "\"";
+    }
+    if (!out.empty()) out += ", ";
+    out += "total;dur=" + format_ms(static_cast<std::uint64_t>(elapsed().count()));
+    out += ", traceparent;desc=\"" + traceparent() + "\"";
+    return out;
+}
+
+std::string Trace::to_json() const {
+    std::string out = "{\"trace_id\":\"";
+    out.append(trace_id()).append("\",\"span_id\":\"").append(span_id()).append("\"");
+    if (has_parent_) out.append(",\"parent_id\":\"").append(parent_id()).append("\"");
+    out += ",\"method\":";
+    append_json_string(out, method_);
+    out += ",\"path\":";
+    append_json_string(out, path_);
+    out += ",\"status\":" + std::to_string(status_);
+    out += ",\"duration_us\":" + std::to_string(elapsed().count());
+    out += ",\"dropped_spans\":" + std::to_string(dropped_);
+    out += ",\"spans\":[";
+    for (std::size_t i = 0; i < count_; ++i) {
+        const auto& rec = spans_[i];
+        if (i) out += ',';
+        out += "{\"name\":";
+        append_json_string(out, rec.name);
+        if (rec.detail[0]) {
+            out += ",\"detail\":";
+            append_json_string(out, rec.detail);
+        }
+        out += ",\"start_us\":" + std::to_string(rec.start_us) + ",\"duration_us\":" + std::to_string(rec.duration_us) +
+               ",\"depth\":" + std::to_string(rec.depth) + "}";
+    }
+    out += "]}\n";
+    return out;
+}
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::configure(TraceOptions options) {
+    enabled_.store(options.enabled, std::memory_order_relaxed);
+    server_timing_.store(options.server_timing, std::memory_order_relaxed);
+    slow_threshold_us_.store(options.slow_threshold.count(), std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(export_mutex_);
+    export_path_ = std::move(options.export_path);
+}
+
+bool Tracer::finish(const Trace& trace) {
+    if (trace.elapsed().count() < slow_threshold_us_.load(std::memory_order_relaxed)) return false;
+
+    auto line = trace.to_json();
+    // Slow traces are rare by definition, so a synchronous append is acceptable here
+    std::lock_guard<std::mutex> lock(export_mutex_);
+    std::error_code ec;
+    if (export_path_.has_parent_path()) std::filesystem::create_directories(export_path_.parent_path(), ec);
+    std::FILE* file = std::fopen(export_path_.c_str(), "ab");
+    if (!file) return false;
+    std::fwrite(line.data(), 1, line.size(), file);
+    std::fclose(file);
+    exported_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace breeze::support
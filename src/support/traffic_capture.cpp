@@ -0,0 +1,261 @@
+#include <breeze/support/traffic_capture.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace breeze::support {
+
+namespace {
+
+constexpr char kMagic[6] = {'B', 'R', 'Z', 'C', 'A', 'P'};
+
+template<typename T>
+void put_int(std::string& out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff));
+    }
+}
+
+template<typename Len>
+void put_string(std::string& out, const std::string& value) {
+    auto n = std::min<std::size_t>(value.size(), static_cast<Len>(~Len{0}));
+    put_int<Len>(out, static_cast<Len>(n));
+    out.append(value.data(), n);
+}
+
+class Cursor {
+public:
+    explicit Cursor(const std::string& data) : data_(data) {}
+
+    template<typename T>
+    T get_int() {
+        need(sizeof(T));
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += sizeof(T);
+        return static_cast<T>(value);
+    }
+
+    template<typename Len>
+    std::string get_string() {
+        auto n = get_int<Len>();
+        need(n);
+        std::string value = data_.substr(pos_, n);
+        pos_ += n;
+        return value;
+    }
+
+private:
+    void need(std::size_t n) const {
+        if (pos_ + n > data_.size()) throw std::runtime_error("truncated capture record");
+    }
+
+    const std::string& data_;
+    std::size_t pos_ = 0;
+};
+
+} // namespace
+
+std::string CapturedRequest::to_http(const std::string& host) const {
+    std::string raw = method + " " + path;
+    if (!query.empty()) raw += "?" + query;
+    raw += " HTTP/1.1\r\n";
+    bool has_host = false;
+    for (const auto& [name, value] : headers) {
+        if (name == "content-length" || name == "connection") continue; // recomputed below
+        if (name == "host") has_host = true;
+        raw += name + ": " + value + "\r\n";
+    }
+    if (!has_host) raw += "host: " + host + "\r\n";
+    if (!body.empty()) raw += "content-length: " + std::to_string(body.size()) + "\r\n";
+    raw += "connection: close\r\n\r\n";
+    raw += body;
+    return raw;
+}
+
+TrafficCapture& TrafficCapture::instance() {
+    static TrafficCapture capture;
+    return capture;
+}
+
+TrafficCapture::~TrafficCapture() {
+    close();
+}
+
+void TrafficCapture::configure(TrafficCaptureOptions options) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = std::move(options);
+    if (options_.sample_every == 0) options_.sample_every = 1;
+    sample_every_.store(options_.sample_every, std::memory_order_relaxed);
+    counter_.store(0, std::memory_order_relaxed);
+    captured_.store(0, std::memory_order_relaxed);
+    origin_ = std::chrono::steady_clock::now();
+    if (!options_.enabled) return;
+
+    std::error_code ec;
+    if (options_.file.has_parent_path()) std::filesystem::create_directories(options_.file.parent_path(), ec);
+    file_ = std::fopen(options_.file.c_str(), "wb");
+    if (!file_) return;
+    std::string header(kMagic, sizeof(kMagic));
+    put_int<std::uint16_t>(header, version);
+    std::fwrite(header.data(), 1, header.size(), file_);
+    bytes_written_ = header.size();
+    pending_.clear();
+    stopping_ = false;
+    writer_ = std::thread([this] { writer_loop(); });
+    enabled_.store(true, std::memory_order_release);
+}
+
+void TrafficCapture::close() {
+    enabled_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    // The writer drains pending_ before it exits
+    if (writer_.joinable()) writer_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void TrafficCapture::writer_loop() {
+    std::string batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait_for(lock, kFlushInterval, [this] { return stopping_ || pending_.size() >= kFlushBytes; });
+        batch.clear();
+        batch.swap(pending_);
+        bool stop = stopping_;
+        lock.unlock();
+        if (!batch.empty()) {
+            std::fwrite(batch.data(), 1, batch.size(), file_);
+            std::fflush(file_);
+        }
+        if (stop) return;
+        lock.lock();
+    }
+}
+
+bool TrafficCapture::should_sample() noexcept {
+    if (!enabled_.load(std::memory_order_acquire)) return false;
+    auto every = sample_every_.load(std::memory_order_relaxed);
+    return every <= 1 || counter_.fetch_add(1, std::memory_order_relaxed) % every == 0;
+}
+
+void TrafficCapture::record(const breeze::http::Request& request, int status, std::chrono::microseconds duration,
+                            std::chrono::steady_clock::time_point arrived) {
+    // Sampled traffic is low volume, so one lock covers encoding and the buffer append; disk
+    // writes happen on the writer thread
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_ || stopping_) return;
+
+    std::string payload;
+    payload.reserve(64 + request.path().size() + request.body().size() + request.headers().size() * 48);
+    auto offset = std::chrono::duration_cast<std::chrono::microseconds>(arrived - origin_).count();
+    put_int<std::uint64_t>(payload, static_cast<std::uint64_t>(std::max<std::int64_t>(offset, 0)));
+    put_int<std::uint32_t>(payload, static_cast<std::uint32_t>(std::clamp<std::int64_t>(duration.count(), 0, UINT32_MAX)));
+    put_int<std::uint16_t>(payload, static_cast<std::uint16_t>(status));
+    put_string<std::uint32_t>(payload, request.method());
+    put_string<std::uint32_t>(payload, request.path());
+    put_string<std::uint32_t>(payload, request.query_string());
+    put_string<std::uint32_t>(payload, request.body());
+
+    std::vector<std::pair<const std::string*, const std::string*>> headers;
+    for (const auto& [name, value] : request.headers()) {
+        if (name == "x-remote-addr") continue; // injected by the server, not sent by the client
+        headers.emplace_back(&name, &value);
+    }
+    if (headers.size() > UINT16_MAX) headers.resize(UINT16_MAX);
+    put_int<std::uint16_t>(payload, static_cast<std::uint16_t>(headers.size()));
+    static const std::string redacted = "[redacted]";
+    for (const auto& [name, value] : headers) {
+        bool redact = std::find(options_.redact_headers.begin(), options_.redact_headers.end(), *name) !=
+                      options_.redact_headers.end();
+        put_string<std::uint16_t>(payload, *name);
+        put_string<std::uint16_t>(payload, redact ? redacted : *value);
+    }
+
+    std::string framed;
+    framed.reserve(payload.size() + 4);
+    put_int<std::uint32_t>(framed, static_cast<std::uint32_t>(payload.size()));
+    framed += payload;
+
+    if (options_.max_bytes > 0 && bytes_written_ + framed.size() > options_.max_bytes) {
+        // Full: keep what we have rather than rotating away the start of the load shape
+        enabled_.store(false, std::memory_order_release);
+        return;
+    }
+    pending_ += framed;
+    bytes_written_ += framed.size();
+    captured_.fetch_add(1, std::memory_order_relaxed);
+    if (pending_.size() >= kFlushBytes) wake_.notify_one();
+}
+
+TrafficReader::TrafficReader(const std::filesystem::path& file) {
+    file_ = std::fopen(file.c_str(), "rb");
+    if (!file_) throw std::runtime_error("cannot open capture file " + file.string());
+    char header[8];
+    if (std::fread(header, 1, sizeof(header), file_) != sizeof(header) || std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+        std::fclose(file_);
+        file_ = nullptr;
+        throw std::runtime_error(file.string() + " is not a breeze capture file");
+    }
+    auto file_version = static_cast<std::uint16_t>(static_cast<unsigned char>(header[6]) |
+                                                   (static_cast<unsigned char>(header[7]) << 8));
+    if (file_version != TrafficCapture::version) {
+        std::fclose(file_);
+        file_ = nullptr;
+        throw std::runtime_error("unsupported capture version " + std::to_string(file_version));
+    }
+}
+
+TrafficReader::~TrafficReader() {
+    if (file_) std::fclose(file_);
+}
+
+bool TrafficReader::next(CapturedRequest& out) {
+    unsigned char size_bytes[4];
+    auto got = std::fread(size_bytes, 1, sizeof(size_bytes), file_);
+    if (got == 0) return false;
+    if (got != sizeof(size_bytes)) throw std::runtime_error("truncated capture record");
+    std::uint32_t size = size_bytes[0] | (size_bytes[1] << 8) | (size_bytes[2] << 16) |
+                         (static_cast<std::uint32_t>(size_bytes[3]) << 24);
+    buffer_.resize(size);
+    if (std::fread(buffer_.data(), 1, size, file_) != size) throw std::runtime_error("truncated capture record");
+
+    Cursor cursor(buffer_);
+    out.offset_us = cursor.get_int<std::uint64_t>();
+    out.duration_us = cursor.get_int<std::uint32_t>();
+    out.status = cursor.get_int<std::uint16_t>();
+    out.method = cursor.get_string<std::uint32_t>();
+    out.path = cursor.get_string<std::uint32_t>();
+    out.query = cursor.get_string<std::uint32_t>();
+    out.body = cursor.get_string<std::uint32_t>();
+    auto header_count = cursor.get_int<std::uint16_t>();
+    out.headers.clear();
+    out.headers.reserve(header_count);
+    for (std::uint16_t i = 0; i < header_count; ++i) {
+        auto name = cursor.get_string<std::uint16_t>();
+        auto value = cursor.get_string<std::uint16_t>();
+        out.headers.emplace_back(std::move(name), std::move(value));
+    }
+    return true;
+}
+
+std::vector<CapturedRequest> TrafficReader::read_all(const std::filesystem::path& file) {
+    TrafficReader reader(file);
+    std::vector<CapturedRequest> records;
+    CapturedRequest record;
+    while (reader.next(record)) records.push_back(record);
+    return records;
+}
+
+} // namespace breeze::support
@@ -1,31 +1,79 @@
 #include <breeze/support/view.hpp>
 #include <breeze/support/blade.hpp>
+#include <breeze/support/blade_program.hpp>
+#include <breeze/support/tracing.hpp>
 
 namespace breeze::support {
 
 View::View(std::filesystem::path views_path) : views_path_(std::move(views_path)) {}
 
-std::string View::render(const std::string& template_name, const nlohmann::json& data) {
+const std::vector<std::string>& View::extensions() {
     // Prefer the .breeze extension; fallback to other common template extensions.
-    const std::vector<std::string> exts = {".breeze", ".page", ".html", ".htm", ".chtm"};
+    static const std::vector<std::string> exts = {".breeze", ".page", ".html", ".htm", ".chtm"};
+    return exts;
+}
 
-    std::filesystem::path full_path;
-    bool found = false;
-    for (const auto& ext : exts) {
+std::optional<std::filesystem::path> View::resolve(const std::string& template_name) const {
+    // Immutable views cannot appear, move or change extension, so the lookup is done once
+    bool immutable = Blade::immutable();
+    if (immutable) {
+        std::lock_guard<std::mutex> lock(resolved_mutex_);
+        if (auto it = resolved_.find(template_name); it != resolved_.end()) return it->second;
+    }
+    for (const auto& ext : extensions()) {
         std::filesystem::path p = views_path_ / (template_name + ext);
         if (std::filesystem::exists(p)) {
-            full_path = std::move(p);
-            found = true;
-            break;
+            if (immutable) {
+                std::lock_guard<std::mutex> lock(resolved_mutex_);
+                resolved_.emplace(template_name, p);
+            }
+            return p;
         }
     }
+    return std::nullopt;
+}
+
+std::string View::not_found(const std::string& template_name) const {
+    return "View [" + template_name + "] not found in " + views_path_.string();
+}
+
+std::string View::render(const std::string& template_name, const nlohmann::json& data) {
+    std::string out;
+    render_to(out, template_name, data);
+    return out;
+}
 
-    if (!found) {
-        return "View [" + template_name + "] not found in " + views_path_.string();
+void View::render_to(std::string& out, const std::string& template_name, const nlohmann::json& data) {
+    if (const auto* compiled = blade::find_compiled(template_name)) {
+        Span span("view", template_name);
+        blade::execute(*compiled, data, out);
+        return;
     }
+    auto path = resolve(template_name);
+    if (!path) {
+        out += not_found(template_name);
+        return;
+    }
+    Blade blade;
+    blade.render_from_file_to(out, *path, data);
+}
 
+void View::stream(const std::string& template_name, const nlohmann::json& data, const Blade::ChunkSink& sink,
+                  std::size_t chunk_size) {
+    if (const auto* compiled = blade::find_compiled(template_name)) {
+        Span span("view", template_name);
+        std::string buffer;
+        buffer.reserve(chunk_size + 256);
+        blade::execute(*compiled, data, buffer, sink, chunk_size);
+        return;
+    }
+    auto path = resolve(template_name);
+    if (!path) {
+        sink(not_found(template_name));
+        return;
+    }
     Blade blade;
-    return blade.render_from_file(full_path, data);
+    blade.stream_from_file(*path, data, sink, chunk_size);
 }
 
 } // namespace breeze::support
@@ -1,6 +1,123 @@
 #include <breeze/breeze.hpp>
+#include <breeze/commands/bench_command.hpp>
+#include <breeze/commands/replay_command.hpp>
+#include <breeze/testing/test_client.hpp>
+#include <breeze/support/view.hpp>
+#include <breeze/support/fragment_cache.hpp>
+#include <breeze/support/str.hpp>
+#include <breeze/support/allocation_hooks.hpp>
+#include <app/Http/Middleware/AdminOnly.hpp>
+#include <app/Http/Middleware/CaptureTraffic.hpp>
+#include <app/Providers/ViewServiceProvider.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+void register_admin_routes(breeze::core::Application& app);
+
+struct CountingController : breeze::http::Controller {
+    static inline int constructed = 0;
+    static inline int resets = 0;
+    CountingController() { ++constructed; }
+    void reset() { ++resets; }
+    breeze::http::Response index(const breeze::http::Request&) { return breeze::http::Response::ok("counted"); }
+};
+
+struct StickyController : breeze::http::Controller {
+    static inline int constructed = 0;
+    static inline int resets = 0;
+    int served = 0;
+    StickyController() { ++constructed; }
+    void reset() { ++resets; }
+    breeze::http::Response index(const breeze::http::Request&) { return breeze::http::Response::ok(std::to_string(++served)); }
+};
+
+struct UnitOfWork {
+    static inline int destroyed = 0;
+    ~UnitOfWork() { ++destroyed; }
+};
+
+struct ReportService {};
+struct ReportFormatter {};
+
+struct ReportServiceProvider : breeze::core::DeferrableProvider {
+    using breeze::core::DeferrableProvider::DeferrableProvider;
+    static inline int registrations = 0;
+    static inline std::shared_ptr<ReportFormatter> booted_formatter;
+    std::vector<size_t> provides() const override { return provides_types<ReportService, ReportFormatter>(); }
+    void register_services() override {
+        ++registrations;
+        app_.container().singleton<ReportService>([] { return std::make_shared<ReportService>(); });
+        app_.container().singleton<ReportFormatter>([] { return std::make_shared<ReportFormatter>(); });
+    }
+    // Resolves another type this provider supplies while its own loader is still running
+    void boot() override { booted_formatter = app_.container().make<ReportFormatter>(); }
+};
+
+struct PairLeft {};
+struct PairRight {};
+
+struct PairServiceProvider : breeze::core::DeferrableProvider {
+    using breeze::core::DeferrableProvider::DeferrableProvider;
+    static inline std::atomic<int> registrations{0};
+    std::vector<size_t> provides() const override { return provides_types<PairLeft, PairRight>(); }
+    void register_services() override {
+        ++registrations;
+        app_.container().singleton<PairLeft>([] { return std::make_shared<PairLeft>(); });
+        app_.container().singleton<PairRight>([] { return std::make_shared<PairRight>(); });
+    }
+    // Gives a second thread time to start resolving PairRight while PairLeft's load is running
+    void boot() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        (void)app_.container().make<PairRight>();
+    }
+};
+
+struct LeakyService {};
+struct UndeclaredService {};
+
+// Registers a type it does not list in provides(), which a frozen container would never reach
+struct LeakyServiceProvider : breeze::core::DeferrableProvider {
+    using breeze::core::DeferrableProvider::DeferrableProvider;
+    std::vector<size_t> provides() const override { return provides_types<LeakyService>(); }
+    void register_services() override {
+        app_.container().singleton<LeakyService>([] { return std::make_shared<LeakyService>(); });
+        app_.container().singleton<UndeclaredService>([] { return std::make_shared<UndeclaredService>(); });
+    }
+};
+
+// Providers that opt into parallel boot run on worker threads; the rest boot in order
+struct BootOrder {
+    static inline std::thread::id independent;
+    static inline std::thread::id ordered;
+};
+
+struct IndependentProvider : breeze::core::ServiceProvider {
+    using breeze::core::ServiceProvider::ServiceProvider;
+    void register_services() override {}
+    void boot() override { BootOrder::independent = std::this_thread::get_id(); }
+    bool boots_independently() const override { return true; }
+};
+
+struct OrderedProvider : breeze::core::ServiceProvider {
+    using breeze::core::ServiceProvider::ServiceProvider;
+    void register_services() override {}
+    void boot() override { BootOrder::ordered = std::this_thread::get_id(); }
+};
+
+struct SharedController : breeze::http::Controller {
+    static inline int constructed = 0;
+    SharedController() { ++constructed; }
+    breeze::http::Response index(const breeze::http::Request&) { return breeze::http::Response::ok("shared"); }
+};
 
 int main()
 {
@@ -18,7 +135,812 @@ int main()
     req.set_path("/ping");
 
     const auto res = app.handle(req);
-    assert(res.status() == 200);
+    assert(static_cast<int>(res.status()) == 200);
     assert(res.body() == "pong");
+
+    // Named route URL generation
+    auto& router = app.kernel().router();
+    router.get("/users/{id}/posts/{post}", [](const breeze::http::Request&) {
+        return breeze::http::Response::ok();
+    }).name("users.posts");
+
+    assert(router.route("users.posts", {{"id", "7"}, {"post", "3"}}) == "/users/7/posts/3");
+    assert(router.route("users.posts", {{"id", "7"}}) == "/users/7/posts");
+    assert(router.route("missing").empty());
+    assert(router.missing_route_params("users.posts", {{"id", "7"}}) == std::vector<std::string>{"post"});
+
+    bool threw = false;
+    try {
+        (void)router.route_or_fail("users.posts", {{"id", "7"}});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Routes named after the first lookup are indexed straight away, and a rename moves the entry
+    router.get("/late/{slug}", [](const breeze::http::Request&) {
+        return breeze::http::Response::ok();
+    }).name("late.draft").name("late.show");
+    assert(router.route("late.show", {{"slug", "x"}}) == "/late/x");
+    assert(!router.has_route("late.draft"));
+    // Renaming one of two routes that share a name leaves the other one reachable by it
+    auto& shared_first = router.get("/shared/a", [](const breeze::http::Request&) {
+        return breeze::http::Response::ok();
+    }).name("shared");
+    router.get("/shared/b", [](const breeze::http::Request&) {
+        return breeze::http::Response::ok();
+    }).name("shared");
+    assert(router.route("shared") == "/shared/a");
+    shared_first.name("shared.a");
+    assert(router.route("shared") == "/shared/b");
+    assert(router.route("shared.a") == "/shared/a");
+    breeze::core::Application::instance().kernel().router().get("/home", [](const breeze::http::Request&) {
+        return breeze::http::Response::ok();
+    }).name("global.home");
+    assert(breeze::route("global.home") == "/home");
+
+    // Controller lifetimes: singleton resolves once, pooled instances are recycled
+    app.finalize_routing();
+    router.controller_lifetime<SharedController>(breeze::http::ControllerLifetime::Singleton);
+    router.controller_lifetime<CountingController>(breeze::http::ControllerLifetime::Pooled);
+    router.controller_lifetime<StickyController>(breeze::http::ControllerLifetime::PooledKeepState);
+    router.group({.prefix = "/lifetimes"}, [](auto& group) {
+        group.get("/shared", &SharedController::index);
+        group.get("/pooled", &CountingController::index);
+        group.get("/sticky", &StickyController::index);
+    });
+
+    breeze::http::Request shared_req;
+    shared_req.set_path("/lifetimes/shared");
+    breeze::http::Request pooled_req;
+    pooled_req.set_path("/lifetimes/pooled");
+    for (int i = 0; i < 3; ++i) {
+        assert(router.dispatch(shared_req).body() == "shared");
+        assert(router.dispatch(pooled_req).body() == "counted");
+    }
+    assert(SharedController::constructed == 1);
+    assert(CountingController::constructed == 1);
+    assert(CountingController::resets == 3);
+
+    // PooledKeepState recycles like Pooled without the reset: one instance serves request after
+    // request, whichever connection thread they arrive on
+    breeze::http::Request sticky_req;
+    sticky_req.set_path("/lifetimes/sticky");
+    for (int i = 1; i <= 3; ++i) {
+        std::thread([&] { assert(router.dispatch(sticky_req).body() == std::to_string(i)); }).join();
+    }
+    assert(StickyController::constructed == 1);
+    assert(StickyController::resets == 0);
+
+    // Frozen container: lazy singletons are created once, bindings stay transient
+    breeze::core::Container container;
+    int singleton_builds = 0;
+    container.singleton<SharedController>([&singleton_builds] {
+        ++singleton_builds;
+        return std::make_shared<SharedController>();
+    });
+    container.bind<CountingController>([] { return std::make_shared<CountingController>(); });
+    assert(singleton_builds == 0);
+    container.freeze();
+    assert(container.make<SharedController>() == container.make<SharedController>());
+    assert(singleton_builds == 1);
+    assert(container.make<CountingController>() != container.make<CountingController>());
+
+    // Lazy singletons resolved concurrently before freeze() still run their factory once
+    breeze::core::Container racing;
+    std::atomic<int> racing_builds{0};
+    racing.singleton<SharedController>([&racing_builds] {
+        ++racing_builds;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return std::make_shared<SharedController>();
+    });
+    std::vector<std::thread> resolvers;
+    std::vector<std::shared_ptr<SharedController>> resolved(4);
+    for (std::size_t i = 0; i < resolved.size(); ++i) {
+        resolvers.emplace_back([&racing, &resolved, i] { resolved[i] = racing.make<SharedController>(); });
+    }
+    for (auto& t : resolvers) t.join();
+    racing.freeze();
+    assert(racing_builds == 1 && racing.make<SharedController>() == resolved[0]);
+    assert(std::all_of(resolved.begin(), resolved.end(), [&](const auto& p) { return p == resolved[0]; }));
+
+    threw = false;
+    try {
+        container.bind<SharedController>([] { return std::make_shared<SharedController>(); });
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Scoped services: one instance per request, released when the request ends
+    app.container().scoped<UnitOfWork>();
+    router.get("/scoped", [&app](const breeze::http::Request&) {
+        auto a = app.container().make<UnitOfWork>();
+        auto b = app.container().make<UnitOfWork>();
+        return breeze::http::Response::ok(a == b ? "same" : "different");
+    });
+    breeze::http::Request scoped_req;
+    scoped_req.set_path("/scoped");
+    assert(app.handle(scoped_req).body() == "same");
+    assert(app.handle(scoped_req).body() == "same");
+    assert(UnitOfWork::destroyed == 2);
+
+    threw = false;
+    try {
+        (void)app.container().make<UnitOfWork>();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Deferred providers register on first resolution, also after the container is frozen
+    app.register_provider<ReportServiceProvider>();
+    assert(ReportServiceProvider::registrations == 0);
+    app.container().freeze();
+    auto report = app.container().make<ReportService>();
+    assert(ReportServiceProvider::registrations == 1);
+    assert(app.container().make<ReportService>() == report);
+    assert(ReportServiceProvider::registrations == 1);
+    assert(ReportServiceProvider::booted_formatter &&
+           app.container().make<ReportFormatter>() == ReportServiceProvider::booted_formatter);
+
+    // Two threads loading the same deferred provider through different types do not deadlock
+    breeze::core::Application pair_app;
+    pair_app.register_provider<PairServiceProvider>();
+    pair_app.container().freeze();
+    std::shared_ptr<PairLeft> left;
+    std::shared_ptr<PairRight> right;
+    std::thread left_thread([&] { left = pair_app.container().make<PairLeft>(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::thread right_thread([&] { right = pair_app.container().make<PairRight>(); });
+    left_thread.join();
+    right_thread.join();
+    assert(left && right && PairServiceProvider::registrations == 1);
+    assert(pair_app.container().make<PairRight>() == right);
+
+    // After freeze() a deferred provider may only register the types it declared
+    breeze::core::Application leaky_app;
+    leaky_app.register_provider<LeakyServiceProvider>();
+    leaky_app.container().freeze();
+    threw = false;
+    try {
+        (void)leaky_app.container().make<LeakyService>();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    breeze::core::Application boot_app;
+    boot_app.register_provider<IndependentProvider>();
+    boot_app.register_provider<OrderedProvider>();
+    boot_app.boot();
+    assert(BootOrder::ordered == std::this_thread::get_id());
+    assert(BootOrder::independent != std::thread::id() && BootOrder::independent != std::this_thread::get_id());
+
+    // Static middleware stage runs before dynamically added middleware
+    breeze::http::MiddlewarePipeline pipeline;
+    std::string trace;
+    pipeline.add([&trace](const breeze::http::Request& req, breeze::http::MiddlewarePipeline::Next next) {
+        trace += "dynamic,";
+        return next(req);
+    });
+    pipeline.compose(
+        [&trace](const breeze::http::Request& req, auto&& next) {
+            trace += "first,";
+            return next(req);
+        },
+        [&trace](const breeze::http::Request& req, auto&& next) {
+            trace += "second,";
+            auto res = next(req);
+            res.set_header("X-Static", "1");
+            return res;
+        });
+    auto piped = pipeline.run(req, [&trace](const breeze::http::Request&) {
+        trace += "handler";
+        return breeze::http::Response::ok("done");
+    });
+    assert(trace == "first,second,dynamic,handler");
+    assert(piped.header("X-Static") == "1");
+    // A second compose() appends after the stage composed first
+    pipeline.compose([&trace](const breeze::http::Request& req, auto&& next) {
+        trace += "third,";
+        return next(req);
+    });
+    trace.clear();
+    piped = pipeline.run(req, [&trace](const breeze::http::Request&) {
+        trace += "handler";
+        return breeze::http::Response::ok("done");
+    });
+    assert(trace == "first,second,third,dynamic,handler");
+    assert(piped.header("X-Static") == "1");
+
+    // Config files: strings are stored without their JSON quotes, other scalars as JSON text
+    auto config_dir = std::filesystem::temp_directory_path() / "breeze_config_test";
+    std::filesystem::create_directories(config_dir);
+    std::ofstream(config_dir / "logging.json") << R"({"access": {"format": "json", "max_files": 3, "console": false}})";
+    breeze::core::Config file_config(config_dir);
+    assert(file_config.get("logging.access.format") == "json");
+    assert(file_config.get<std::string>("logging.access.format", "text") == "json");
+    assert(file_config.get<int>("logging.access.max_files", 0) == 3);
+    assert(!file_config.get<bool>("logging.access.console", true));
+    std::filesystem::remove_all(config_dir);
+
+    // Access log: records are written by the background writer as JSON lines
+    auto log_dir = std::filesystem::temp_directory_path() / "breeze_access_log_test";
+    std::filesystem::remove_all(log_dir);
+    breeze::support::AccessLogOptions log_options;
+    log_options.directory = log_dir;
+    log_options.json = true;
+    log_options.min_level = breeze::support::LogLevel::Warning;
+    auto& access_log = breeze::support::AccessLog::instance();
+    access_log.configure(log_options);
+    assert(!access_log.running());
+    auto written_before = access_log.written();
+    access_log.log_request("GET", "/ok", "127.0.0.1", 200, std::chrono::microseconds(5));
+    assert(!access_log.running());  // filtered out by level before reaching a ring
+    access_log.log_request("GET", "/missing\"", "127.0.0.1", 404, std::chrono::microseconds(7));
+    assert(access_log.running());
+    access_log.flush();
+    assert(access_log.written() == written_before + 1);
+    std::ifstream log_file(log_dir / "access.log");
+    std::stringstream log_contents;
+    log_contents << log_file.rdbuf();
+    assert(log_contents.str().find("\"path\":\"/missing\\\"\",\"status\":404") != std::string::npos);
+    assert(log_contents.str().find("/ok") == std::string::npos);
+    access_log.stop();
+    std::filesystem::remove_all(log_dir);
+
+    // Metrics: kernel records latency labelled by route template, exported as Prometheus text
+    auto& metrics = breeze::support::Metrics::instance();
+    metrics.reset();
+    assert(breeze::support::LatencyBuckets::index_for(3) == 3);
+    assert(breeze::support::LatencyBuckets::upper_bound(breeze::support::LatencyBuckets::index_for(1000)) > 1000);
+    assert(breeze::support::LatencyBuckets::upper_bound(breeze::support::LatencyBuckets::index_for(1000)) <= 1064);
+    assert(breeze::support::LatencyBuckets::index_for(UINT32_MAX) == breeze::support::LatencyBuckets::count - 1);
+    router.get("/items/{id}", [](const breeze::http::Request&) { return breeze::http::Response::ok(); });
+    for (int i = 0; i < 3; ++i) {
+        breeze::http::Request metric_req;
+        metric_req.set_method("GET");
+        metric_req.set_path("/items/" + std::to_string(i));
+        app.kernel().handle(metric_req);
+    }
+    auto user_series = metrics.snapshot("GET", "/items/{id}", 200);
+    assert(user_series.count == 3);
+    assert(user_series.quantile_us(0.99) >= user_series.quantile_us(0.5));
+    auto exposition = metrics.prometheus();
+    assert(exposition.find("breeze_http_request_duration_seconds_count{method=\"GET\",route=\"/items/{id}\",status=\"200\"} 3") != std::string::npos);
+    assert(exposition.find("le=\"+Inf\"") != std::string::npos);
+    assert(exposition.find("breeze_http_active_connections") != std::string::npos);
+    // Unknown verbs share one label (a full series table is checked at the end)
+    metrics.observe_request("BREW", "/pot", 418, std::chrono::microseconds(5));
+    metrics.observe_request("xyzzy", "/pot", 418, std::chrono::microseconds(5));
+    assert(metrics.snapshot("OTHER", "/pot", 418).count == 2 && metrics.snapshot("BREW", "/pot", 418).count == 0);
+
+    // Tracing: spans feed Server-Timing, traceparent is honoured, slow traces are exported
+    auto trace_file = std::filesystem::temp_directory_path() / "breeze_traces_test.log";
+    std::filesystem::remove(trace_file);
+    breeze::support::TraceOptions trace_options;
+    trace_options.server_timing = true;
+    trace_options.slow_threshold = std::chrono::microseconds(0);
+    trace_options.export_path = trace_file;
+    breeze::support::Tracer::instance().configure(trace_options);
+    breeze::http::Request traced_req;
+    traced_req.set_method("GET");
+    traced_req.set_path("/items/9");
+    traced_req.set_header("traceparent", "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+    auto traced = app.kernel().handle(traced_req);
+    auto timing = traced.header("Server-Timing");
+    assert(timing.find("dispatch;dur=") != std::string::npos);
+    assert(timing.find("middleware;dur=") != std::string::npos);
+    assert(timing.find("traceparent;desc=\"00-4bf92f3577b34da6a3ce929d0e0e4736-") != std::string::npos);
+    std::ifstream trace_log(trace_file);
+    std::stringstream trace_contents;
+    trace_contents << trace_log.rdbuf();
+    assert(trace_contents.str().find("\"parent_id\":\"00f067aa0ba902b7\"") != std::string::npos);
+    breeze::support::Trace bad_parent;
+    assert(!bad_parent.adopt_parent("00-00000000000000000000000000000000-00f067aa0ba902b7-01"));
+    // Recording a request never allocates: ids, request line and spans are inline
+    breeze::support::Tracer::instance().configure({});
+    std::string long_path(300, 'p');
+    {
+        breeze::support::AllocationScope tracing_allocations;
+        {
+            breeze::support::TraceScope scope;
+            breeze::support::Span span("dispatch", long_path);
+            breeze::support::Trace::current()->adopt_parent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+            breeze::support::Trace::current()->describe("GET", long_path, 200);
+            assert(breeze::support::Trace::current()->trace_id() == "4bf92f3577b34da6a3ce929d0e0e4736");
+        }
+        assert(tracing_allocations.counts().allocations == 0);
+    }
+    {
+        // Container resolution shows up as a span inside a traced request
+        breeze::support::TraceScope scope;
+        (void)container.make<SharedController>();
+        auto* trace = breeze::support::Trace::current();
+        assert(trace->span_count() == 1 && std::string_view(trace->span(0).name) == "container");
+    }
+    breeze::support::Tracer::instance().configure({});
+    std::filesystem::remove(trace_file);
+
+    // Command arguments: a bare flag is only accepted for boolean options
+    breeze::commands::BenchCommand bench_command;
+    assert(bench_command.parse_arguments({"--keep-alive", "--requests", "50"}) ==
+           (std::unordered_map<std::string, std::string>{{"keep-alive", "true"}, {"requests", "50"}}));
+    threw = false;
+    try {
+        (void)bench_command.parse_arguments({"--requests", "--keep-alive"});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Load generator: in-process run honours the request count and weighted mix
+    auto mix_file = std::filesystem::temp_directory_path() / "breeze_bench_mix.txt";
+    std::ofstream(mix_file) << "# weighted mix\nGET /ping 3\nGET /missing 1\n";
+    breeze::commands::BenchCommand::Settings bench_settings;
+    bench_settings.in_process = true;
+    bench_settings.concurrency = 2;
+    bench_settings.total_requests = 40;
+    bench_settings.mix = breeze::commands::BenchCommand::load_mix(mix_file.string());
+    assert(bench_settings.mix.size() == 2 && bench_settings.mix[0].weight == 3);
+    auto bench_report = breeze::commands::BenchCommand::run(bench_settings, &app);
+    assert(bench_report.completed == 40);
+    assert(bench_report.errors == 0);
+    assert(bench_report.non_2xx > 0 && bench_report.non_2xx < 40);
+    assert(bench_report.percentile_ms(99.9) >= bench_report.percentile_ms(50));
+    std::filesystem::remove(mix_file);
+
+    // Socket mode reads chunked responses to their last chunk on a kept-alive connection
+    int chunk_listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in chunk_addr{};
+    chunk_addr.sin_family = AF_INET;
+    chunk_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t chunk_addr_len = sizeof(chunk_addr);
+    assert(::bind(chunk_listener, reinterpret_cast<sockaddr*>(&chunk_addr), sizeof(chunk_addr)) == 0);
+    assert(::listen(chunk_listener, 1) == 0);
+    ::getsockname(chunk_listener, reinterpret_cast<sockaddr*>(&chunk_addr), &chunk_addr_len);
+    std::thread chunk_server([chunk_listener] {
+        int fd = ::accept(chunk_listener, nullptr, nullptr);
+        char request[1024];
+        while (::recv(fd, request, sizeof(request), 0) > 0) {
+            std::string head = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5;ext=1\r\nhel";
+            std::string tail = "lo\r\n6\r\n world\r\n0\r\n\r\n";
+            ::send(fd, head.data(), head.size(), MSG_NOSIGNAL);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            ::send(fd, tail.data(), tail.size(), MSG_NOSIGNAL);
+        }
+        ::close(fd);
+    });
+    breeze::commands::BenchCommand::Settings chunk_settings;
+    chunk_settings.port = std::to_string(ntohs(chunk_addr.sin_port));
+    chunk_settings.concurrency = 1;
+    chunk_settings.total_requests = 3;
+    chunk_settings.keep_alive = true;
+    chunk_settings.timeout = std::chrono::milliseconds(1000);
+    chunk_settings.mix = {breeze::commands::BenchCommand::Target{}};
+    auto chunk_report = breeze::commands::BenchCommand::run(chunk_settings, nullptr);
+    chunk_server.join();
+    ::close(chunk_listener);
+    assert(chunk_report.completed == 3);
+    assert(chunk_report.errors == 0);
+    assert(chunk_report.connections == 1);
+    assert(chunk_report.reused == 2);
+
+    // Traffic capture: sampled requests round-trip through the binary log and replay schedule
+    auto capture_file = std::filesystem::temp_directory_path() / "breeze_capture_test.bin";
+    breeze::support::TrafficCaptureOptions capture_options;
+    capture_options.enabled = true;
+    capture_options.file = capture_file;
+    breeze::support::TrafficCapture::instance().configure(capture_options);
+    breeze::http::MiddlewarePipeline capture_pipeline;
+    capture_pipeline.add(app::Http::Middleware::CaptureTraffic());
+    breeze::http::Request captured_req;
+    captured_req.set_method("POST");
+    captured_req.set_path("/items");
+    captured_req.set_query_string("page=2");
+    captured_req.set_header("Authorization", "Bearer secret");
+    captured_req.set_header("X-Trace", "abc");
+    captured_req.set_body("{\"name\":\"Ada\"}");
+    for (int i = 0; i < 2; ++i) {
+        capture_pipeline.run(captured_req, [](const breeze::http::Request&) { return breeze::http::Response::ok("saved"); });
+    }
+    breeze::support::TrafficCapture::instance().close();
+    auto captured = breeze::support::TrafficReader::read_all(capture_file);
+    assert(captured.size() == 2);
+    assert(captured[0].method == "POST" && captured[0].path == "/items" && captured[0].query == "page=2");
+    assert(captured[0].status == 200 && captured[0].body == "{\"name\":\"Ada\"}");
+    auto replayed = breeze::http::Server::parse_request(captured[0].to_http());
+    assert(replayed.header("authorization") == "[redacted]");
+    assert(replayed.header("x-trace") == "abc");
+    assert(replayed.body() == captured[0].body);
+    captured[1].offset_us = captured[0].offset_us + 1000;
+    auto replay_schedule = breeze::commands::ReplayCommand::schedule(captured, "localhost", 2.0);
+    assert(replay_schedule[0].at.count() == 0 && replay_schedule[1].at.count() == 500);
+    // Malformed numeric options are a usage error, not an uncaught exception
+    breeze::commands::ReplayCommand replay_command;
+    assert(replay_command.handle({{"file", capture_file.string()}, {"speed", "abc"}}) == 1);
+    assert(replay_command.handle({{"file", capture_file.string()}, {"limit", "-1"}}) == 1);
+    assert(replay_command.handle({{"file", capture_file.string()}, {"threshold", "5x"}}) == 1);
+    std::filesystem::remove(capture_file);
+    // Test client: raw bytes through parse, dispatch and serialize, with per-route budgets
+    breeze::testing::TestClient client(app);
+    router.post("/echo", [](const breeze::http::Request& r) { return breeze::http::Response::ok(r.body()); });
+    auto pong = client.get("/ping");
+    assert(pong.status == 200 && pong.body == "pong");
+    assert(pong.header("Content-Length") == "4");
+    assert(client.get("/nowhere").status == 404);
+    assert(client.post("/echo", "{\"a\":1}").json()["a"] == 1);
+    assert(breeze::support::allocations::available());
+    auto ping_cost = client.expect_within(breeze::testing::TestClient::request("GET", "/ping"),
+                                          {.max_allocations = 200, .max_p99 = std::chrono::milliseconds(50)});
+    assert(ping_cost.label == "GET /ping" && ping_cost.max_allocations > 0);
+    assert(ping_cost.p99 >= ping_cost.p50);
+    bool over_budget = false;
+    try {
+        client.expect_within(breeze::testing::TestClient::request("GET", "/ping"), {.max_allocations = 0, .max_p99 = std::nullopt, .iterations = 5});
+    } catch (const breeze::testing::BudgetExceeded& e) {
+        over_budget = std::string(e.what()).find("GET /ping") != std::string::npos;
+    }
+    assert(over_budget);
+
+    // Allocation accounting: attributed to the route in metrics and, on request, a debug header
+    metrics.reset();
+    metrics.set_allocation_header(true);
+    auto counted = client.get("/items/4");
+    auto allocation_header = counted.header("X-Breeze-Allocations");
+    assert(!allocation_header.empty() && allocation_header.find("; bytes=") != std::string::npos);
+    auto item_series = metrics.snapshot("GET", "/items/{id}", 200);
+    assert(item_series.allocations > 0 && item_series.allocated_bytes > 0);
+    assert(std::stoull(allocation_header) == item_series.allocations);
+    assert(metrics.prometheus().find("breeze_http_request_allocations_total{method=\"GET\",route=\"/items/{id}\"") != std::string::npos);
+    metrics.set_allocation_header(false);
+    assert(client.get("/items/4").header("X-Breeze-Allocations").empty());
+
+    // Sampling profiler: CPU samples become collapsed stacks prefixed with the route being served
+    router.get("/spin", [](const breeze::http::Request&) {
+        volatile std::uint64_t x = 0;
+        auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+        while (std::chrono::steady_clock::now() < until) x = x + 1;
+        return breeze::http::Response::ok();
+    });
+    auto& profiler = breeze::support::SamplingProfiler::instance();
+    bool started = profiler.start(250);
+    assert(started);
+    bool restarted = profiler.start(250);
+    assert(!restarted);
+    client.get("/spin");
+    auto profile = profiler.stop();
+    assert(!profiler.running() && profile.samples > 0);
+    assert(profile.collapsed.find("/spin;") != std::string::npos);
+    assert(profile.collapsed.back() == '\n');
+
+    // Admin guard: loopback only without a token, bearer token otherwise
+    router.get("/ops/local", [](const breeze::http::Request&) { return breeze::http::Response::ok(); })
+        .middleware(app::Http::Middleware::AdminOnly(""));
+    router.get("/ops/token", [](const breeze::http::Request&) { return breeze::http::Response::ok(); })
+        .middleware(app::Http::Middleware::AdminOnly("s3cret"));
+    assert(client.get("/ops/local").status == 200);
+    assert(client.get("/ops/token").status == 403);
+    assert(client.get("/ops/token", {{"Authorization", "Bearer s3cret"}}).status == 200);
+    client.set_remote_addr("10.0.0.8");
+    assert(client.get("/ops/local").status == 403);
+    client.set_remote_addr("127.0.0.1");
+
+    // Admin routes take their paths and token from config
+    breeze::core::Application admin_app;
+    admin_app.config().set("metrics.path", "/ops/metrics");
+    admin_app.config().set("profiler.path", "/ops/profile");
+    admin_app.config().set("profiler.token", "s3cret");
+    register_admin_routes(admin_app);
+    breeze::testing::TestClient admin_client(admin_app);
+    assert(admin_client.get("/ops/metrics").status == 200);
+    assert(admin_client.get("/admin/metrics").status == 404);
+    admin_client.set_remote_addr("10.0.0.8");
+    assert(admin_client.get("/ops/metrics").status == 403);
+    admin_client.set_remote_addr("127.0.0.1");
+    assert(admin_client.get("/ops/profile?seconds=1&hz=1").status == 403);
+    assert(admin_client.get("/ops/profile?seconds=1&hz=1", {{"Authorization", "Bearer s3cret"}}).status == 200);
+
+    // The bound View looks up top-level views under view.path, the root @include resolves against
+    auto view_root = std::filesystem::temp_directory_path() / "breeze_view_path_test";
+    std::filesystem::create_directories(view_root);
+    std::ofstream(view_root / "hello.breeze") << "hi {{ who }}";
+    breeze::core::Application view_app;
+    view_app.config().set("view.path", view_root.string());
+    view_app.register_provider<app::Providers::ViewServiceProvider>();
+    assert(view_app.container().make<breeze::support::View>()->render("hello", {{"who", "ada"}}) == "hi ada");
+    std::filesystem::remove_all(view_root);
+
+    // Blade: templates compile once to bytecode; output matches the tree-walking renderer
+    breeze::support::Blade blade;
+    nlohmann::json view_ctx = {{"name", "Ada <b>"}, {"n", 3}, {"zero", 0}, {"list", {1, 2, 3}},
+                               {"users", {{{"name", "a"}, {"age", 30}}, {{"name", "b"}, {"age", 12}}}}};
+    assert(blade.render("Hi {{ name | upper | escape }}", view_ctx) == "Hi ADA &lt;B&gt;");
+    assert(blade.render("{{ n + 1 }} {{ 'x' + n }} {{ missing | default('none') }}", view_ctx) == "4.0 x3 none");
+    assert(blade.render("@if(n > 2)big@endif@unless(zero)!@endunless", view_ctx) == "big!");
+    assert(blade.render("@foreach(users as u)[{{ u.name }}@if(u.age > 18)+@endif]@endforeach end", view_ctx) == "[a+][b] end");
+    assert(blade.render("@foreach(list as x){{ x }}@foreach(list as y).@endforeach@endforeach", view_ctx) == "1...2...3...");
+    std::string division_error = "[Template Error: expr=\"n / zero\" pos=8 msg=Division by zero]";
+    assert(blade.render("@foreach(list as x){{ n / zero }}@endforeach", view_ctx) ==
+           division_error + division_error + division_error);
+    assert(blade.render("{{ users.1.name }}", view_ctx) == "b");
+    assert(blade.render("{{ (n }}", view_ctx) == "[Template Error: expr=\"(n\" pos=2 msg=Missing closing parenthesis]");
+    // Loop variables shadow the root context without copying it; $loop describes the current iteration
+    assert(blade.render("{{ name }}@foreach(users as name){{ name.name }}@endforeach{{ name }}", view_ctx) == "Ada <b>abAda <b>");
+    assert(blade.render("@foreach($users as $u){{ $loop.iteration }}/{{ $loop.count }}@if($loop.last).@endif"
+                        "@foreach(list as x)@if($loop.first){{ $loop.parent.index }}{{ $loop.depth }}@endif@endforeach,@endforeach",
+                        view_ctx) == "1/202,2/2.12,");
+    assert(blade.render("{{ $loop.index }}", view_ctx).empty());
+    // Rendering appends to one caller buffer, or hands out chunks as they fill
+    std::string view_buffer = "<";
+    blade.render_to(view_buffer, "{{ name }}", view_ctx);
+    assert(view_buffer == "<Ada <b>");
+    auto view_file = std::filesystem::temp_directory_path() / "breeze_stream_test.breeze";
+    std::ofstream(view_file) << "@foreach(list as x)<p>{{ x }}</p>@endforeach";
+    std::vector<std::string> chunks;
+    blade.stream_from_file(view_file, view_ctx, [&chunks](std::string_view c) { chunks.emplace_back(c); }, 8);
+    assert(chunks.size() == 3 && chunks[0] == "<p>1</p>" && chunks[2] == "<p>3</p>");
+    std::filesystem::remove(view_file);
+
+    // File views: cached by path, re-validated with stat() instead of re-reading and hashing
+    auto edited_view = std::filesystem::temp_directory_path() / "breeze_edit_test.breeze";
+    std::ofstream(edited_view) << "v1 {{ n }}";
+    breeze::support::Blade::configure({.check_interval = std::chrono::milliseconds(0)});
+    assert(blade.render_from_file(edited_view, view_ctx) == "v1 3");
+    auto reloads = breeze::support::Blade::cache_stats()["reloads"].get<std::size_t>();
+    std::ofstream(edited_view) << "v2 {{ n }}!";
+    assert(blade.render_from_file(edited_view, view_ctx) == "v2 3!");
+    assert(breeze::support::Blade::cache_stats()["reloads"].get<std::size_t>() == reloads + 1);
+    breeze::support::Blade::configure({.immutable = true});
+    std::ofstream(edited_view) << "v3 {{ n }}!!";
+    assert(blade.render_from_file(edited_view, view_ctx) == "v2 3!");
+    breeze::support::Blade::configure({});
+    std::filesystem::remove(edited_view);
+
+    // Streamed responses: chunked on the wire, buffered with Content-Length through to_string()
+    breeze::http::Server stream_server([](const breeze::http::Request&) {
+        return breeze::http::Response::stream([](breeze::http::Response::Stream& out) {
+            out.write("hello ");
+            out.write("");
+            out.write("world");
+        }, "text/plain");
+    });
+    std::string wire;
+    stream_server.process(breeze::testing::TestClient::request("GET", "/"), "127.0.0.1", [&wire](std::string_view b) { wire.append(b); });
+    assert(wire.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+    assert(wire.ends_with("\r\n\r\n6\r\nhello \r\n5\r\nworld\r\n0\r\n\r\n"));
+    auto buffered = breeze::testing::TestClient::parse_response(
+        stream_server.process(breeze::testing::TestClient::request("GET", "/"), "127.0.0.1"));
+    assert(buffered.body == "hello world" && buffered.header("Content-Length") == "11");
+    // The server answers one request per connection and tells keep-alive clients so
+    assert(buffered.header("Connection") == "close" && wire.find("Connection: close\r\n") != std::string::npos);
+
+    // A streamed body may use scoped services: the server keeps the request scope open until
+    // the body is written, and the request is measured once it is complete
+    router.get("/scoped-stream", [&app](const breeze::http::Request&) {
+        auto unit = app.container().make<UnitOfWork>();
+        return breeze::http::Response::stream([unit](breeze::http::Response::Stream& out) {
+            out.write(unit ? "unit" : "none");
+        }, "text/plain");
+    });
+    breeze::http::Server app_server([&app](const breeze::http::Request& r) { return app.handle(r); });
+    auto destroyed_before = UnitOfWork::destroyed;
+    auto scoped_stream = breeze::testing::TestClient::parse_response(
+        app_server.process(breeze::testing::TestClient::request("GET", "/scoped-stream"), "127.0.0.1"));
+    assert(scoped_stream.body == "unit" && UnitOfWork::destroyed == destroyed_before + 1);
+    assert(metrics.snapshot("GET", "/scoped-stream", 200).count == 1);
+
+    auto folded = breeze::support::blade::compile("a{{ 1 + 2 }}b@if(true)c@endif@if(false)d@endif");
+    assert(folded.code.size() == 1 && folded.code[0].op == breeze::support::blade::Op::Text);
+    assert(blade.render("a{{ 1 + 2 }}b@if(true)c@endif@if(false)d@endif", view_ctx) == "a3.0bc");
+
+    // Precompiled views: a binary image executes in place; damaged or foreign images are rejected
+    namespace bl = breeze::support::blade;
+    auto listing = bl::compile("@foreach(users as u)@if(u.age > 18){{ u.name | upper }}@endif,@endforeach{{ n | default('x') }}");
+    auto image = bl::serialize(listing);
+    auto loaded = bl::load(image);
+    assert(loaded && loaded->code.size() == listing.code.size());
+    std::string from_image, from_program;
+    bl::execute(*loaded, view_ctx, from_image);
+    bl::execute(listing, view_ctx, from_program);
+    assert(from_image == from_program && from_image == "A,,3");
+    for (std::size_t size = 0; size < image.size(); ++size) assert(!bl::load(std::string(image, 0, size)));
+    // Struct padding is written as zero, so the same program always gives the same image
+    auto scribbled = listing;
+    for (auto& in : scribbled.code) {
+        auto copy = in;
+        std::memset(static_cast<void*>(&in), 0xab, sizeof(in));
+        in.op = copy.op;
+        in.a = copy.a;
+        in.b = copy.b;
+        in.c = copy.c;
+    }
+    assert(bl::serialize(scribbled) == image);
+    auto bad_version = image;
+    bad_version[4] ^= 0x7f;
+    assert(!bl::load(bad_version));
+    auto bad_jump = listing;
+    bad_jump.code[1].b = 0;
+    assert(!bl::load(bl::serialize(bad_jump)));
+
+    auto cached_view = std::filesystem::temp_directory_path() / "breeze_precompile_test.breeze";
+    std::ofstream(cached_view) << "pre {{ n }}";
+    breeze::support::Blade::clear_cache();
+    assert(breeze::support::Blade::precompile(cached_view));
+    assert(!breeze::support::Blade::precompile(cached_view.string() + ".missing"));
+    std::size_t images = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("storage/framework/views")) images += entry.path().extension() == ".bzv";
+    assert(images == 1);
+    // the same source under another views root gets its own image
+    breeze::support::Blade::configure({.views_path = std::filesystem::temp_directory_path()});
+    assert(breeze::support::Blade::precompile(cached_view));
+    breeze::support::Blade::configure({});
+    images = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("storage/framework/views")) images += entry.path().extension() == ".bzv";
+    assert(images == 2);
+    assert(blade.render_from_file(cached_view, view_ctx) == "pre 3");
+    std::filesystem::remove(cached_view);
+
+    // Views built with breeze_add_views() run generated C++ and match the interpreter exactly
+    std::filesystem::path test_views = BREEZE_TEST_VIEWS;
+    assert(bl::find_compiled("aot_listing"));
+    assert(!bl::find_compiled("no_such_view"));
+    breeze::support::View aot(test_views);
+    auto interpreted = blade.render_from_file(test_views / "aot_listing.breeze", view_ctx);
+    assert(interpreted.find("1. A</li>") != std::string::npos && interpreted.find("Division by zero") != std::string::npos);
+    assert(aot.render("aot_listing", view_ctx) == interpreted);
+    std::string aot_streamed;
+    aot.stream("aot_listing", view_ctx, [&aot_streamed](std::string_view c) { aot_streamed += c; }, 16);
+    assert(aot_streamed == interpreted);
+    breeze::support::Blade::configure({.compiled = false});
+    assert(!bl::find_compiled("aot_listing") && aot.render("aot_listing", view_ctx) == interpreted);
+    breeze::support::Blade::configure({});
+    assert(bl::find_compiled("aot_page"));
+    breeze::support::Blade::configure({.compiled = false, .views_path = test_views});
+    auto interpreted_page = aot.render("aot_page", view_ctx);
+    breeze::support::Blade::configure({});
+    assert(interpreted_page == "<main><i>1</i><i>2</i><i>3</i></main>3\n" && aot.render("aot_page", view_ctx) == interpreted_page);
+    // Text, plain-path echoes and @if tests become direct appends and JSON lookups; filters and
+    // operators still go through Frame
+    auto generated = bl::generate_cpp(bl::compile("a\n@if(x)\"{{ y }}\"@endif@if(x > 1){{ y | upper }}@endif"), "demo");
+    assert(generated.find("if (Frame::truthy(Frame::member(f.root(), \"x\", -1))) {") != std::string::npos);
+    assert(generated.find("f.echo_value(Frame::member(f.root(), \"y\", -1), ") != std::string::npos);
+    assert(generated.find("out.append(\"\\\"\", 1);") != std::string::npos);
+    assert(generated.find("if (!f.skip_unless(") != std::string::npos && generated.find("f.echo(") != std::string::npos);
+    // Paths bound to loop variables, shadowing, numbers, missing keys and containers match the interpreter
+    assert(bl::find_compiled("aot_paths"));
+    auto paths_view = aot.render("aot_paths", view_ctx);
+    breeze::support::Blade::configure({.compiled = false});
+    assert(aot.render("aot_paths", view_ctx) == paths_view);
+    breeze::support::Blade::configure({});
+    assert(paths_view.starts_with("3 0  2 a {\"age\":30,\"name\":\"a\"} Ada <b>\n[a:30+n-123a][b:12+n-123b]\n1y2y3y3"));
+
+    // Layouts, partials and components link into one program; an edit reloads only its dependents
+    auto linked_views = std::filesystem::temp_directory_path() / "breeze_link_test";
+    std::filesystem::create_directories(linked_views / "layouts");
+    std::ofstream(linked_views / "layouts" / "app.breeze") << "<title>@yield('title', 'Home')</title>@include('nav')<main>@yield('body')</main>";
+    std::ofstream(linked_views / "nav.breeze") << "<nav>{{ name }}</nav>";
+    std::ofstream(linked_views / "alert.breeze") << "<div class=\"{{ $type }}\">{{ $slot }}</div>";
+    std::ofstream(linked_views / "page.breeze")
+        << "@extends('layouts.app')@section('title', n)@section('body')@foreach(list as x)"
+           "@component('alert')@slot('type')t{{ x }}@endslot{{ x * 2 }}@endcomponent@endforeach@endsection";
+    std::ofstream(linked_views / "plain.breeze") << "@include('nav')@include('missing')";
+    breeze::support::Blade::configure({.check_interval = std::chrono::milliseconds(0), .views_path = linked_views});
+    breeze::support::View linked(linked_views);
+    assert(linked.render("page", view_ctx) ==
+           "<title>3</title><nav>Ada <b></nav><main><div class=\"t1\">2.0</div><div class=\"t2\">4.0</div><div class=\"t3\">6.0</div></main>");
+    assert(linked.render("plain", view_ctx) == "<nav>Ada <b></nav>[Template Error: msg=View [missing] not found]");
+    std::vector<std::filesystem::path> page_dependencies;
+    bl::compile("@extends('layouts.app')", linked_views, &page_dependencies);
+    assert(page_dependencies.size() == 2);
+    reloads = breeze::support::Blade::cache_stats()["reloads"].get<std::size_t>();
+    std::ofstream(linked_views / "layouts" / "app.breeze") << "@yield('body')!";
+    assert(linked.render("plain", view_ctx) == "<nav>Ada <b></nav>[Template Error: msg=View [missing] not found]");
+    assert(linked.render("page", view_ctx).ends_with("</div>!"));
+    assert(breeze::support::Blade::cache_stats()["reloads"].get<std::size_t>() == reloads + 1);
+    // Immutable views resolve their file once: after that nothing on disk is consulted
+    breeze::support::Blade::configure({.immutable = true, .views_path = linked_views});
+    auto immutable_page = linked.render("page", view_ctx);
+    std::filesystem::rename(linked_views / "page.breeze", linked_views / "moved.breeze");
+    assert(linked.render("page", view_ctx) == immutable_page);
+    breeze::support::Blade::configure({});
+    std::filesystem::remove_all(linked_views);
+
+    // @cache fragments: stored by key for ttl seconds; an expired one is refreshed by one renderer
+    auto later_ctx = view_ctx;
+    later_ctx["n"] = 4;
+    const char* cached_tpl = "@cache('nav-' + zero, 60)<{{ n }}>@endcache|{{ n }}";
+    assert(blade.render(cached_tpl, view_ctx) == "<3>|3");
+    assert(blade.render(cached_tpl, later_ctx) == "<3>|4");
+    assert(blade.render("@cache(n, 0)<{{ n }}>@endcache@cache(n)({{ n }})@endcache", view_ctx) == "<3>(3)");
+    assert(blade.render("@cache(n, 0)[{{ n }}]@endcache@cache(n)[{{ zero }}]@endcache", view_ctx) == "[3](3)");
+    // An error inside a block (or a block nested in it) renders through and is not stored
+    const char* failing_tpl = "@cache('div', 60)[{{ 1 / zero }}]@endcache@cache('outer', 60)(@cache('inner', 60){{ 1 / zero }}@endcache)@endcache";
+    assert(blade.render(failing_tpl, view_ctx).find("Division by zero") != std::string::npos);
+    auto divisible_ctx = view_ctx;
+    divisible_ctx["zero"] = 2;
+    assert(blade.render(failing_tpl, divisible_ctx) == "[0.5](0.5)");
+    std::string fragment_chunks;
+    blade.stream_from_file(test_views / "aot_cached.breeze", view_ctx, [&fragment_chunks](std::string_view c) { fragment_chunks += c; }, 2);
+    assert(fragment_chunks == "[3.0][6.0][9.0]\n");
+    assert(aot.render("aot_cached", later_ctx) == fragment_chunks);
+    assert(bl::generate_cpp(bl::compile("@cache(k, 5)x@endcache"), "demo").find("if (!f.cache_begin(") != std::string::npos);
+    auto& fragments = breeze::support::FragmentCache::instance();
+    fragments.store("stampede", "old", std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    auto refresher = fragments.lookup("stampede");
+    auto waiter = fragments.lookup("stampede");
+    assert(!refresher.html && refresher.refresh && waiter.html && *waiter.html == "old" && !waiter.refresh);
+    fragments.store("stampede", "new", std::chrono::seconds(60));
+    assert(*fragments.lookup("stampede").html == "new");
+    assert(breeze::support::Blade::cache_stats()["fragments"]["stale_hits"].get<std::size_t>() >= 1);
+    breeze::support::Blade::clear_cache();
+    assert(fragments.lookup("stampede").refresh);
+
+    // HTML escaping scans 16/32 bytes at a time; check every special at every offset and tail length
+    namespace str = breeze::support::str;
+    for (std::size_t length = 0; length < 70; ++length) {
+        for (char special : std::string("&<>\"'")) {
+            std::string plain(length, 'x'), expected;
+            if (length > 0) plain[length / 3] = special;
+            for (char c : plain) {
+                if (c == '&') expected += "&amp;";
+                else if (c == '<') expected += "&lt;";
+                else if (c == '>') expected += "&gt;";
+                else if (c == '"') expected += "&quot;";
+                else if (c == '\'') expected += "&#39;";
+                else expected += c;
+            }
+            std::string escaped = "=";
+            str::append_html_escaped(escaped, plain);
+            assert(escaped == "=" + expected);
+            assert(str::find_html_special(plain) == (length > 0 ? length / 3 : std::string::npos));
+        }
+    }
+    std::string cased = "Hello, World! \xc3\xa4 az AZ @[`{ 0123456789 the quick brown fox";
+    str::ascii_upper(cased);
+    assert(cased == "HELLO, WORLD! \xc3\xa4 AZ AZ @[`{ 0123456789 THE QUICK BROWN FOX");
+    str::ascii_lower(cased);
+    assert(cased == "hello, world! \xc3\xa4 az az @[`{ 0123456789 the quick brown fox");
+    std::string padded = " \t trimmed \n";
+    str::trim_in_place(padded);
+    assert(padded == "trimmed");
+
+    // Autoescape: {{ }} is escaped once, {!! !!} is not, in the interpreter and in compiled views
+    const char* escape_tpl = "{{ name }}|{!! name !!}|{{ name | escape }}|{{ '<i>' }}|{{ n }}|{!! name | upper !!}";
+    assert(blade.render(escape_tpl, view_ctx) == "Ada <b>|Ada <b>|Ada &lt;b&gt;|<i>|3|ADA <B>");
+    breeze::support::Blade::configure({.autoescape = true});
+    assert(blade.render(escape_tpl, view_ctx) == "Ada &lt;b&gt;|Ada <b>|Ada &lt;b&gt;|&lt;i&gt;|3|ADA <B>");
+    auto escaped_view = aot.render("aot_escape", view_ctx);
+    assert(escaped_view ==
+           "Ada &lt;b&gt;|Ada <b>|ADA &lt;B&gt;|[{&quot;age&quot;:30,&quot;name&quot;:&quot;a&quot;},{&quot;age&quot;:12,&quot;name&quot;:&quot;b&quot;}]\n");
+    auto escaped_paths = aot.render("aot_paths", view_ctx);
+    assert(escaped_paths.find("{&quot;age&quot;:30,&quot;name&quot;:&quot;a&quot;} Ada <b>") != std::string::npos);
+    breeze::support::Blade::configure({.compiled = false, .autoescape = true});
+    assert(aot.render("aot_escape", view_ctx) == escaped_view);
+    assert(aot.render("aot_paths", view_ctx) == escaped_paths);
+    breeze::support::Blade::configure({});
+
+    // Single-pass lexer: nested blocks close innermost first, parentheses in conditions balance,
+    // stray end tags and unterminated echoes stay text, @foreach headers tolerate extra spaces
+    assert(blade.render("@foreach( users  as   u )@if(u.age > 18)@unless(zero){{ u.name }};@endunless@endif@endforeach",
+                        view_ctx) == "a;");
+    assert(blade.render("@if((n + 1) > 2)big@endif|@if(name == ')')x@endif", view_ctx) == "big|");
+    assert(blade.render("a@endif b @endforeach", view_ctx) == "a@endif b @endforeach");
+    assert(blade.render("{{ n }} then {{ name", view_ctx) == "3 then {{ name");
+    assert(blade.render("@foreach(list as x)@if(x > 1){{ x }}@endforeach.", view_ctx) == "23.");
+    // An unclosed opener is dropped and lexing carries on; directives behind it still match
+    assert(blade.render("@if( @if((n) > 2)big@endif", view_ctx) == " big");
+    std::string unclosed;
+    for (int i = 0; i < 20000; ++i) unclosed += "@if( ";
+    assert(blade.render(unclosed + "@if(n > 2)ok@endif", view_ctx) == std::string(20000, ' ') + "ok");
+
+    // Last, as it fills the process-wide series table: further series fold into the overflow series
+    for (int i = 0; i < 2100; ++i) {
+        metrics.observe_request("GET", "/flood/" + std::to_string(i), 200, std::chrono::microseconds(1));
+    }
+    assert(metrics.snapshot("*", "<overflow>", 0).count > 0);
+    assert(metrics.snapshot("GET", "/flood/2099", 200).count == 0);
     return 0;
 }